@@ -0,0 +1,294 @@
+#include "Handler.hpp"
+#include "SynchroTraceGen/ShadowMemory.hpp"
+#include "Utils/BackendOptions.hpp"
+#include "Utils/FileLogger.hpp"
+#include "spdlog/fmt/fmt.h"
+#include <limits>
+#include <mutex>
+#include <set>
+
+using namespace PrismLog; // console logging
+namespace FalseSharing
+{
+
+namespace
+{
+
+using WriterTID = int8_t;
+static_assert(MAX_THREADS - 1 <= std::numeric_limits<WriterTID>::max(), "thread IDs must fit");
+constexpr WriterTID SO_UNDEF = -1;
+
+constexpr unsigned WORD_BITS = 3;
+constexpr unsigned LINE_WORDS = LINE_BYTES >> WORD_BITS;
+
+struct ShadowLine
+{
+    std::array<WriterTID, LINE_WORDS> writers;
+    /* last thread to write each 8-byte word; sharing is told apart by word,
+     * so two threads writing different bytes of one word count as true sharing */
+
+    Threads valid;
+    Threads invalidated;
+    /* threads holding a copy of the line,
+     * and threads whose copy was invalidated by another thread's write */
+
+    ShadowLine() { writers.fill(SO_UNDEF); }
+};
+/* 40 bytes of shadow per 64-byte line that was touched */
+
+constexpr unsigned PAGE_LINES_BITS = 6;
+constexpr unsigned SHARD_BITS = 4;
+constexpr unsigned SHARDS = 1 << SHARD_BITS;
+
+struct Shard
+{
+    /* Shadow lines are split by 4 KiB page into shards, each with its own lock,
+     * so threads touching different pages do not wait for each other */
+
+    std::mutex mtx;
+    ShadowMemory<ShadowLine, 38 - LINE_BITS - SHARD_BITS, 16> lines;
+};
+
+auto shardOf(Addr line) -> unsigned
+{
+    return (line >> PAGE_LINES_BITS) & (SHARDS - 1);
+}
+
+auto indexInShard(Addr line) -> Addr
+{
+    /* drop the shard bits from the page number */
+    Addr page = line >> (PAGE_LINES_BITS + SHARD_BITS);
+    return (page << PAGE_LINES_BITS) | (line & ((1 << PAGE_LINES_BITS) - 1));
+}
+
+using Lines = TopK<Addr, SharedLine>;
+
+/* Global to all threads */
+std::string outputPath{"."};
+size_t maxLines{256};
+
+std::unique_ptr<std::array<Shard, SHARDS>> shadow;
+
+std::mutex gMtx;
+std::unique_ptr<Lines> falseShared;
+std::unique_ptr<Lines> trueShared;
+Count falseMisses{0};
+Count trueMisses{0};
+Count accesses{0};
+/* only updated on a sharing miss, or when a handler finishes */
+
+}; //end namespace
+
+
+//-----------------------------------------------------------------------------
+/** Synchronization Event Handling **/
+auto Handler::onSyncEv(const prism::SyncEvent &ev) -> void
+{
+    if (ev.type() != SyncTypeEnum::PRISM_SYNC_SWAP)
+        return;
+
+    if (ev.data() < 1 || ev.data() >= MAX_THREADS)
+        fatal("FalseSharing: thread ID out of range: " + std::to_string(ev.data()));
+    currentTID = ev.data();
+    currentInstr = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+/** Context Event Handling (instructions) **/
+auto Handler::onCxtEv(const prism::CxtEvent &ev) -> void
+{
+    if (ev.type() == CxtTypeEnum::PRISM_CXT_INSTR)
+        currentInstr = ev.id();
+}
+
+
+//-----------------------------------------------------------------------------
+/** Memory Event Handling **/
+auto Handler::onMemEv(const prism::MemEvent &ev) -> void
+{
+    if (currentTID == 0)
+        fatal("FalseSharing: memory event before any thread was seen");
+
+    /* split accesses that straddle lines */
+    Addr addr = ev.addr();
+    Addr end = addr + std::max<Addr>(ev.bytes(), 1);
+    while (addr < end)
+    {
+        Addr lineEnd = (addr | (LINE_BYTES - 1)) + 1;
+        Addr bytes = std::min(end, lineEnd) - addr;
+        onLineAccess(addr, bytes, ev.isStore());
+        addr += bytes;
+    }
+}
+
+
+auto Handler::onLineAccess(Addr addr, unsigned bytes, bool isStore) -> void
+{
+    Addr line = addr >> LINE_BITS;
+    unsigned first = (addr & (LINE_BYTES - 1)) >> WORD_BITS;
+    unsigned last = ((addr & (LINE_BYTES - 1)) + bytes - 1) >> WORD_BITS;
+
+    ++counts.accesses;
+
+    bool missed = false;
+    bool trueSharing = false;
+    {
+        auto &shard = (*shadow)[shardOf(line)];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+
+        auto &so = shard.lines[indexInShard(line)];
+        if (so.invalidated.test(currentTID) == true)
+        {
+            /* another thread's write took this thread's copy away */
+            missed = true;
+            for (unsigned i = first; i <= last; ++i)
+                if (so.writers[i] != SO_UNDEF && so.writers[i] != currentTID)
+                    trueSharing = true;
+        }
+
+        if (isStore == true)
+        {
+            so.invalidated |= so.valid;
+            so.valid.reset();
+            for (unsigned i = first; i <= last; ++i)
+                so.writers[i] = currentTID;
+        }
+        so.invalidated.reset(currentTID);
+        so.valid.set(currentTID);
+    }
+
+    if (missed == true)
+    {
+        ++(trueSharing == true ? counts.trueMisses : counts.falseMisses);
+
+        std::lock_guard<std::mutex> lock(gMtx);
+        auto &shared = (trueSharing == true ? trueShared : falseShared)->add(line);
+        if (isStore == true)
+            shared.writers.set(currentTID);
+        else
+            shared.readers.set(currentTID);
+        shared.instrs.add(currentInstr);
+    }
+}
+
+
+Handler::~Handler()
+{
+    std::lock_guard<std::mutex> lock(gMtx);
+    accesses += counts.accesses;
+    falseMisses += counts.falseMisses;
+    trueMisses += counts.trueMisses;
+}
+
+
+namespace
+{
+
+auto formatThreads(const Threads &threads) -> std::string
+{
+    std::string ret;
+    for (TID tid = 0; tid < MAX_THREADS; ++tid)
+    {
+        if (threads.test(tid) == false)
+            continue;
+        if (ret.empty() == false)
+            ret += ',';
+        ret += std::to_string(tid);
+    }
+    return ret.empty() ? "-" : ret;
+}
+
+
+auto flushLines(std::shared_ptr<spdlog::logger> &logger,
+                const std::string &title, Count misses, const Lines &lines) -> void
+{
+    logger->info("{} misses: {}", title, misses);
+    for (auto &line : lines.sorted())
+    {
+        /* the true count is within [count - error, count] */
+        logger->info("\tLine: {:#x}", line.key << LINE_BITS);
+        logger->info("\t\tMisses: {} (error: {})", line.count, line.error);
+        logger->info("\t\tWriters: {}", formatThreads(line.payload.writers));
+        logger->info("\t\tReaders: {}", formatThreads(line.payload.readers));
+
+        std::string instrs;
+        for (auto &instr : line.payload.instrs.sorted())
+            fmt::format_to(std::back_inserter(instrs), " {:#x}:{}", instr.key, instr.count);
+        logger->info("\t\tInstructions:{}", instrs);
+    }
+}
+
+}; //end namespace
+
+
+auto onExit() -> void
+{
+    std::lock_guard<std::mutex> lock(gMtx);
+
+    auto loggerPair = prism::getFileLogger(outputPath + "/sigil.sharing.out");
+    auto logger = std::move(loggerPair.first);
+    info("Flushing cache line sharing to: " + logger->name());
+
+    logger->info("Line size: {} bytes", LINE_BYTES);
+    logger->info("Memory accesses: {}", accesses);
+    flushLines(logger, "False sharing", falseMisses, *falseShared);
+    flushLines(logger, "True sharing", trueMisses, *trueShared);
+
+    logger->flush();
+    prism::blockingFlushAndDeleteLogger(logger);
+}
+
+
+//-----------------------------------------------------------------------------
+/** Option Parsing **/
+auto onParse(Args args) -> void
+{
+    /* only accept short options */
+    std::set<char> options;
+    options.insert('o'); // -o OUTPUT_DIRECTORY
+    options.insert('k'); // -k LINES_TRACKED
+    auto matches = prism::parseShortOptions(args, options, "falsesharing");
+
+    outputPath = prism::parseOutputPath(matches['o']);
+    maxLines = prism::parsePositive(matches['k'], 256, "FalseSharing lines");
+
+    shadow = std::make_unique<std::array<Shard, SHARDS>>();
+    falseShared = std::make_unique<Lines>(maxLines);
+    trueShared = std::make_unique<Lines>(maxLines);
+}
+
+
+auto requirements() -> prism::capabilities
+{
+    using namespace prism;
+    using namespace prism::capability;
+
+    auto caps = initCaps();
+
+    caps[MEMORY]         = availability::enabled;
+    caps[MEMORY_LDST]    = availability::enabled;
+    caps[MEMORY_SIZE]    = availability::enabled;
+    caps[MEMORY_ADDRESS] = availability::enabled;
+
+    caps[COMPUTE]              = availability::disabled;
+    caps[COMPUTE_INT_OR_FLOAT] = availability::disabled;
+    caps[COMPUTE_ARITY]        = availability::disabled;
+    caps[COMPUTE_OP]           = availability::disabled;
+    caps[COMPUTE_SIZE]         = availability::disabled;
+
+    caps[CONTROL_FLOW] = availability::disabled;
+
+    caps[SYNC]      = availability::enabled;
+    caps[SYNC_TYPE] = availability::enabled;
+    caps[SYNC_ARGS] = availability::enabled;
+
+    caps[CONTEXT_INSTRUCTION] = availability::enabled;
+    caps[CONTEXT_BASIC_BLOCK] = availability::disabled;
+    caps[CONTEXT_FUNCTION]    = availability::disabled;
+    caps[CONTEXT_THREAD]      = availability::enabled;
+
+    return caps;
+}
+
+}; //end namespace FalseSharing
@@ -0,0 +1,77 @@
+#ifndef FALSESHARING_H
+#define FALSESHARING_H
+
+#include "Core/Backends.hpp"
+#include "TopK.hpp"
+#include <array>
+#include <bitset>
+
+namespace FalseSharing
+{
+
+auto onParse(Args args) -> void;
+auto onExit() -> void;
+auto requirements() -> prism::capabilities;
+/* Prism hooks */
+
+using Addr = PtrVal;
+using TID = int16_t;
+constexpr TID MAX_THREADS = 128;
+constexpr unsigned LINE_BITS = 6;
+constexpr Addr LINE_BYTES = 1 << LINE_BITS;
+
+using Threads = std::bitset<MAX_THREADS>;
+
+struct SharedLine
+{
+    /* Reported for each of the most shared cache lines */
+
+    Threads writers;
+    Threads readers;
+    /* threads whose accesses to the line were sharing misses */
+
+    static constexpr unsigned maxInstrs = 4;
+    TopK<Addr> instrs{maxInstrs};
+    /* the instructions that caused the most misses on this line */
+};
+
+
+class Handler : public BackendIface
+{
+    /* Classifies coherence misses on each 64-byte cache line.
+     *
+     * Each line remembers which threads hold a valid copy; a write by one
+     * thread invalidates everyone else's copy, like a simple invalidation
+     * protocol with unbounded caches. When a thread touches a line it no
+     * longer holds, the miss is 'true sharing' if any of the 8-byte words it
+     * touches were last written by another thread, and 'false sharing'
+     * otherwise, i.e. the line was only invalidated by writes to other words */
+
+  public:
+    Handler() {}
+    Handler(const Handler &) = delete;
+    Handler &operator=(const Handler &) = delete;
+    virtual ~Handler() override;
+
+  private:
+    virtual auto onSyncEv(const prism::SyncEvent &ev) -> void override;
+    virtual auto onMemEv(const prism::MemEvent &ev) -> void override;
+    virtual auto onCxtEv(const prism::CxtEvent &ev) -> void override;
+
+    auto onLineAccess(Addr addr, unsigned bytes, bool isStore) -> void;
+
+    TID currentTID{0};
+    Addr currentInstr{0};
+
+    struct
+    {
+        Count accesses{0};
+        Count falseMisses{0};
+        Count trueMisses{0};
+    } counts;
+    /* this event stream's share, added to the totals when it finishes */
+};
+
+}; //end namespace FalseSharing
+
+#endif
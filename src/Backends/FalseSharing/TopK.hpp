@@ -0,0 +1,128 @@
+#ifndef FALSESHARING_TOPK_H
+#define FALSESHARING_TOPK_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace FalseSharing
+{
+
+using Count = uint64_t;
+
+struct NoPayload {};
+
+template <typename Key, typename Payload = NoPayload>
+class TopK
+{
+    /* Space-Saving sketch: the heaviest keys of a stream in a fixed number
+     * of counters ("Efficient Computation of Frequent and Top-k Elements in
+     * Data Streams", Metwally et al.).
+     *
+     * When a new key arrives and every counter is taken, it replaces the
+     * smallest one and inherits its count; 'error' keeps that inherited count,
+     * so the true count of a key lies in [count - error, count].
+     * Any key with a true count above (total / capacity) is guaranteed to be kept.
+     *
+     * Counters are kept in a min-heap, so each update is O(log capacity) */
+
+  public:
+    struct Entry
+    {
+        Key key;
+        Count count;
+        Count error;
+        Payload payload;
+    };
+
+    explicit TopK(size_t capacity) : capacity(capacity)
+    {
+        assert(capacity > 0);
+        heap.reserve(capacity);
+        index.reserve(capacity);
+    }
+
+    auto add(Key key, Count weight = 1) -> Payload&
+    {
+        /* returns the key's payload, which is reset if the key is new */
+        size_t at;
+        auto it = index.find(key);
+        if (it != index.end())
+        {
+            at = it->second;
+            heap[at].count += weight;
+        }
+        else if (heap.size() < capacity)
+        {
+            at = heap.size();
+            heap.push_back({key, weight, 0, Payload{}});
+            index.emplace(key, at);
+            at = siftUp(at);
+        }
+        else
+        {
+            /* evict the smallest */
+            at = 0;
+            index.erase(heap[at].key);
+            Count min = heap[at].count;
+            heap[at] = {key, min + weight, min, Payload{}};
+            index.emplace(key, at);
+        }
+
+        return heap[siftDown(at)].payload;
+    }
+
+    auto sorted() const -> std::vector<Entry>
+    {
+        /* heaviest first */
+        auto entries = heap;
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry &l, const Entry &r) { return l.count > r.count; });
+        return entries;
+    }
+
+    auto size() const -> size_t { return heap.size(); }
+
+  private:
+    auto swap(size_t a, size_t b) -> void
+    {
+        std::swap(heap[a], heap[b]);
+        index[heap[a].key] = a;
+        index[heap[b].key] = b;
+    }
+
+    auto siftUp(size_t at) -> size_t
+    {
+        while (at > 0 && heap[(at - 1) / 2].count > heap[at].count)
+        {
+            swap(at, (at - 1) / 2);
+            at = (at - 1) / 2;
+        }
+        return at;
+    }
+
+    auto siftDown(size_t at) -> size_t
+    {
+        while (true)
+        {
+            size_t smallest = at;
+            for (size_t child : {2 * at + 1, 2 * at + 2})
+                if (child < heap.size() && heap[child].count < heap[smallest].count)
+                    smallest = child;
+            if (smallest == at)
+                return at;
+            swap(at, smallest);
+            at = smallest;
+        }
+    }
+
+    size_t capacity;
+    std::vector<Entry> heap;
+    std::unordered_map<Key, size_t> index;
+};
+
+}; //end namespace FalseSharing
+
+#endif
@@ -0,0 +1,67 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "FalseSharing/TopK.hpp"
+#include <map>
+#include <random>
+
+using namespace FalseSharing;
+
+TEST_CASE("top-k sketch", "[TopK]")
+{
+    SECTION("exact while there is room")
+    {
+        TopK<int> topk(4);
+        for (int key : {1, 2, 2, 3, 3, 3})
+            topk.add(key);
+
+        auto entries = topk.sorted();
+        REQUIRE(entries.size() == 3);
+        REQUIRE(entries[0].key == 3);
+        REQUIRE(entries[0].count == 3);
+        REQUIRE(entries[0].error == 0);
+        REQUIRE(entries[1].key == 2);
+        REQUIRE(entries[2].key == 1);
+    }
+
+    SECTION("a new key replaces the smallest, inheriting its count")
+    {
+        TopK<int, int> topk(2);
+        topk.add(1, 5) = 10;
+        topk.add(2, 1) = 20;
+        REQUIRE(topk.add(3) == 0); // payload is reset
+
+        auto entries = topk.sorted();
+        REQUIRE(entries.size() == 2);
+        REQUIRE(entries[0].key == 1);
+        REQUIRE(entries[0].payload == 10);
+        REQUIRE(entries[1].key == 3);
+        REQUIRE(entries[1].count == 2);
+        REQUIRE(entries[1].error == 1);
+    }
+
+    SECTION("heavy keys survive a long tail")
+    {
+        /* keys 0..9 are heavy; the tail is many keys seen once */
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<int> tail(100, 1000000);
+
+        TopK<int> topk(64);
+        std::map<int, Count> exact;
+        for (unsigned i = 0; i < 200000; ++i)
+        {
+            int key = (i % 4 == 0 ? static_cast<int>(i / 4 % 10) : tail(gen));
+            topk.add(key);
+            ++exact[key];
+        }
+
+        auto entries = topk.sorted();
+        REQUIRE(entries.size() == 64);
+        for (unsigned i = 0; i < 10; ++i)
+        {
+            REQUIRE(entries[i].key < 10);
+            REQUIRE(entries[i].count >= exact[entries[i].key]);
+            REQUIRE(entries[i].count - entries[i].error <= exact[entries[i].key]);
+        }
+    }
+}
@@ -0,0 +1,177 @@
+#include "Handler.hpp"
+#include "Snapshot.hpp"
+#include "Utils/BackendOptions.hpp"
+#include "Utils/PrismLog.hpp"
+#include <mutex>
+#include <set>
+
+using namespace PrismLog; // console logging
+namespace Heatmap
+{
+
+/* Global to all threads */
+namespace
+{
+std::string outputPath{"."};
+unsigned regionBits{12};
+Count interval{1000000};
+unsigned decayShift{1};
+size_t maxTables{256};
+
+std::mutex gMtx;
+std::unique_ptr<FILE, int(*)(FILE*)> output{nullptr, fclose};
+Count snapshots{0};
+
+auto heatmapPath() -> std::string
+{
+    return outputPath + "/sigil.heatmap.bin";
+}
+}; //end namespace
+
+
+//-----------------------------------------------------------------------------
+/** Synchronization Event Handling **/
+auto Handler::onSyncEv(const prism::SyncEvent &ev) -> void
+{
+    if (ev.type() != SyncTypeEnum::PRISM_SYNC_SWAP || ev.data() == currentTID)
+        return;
+
+    currentTID = ev.data();
+    auto it = threads.find(currentTID);
+    if (it == threads.end())
+    {
+        auto heat = std::unique_ptr<ThreadHeat>(new ThreadHeat{RegionTable(regionBits, maxTables)});
+        it = threads.emplace(currentTID, std::move(heat)).first;
+    }
+    current = it->second.get();
+}
+
+
+//-----------------------------------------------------------------------------
+/** Memory Event Handling **/
+auto Handler::onMemEv(const prism::MemEvent &ev) -> void
+{
+    if (current == nullptr)
+        fatal("Heatmap: memory event before any thread was seen");
+
+    /* the whole access counts towards the region it starts in */
+    if (ev.isLoad())
+        current->table.read(ev.addr(), ev.bytes());
+    else if (ev.isStore())
+        current->table.write(ev.addr(), ev.bytes());
+
+    if (++current->events % interval == 0)
+        snapshot(currentTID, *current);
+}
+
+
+auto Handler::snapshot(TID tid, ThreadHeat &heat) -> void
+{
+    auto bytes = serializeSnapshot(tid, heat.events, heat.table);
+    heat.table.decay(decayShift);
+
+    std::lock_guard<std::mutex> lock(gMtx);
+    if (fwrite(bytes.data(), 1, bytes.size(), output.get()) != bytes.size())
+        fatal("writing heatmap: " + heatmapPath());
+    ++snapshots;
+}
+
+
+//-----------------------------------------------------------------------------
+/** Flush final stats and data **/
+Handler::~Handler()
+{
+    /* the rest of each thread's last interval */
+    for (auto &p : threads)
+    {
+        if (p.second->events % interval != 0)
+            snapshot(p.first, *p.second);
+    }
+}
+
+
+auto onExit() -> void
+{
+    std::lock_guard<std::mutex> lock(gMtx);
+    info("Flushed " + std::to_string(snapshots) + " heatmap snapshots to: " + heatmapPath());
+    if (fflush(output.get()) != 0)
+        fatal("writing heatmap: " + heatmapPath());
+    output.reset();
+}
+
+
+//-----------------------------------------------------------------------------
+/** Option Parsing **/
+namespace
+{
+
+auto parseRegionBits(std::string bytes) -> unsigned
+{
+    Count regionSize = prism::parsePositive(bytes, 4096, "Heatmap region size");
+    if ((regionSize & (regionSize - 1)) != 0)
+        fatal("Heatmap region size: must be a power of two");
+    return __builtin_ctzll(regionSize);
+}
+
+
+}; //end namespace
+
+
+auto onParse(Args args) -> void
+{
+    /* only accept short options */
+    std::set<char> options;
+    options.insert('o'); // -o OUTPUT_DIRECTORY
+    options.insert('g'); // -g REGION_BYTES
+    options.insert('w'); // -w EVENTS per snapshot
+    options.insert('d'); // -d DECAY_BITS
+    options.insert('m'); // -m MAX_TABLES per thread
+    auto matches = prism::parseShortOptions(args, options, "heatmap");
+
+    outputPath = prism::parseOutputPath(matches['o']);
+    regionBits = parseRegionBits(matches['g']);
+    interval = prism::parsePositive(matches['w'], 1000000, "Heatmap interval");
+    maxTables = prism::parsePositive(matches['m'], 256, "Heatmap max tables");
+
+    /* 0 keeps every byte, 64 clears the counts at each snapshot */
+    decayShift = (matches['d'] == "0" ? 0 : prism::parsePositive(matches['d'], 1, "Heatmap decay"));
+
+    output.reset(fopen(heatmapPath().c_str(), "w"));
+    if (output == nullptr || writeFileHeader(output.get(), regionBits) == false)
+        fatal("writing heatmap: " + heatmapPath());
+}
+
+
+auto requirements() -> prism::capabilities
+{
+    using namespace prism;
+    using namespace prism::capability;
+
+    auto caps = initCaps();
+
+    caps[MEMORY]         = availability::enabled;
+    caps[MEMORY_LDST]    = availability::enabled;
+    caps[MEMORY_SIZE]    = availability::enabled;
+    caps[MEMORY_ADDRESS] = availability::enabled;
+
+    caps[COMPUTE]              = availability::disabled;
+    caps[COMPUTE_INT_OR_FLOAT] = availability::disabled;
+    caps[COMPUTE_ARITY]        = availability::disabled;
+    caps[COMPUTE_OP]           = availability::disabled;
+    caps[COMPUTE_SIZE]         = availability::disabled;
+
+    caps[CONTROL_FLOW] = availability::disabled;
+
+    caps[SYNC]      = availability::enabled;
+    caps[SYNC_TYPE] = availability::enabled;
+    caps[SYNC_ARGS] = availability::enabled;
+
+    caps[CONTEXT_INSTRUCTION] = availability::disabled;
+    caps[CONTEXT_BASIC_BLOCK] = availability::disabled;
+    caps[CONTEXT_FUNCTION]    = availability::disabled;
+    caps[CONTEXT_THREAD]      = availability::enabled;
+
+    return caps;
+}
+
+}; //end namespace Heatmap
@@ -0,0 +1,51 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include "Core/Backends.hpp"
+#include "RegionTable.hpp"
+#include <map>
+
+namespace Heatmap
+{
+
+auto onParse(Args args) -> void;
+auto onExit() -> void;
+auto requirements() -> prism::capabilities;
+/* Prism hooks */
+
+using TID = SyncID;
+
+class Handler : public BackendIface
+{
+    /* Counts the bytes each thread reads and writes, per address region.
+     *
+     * Every so many memory events of a thread, its counts are written as a
+     * snapshot and then decayed, so each snapshot weighs recent traffic
+     * most, and regions that go cold drop out of the thread's table */
+
+  public:
+    Handler() {}
+    Handler(const Handler &) = delete;
+    Handler &operator=(const Handler &) = delete;
+    virtual ~Handler() override;
+
+  private:
+    virtual auto onSyncEv(const prism::SyncEvent &ev) -> void override;
+    virtual auto onMemEv(const prism::MemEvent &ev) -> void override;
+
+    struct ThreadHeat
+    {
+        RegionTable table;
+        Count events{0};
+    };
+
+    auto snapshot(TID tid, ThreadHeat &heat) -> void;
+
+    std::map<TID, std::unique_ptr<ThreadHeat>> threads;
+    ThreadHeat *current{nullptr};
+    TID currentTID{0};
+};
+
+}; //end namespace Heatmap
+
+#endif
@@ -0,0 +1,89 @@
+#include "RegionTable.hpp"
+#include "Utils/PrismLog.hpp"
+
+namespace Heatmap
+{
+
+constexpr unsigned RegionTable::TABLE_BITS;
+constexpr Addr RegionTable::TABLE_SIZE;
+
+
+RegionTable::RegionTable(unsigned regionBits, size_t maxTables)
+    : regionBits(regionBits)
+    , maxTables(maxTables)
+{
+    if (regionBits >= sizeof(Addr) * CHAR_BIT || maxTables == 0)
+        PrismLog::fatal("Heatmap: invalid region table");
+}
+
+
+auto RegionTable::find(Addr index) -> Table&
+{
+    auto it = pm.find(index);
+    if (it == pm.end())
+    {
+        if (pm.size() == maxTables)
+            evict();
+        it = pm.emplace(index, std::make_unique<Table>()).first;
+    }
+
+    lastIndex = index;
+    last = it->second.get();
+    return *last;
+}
+
+
+auto RegionTable::evict() -> void
+{
+    /* the table with the fewest bytes, after the last decay */
+    auto coldest = std::min_element(pm.begin(), pm.end(), [](const auto &l, const auto &r)
+    {
+        return l.second->total < r.second->total;
+    });
+
+    for (auto &heat : coldest->second->heat)
+    {
+        other.read_bytes += heat.read_bytes;
+        other.write_bytes += heat.write_bytes;
+    }
+
+    if (last == coldest->second.get())
+        last = nullptr;
+    pm.erase(coldest);
+}
+
+
+auto RegionTable::decay(unsigned shift) -> void
+{
+    auto age = [&](Count count) -> Count
+    {
+        return shift >= sizeof(Count) * CHAR_BIT ? 0 : count >> shift;
+    };
+
+    other.read_bytes = age(other.read_bytes);
+    other.write_bytes = age(other.write_bytes);
+
+    for (auto it = pm.begin(); it != pm.end();)
+    {
+        auto &table = *it->second;
+        table.total = 0;
+        for (auto &heat : table.heat)
+        {
+            heat.read_bytes = age(heat.read_bytes);
+            heat.write_bytes = age(heat.write_bytes);
+            table.total += heat.read_bytes + heat.write_bytes;
+        }
+
+        if (table.total > 0)
+        {
+            ++it;
+            continue;
+        }
+
+        if (last == &table)
+            last = nullptr;
+        it = pm.erase(it);
+    }
+}
+
+}; //end namespace Heatmap
@@ -0,0 +1,115 @@
+#ifndef HEATMAP_REGION_TABLE_H
+#define HEATMAP_REGION_TABLE_H
+
+#include "Core/Primitive.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Heatmap
+{
+
+using Addr = PtrVal;
+using Count = uint64_t;
+
+struct Heat
+{
+    Count read_bytes{0};
+    Count write_bytes{0};
+};
+
+
+class RegionTable
+{
+    /* Bytes read and written in each region of 2^regionBits bytes.
+     *
+     * Like ShadowMemory, a primary map points to secondary tables, each
+     * holding the counters of 2^TABLE_BITS adjacent regions; but the
+     * primary map is sparse, since there is one table per thread.
+     *
+     * Tables are created as their regions are first touched, up to
+     * 'maxTables'. Past that, the coldest table is evicted, and its bytes
+     * are only kept in 'other'. decay() ages every counter and frees the
+     * tables left empty, so regions no longer used give their tables back */
+  public:
+    static constexpr unsigned TABLE_BITS = 10;
+    static constexpr Addr TABLE_SIZE = Addr{1} << TABLE_BITS;
+
+    RegionTable(unsigned regionBits, size_t maxTables);
+
+    auto read(Addr addr, ByteCount bytes) -> void
+    {
+        auto &table = tableOf(addr >> regionBits);
+        table.heat[(addr >> regionBits) & (TABLE_SIZE - 1)].read_bytes += bytes;
+        table.total += bytes;
+    }
+
+    auto write(Addr addr, ByteCount bytes) -> void
+    {
+        auto &table = tableOf(addr >> regionBits);
+        table.heat[(addr >> regionBits) & (TABLE_SIZE - 1)].write_bytes += bytes;
+        table.total += bytes;
+    }
+
+    /* Shift every counter, including 'other', right by 'shift' bits;
+     * 64 or more clears them */
+    auto decay(unsigned shift) -> void;
+
+    /* f(Addr region, const Heat &heat), for each region with any bytes,
+     * in address order; the region starts at 'region << regionBits' */
+    template <typename F>
+    auto forEach(F f) const -> void
+    {
+        std::vector<Addr> indices;
+        for (auto &p : pm)
+            indices.push_back(p.first);
+        std::sort(indices.begin(), indices.end());
+
+        for (auto index : indices)
+        {
+            auto &table = *pm.find(index)->second;
+            for (Addr i = 0; i < TABLE_SIZE; ++i)
+            {
+                if (table.heat[i].read_bytes > 0 || table.heat[i].write_bytes > 0)
+                    f((index << TABLE_BITS) | i, table.heat[i]);
+            }
+        }
+    }
+
+    auto getOther() const -> const Heat& { return other; }
+    auto getTables() const -> size_t { return pm.size(); }
+
+    const unsigned regionBits;
+    const size_t maxTables;
+
+  private:
+    struct Table
+    {
+        std::array<Heat, TABLE_SIZE> heat{};
+        Count total{0};
+    };
+
+    auto tableOf(Addr region) -> Table&
+    {
+        Addr index = region >> TABLE_BITS;
+        if (last != nullptr && lastIndex == index)
+            return *last;
+        return find(index);
+    }
+    auto find(Addr index) -> Table&;
+    auto evict() -> void;
+
+    std::unordered_map<Addr, std::unique_ptr<Table>> pm;
+    Addr lastIndex{0};
+    Table *last{nullptr};
+    /* the table of the previous access, since accesses cluster */
+
+    Heat other;
+};
+
+}; //end namespace Heatmap
+
+#endif
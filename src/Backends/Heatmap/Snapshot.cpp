@@ -0,0 +1,38 @@
+#include "Snapshot.hpp"
+#include <cstring>
+
+namespace Heatmap
+{
+
+auto writeFileHeader(FILE *file, unsigned regionBits) -> bool
+{
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.region_bits = regionBits;
+    return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+
+auto serializeSnapshot(uint64_t thread, uint64_t events, const RegionTable &table)
+    -> std::vector<char>
+{
+    std::vector<RegionRecord> records;
+    table.forEach([&](Addr region, const Heat &heat)
+    {
+        records.push_back(RegionRecord{region, heat.read_bytes, heat.write_bytes});
+    });
+
+    SnapshotHeader header{thread, events,
+                          table.getOther().read_bytes, table.getOther().write_bytes,
+                          records.size()};
+
+    std::vector<char> ret(sizeof(header) + records.size() * sizeof(RegionRecord));
+    std::memcpy(ret.data(), &header, sizeof(header));
+    if (records.empty() == false)
+        std::memcpy(ret.data() + sizeof(header), records.data(),
+                    records.size() * sizeof(RegionRecord));
+    return ret;
+}
+
+}; //end namespace Heatmap
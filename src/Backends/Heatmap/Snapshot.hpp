@@ -0,0 +1,57 @@
+#ifndef HEATMAP_SNAPSHOT_H
+#define HEATMAP_SNAPSHOT_H
+
+#include "RegionTable.hpp"
+#include <cstdio>
+#include <vector>
+
+namespace Heatmap
+{
+
+/* sigil.heatmap.bin is one FileHeader, then any number of snapshots, each a
+ * SnapshotHeader followed by 'regions' RegionRecords. Every field is in the
+ * byte order of the machine that ran Sigil2, i.e. little endian on x86 */
+
+constexpr char MAGIC[8] = {'S', 'G', 'L', 'H', 'E', 'A', 'T', '\0'};
+constexpr uint32_t VERSION = 1;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t region_bits;
+};
+
+struct SnapshotHeader
+{
+    uint64_t thread;
+    uint64_t events;
+    /* memory events of the thread so far */
+    uint64_t other_read_bytes;
+    uint64_t other_write_bytes;
+    /* bytes of evicted regions */
+    uint64_t regions;
+};
+
+struct RegionRecord
+{
+    uint64_t region;
+    /* the region starts at 'region << region_bits' */
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+};
+
+static_assert(sizeof(FileHeader) == 16 && sizeof(SnapshotHeader) == 40 &&
+              sizeof(RegionRecord) == 24, "snapshots have no padding");
+
+
+auto writeFileHeader(FILE *file, unsigned regionBits) -> bool;
+
+/* One snapshot of the thread's table, as a single buffer so that
+ * snapshots from different threads can be appended under one lock */
+auto serializeSnapshot(uint64_t thread, uint64_t events, const RegionTable &table)
+    -> std::vector<char>;
+
+}; //end namespace Heatmap
+
+#endif
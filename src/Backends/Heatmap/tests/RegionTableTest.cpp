@@ -0,0 +1,116 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "Heatmap/Snapshot.hpp"
+#include <cstring>
+#include <map>
+
+using namespace Heatmap;
+
+namespace
+{
+
+auto regions(const RegionTable &table) -> std::map<Addr, std::pair<Count, Count>>
+{
+    std::map<Addr, std::pair<Count, Count>> ret;
+    table.forEach([&](Addr region, const Heat &heat)
+    {
+        ret[region] = {heat.read_bytes, heat.write_bytes};
+    });
+    return ret;
+}
+
+}; //end namespace
+
+TEST_CASE("region heat", "[RegionTable]")
+{
+    SECTION("bytes are counted by the region an access starts in")
+    {
+        RegionTable table(12, 16);
+        table.read(0x1000, 8);
+        table.read(0x1ff8, 16);
+        table.write(0x2000, 4);
+        table.read(0x7fff0000, 1);
+
+        auto heat = regions(table);
+        REQUIRE(heat.size() == 3);
+        REQUIRE(heat[0x1].first == 24);
+        REQUIRE(heat[0x1].second == 0);
+        REQUIRE(heat[0x2].first == 0);
+        REQUIRE(heat[0x2].second == 4);
+        REQUIRE(heat[0x7fff0].first == 1);
+        REQUIRE(heat[0x7fff0].second == 0);
+
+        /* the first two regions share a table */
+        REQUIRE(table.getTables() == 2);
+    }
+
+    SECTION("decay halves the counts and frees empty tables")
+    {
+        RegionTable table(6, 16);
+        table.write(0, 64);
+        table.read(Addr{1} << 40, 1);
+        table.decay(1);
+
+        auto heat = regions(table);
+        REQUIRE(heat.size() == 1);
+        REQUIRE(heat[0].first == 0);
+        REQUIRE(heat[0].second == 32);
+        REQUIRE(table.getTables() == 1);
+
+        table.decay(64);
+        REQUIRE(regions(table).empty() == true);
+        REQUIRE(table.getTables() == 0);
+
+        /* and the table can be used again */
+        table.write(0, 8);
+        REQUIRE(regions(table)[0].first == 0);
+        REQUIRE(regions(table)[0].second == 8);
+    }
+
+    SECTION("the coldest table is evicted once there are too many")
+    {
+        /* each region is its own table */
+        Addr stride = RegionTable::TABLE_SIZE << 6;
+        RegionTable table(6, 2);
+        table.read(0 * stride, 100);
+        table.read(1 * stride, 10);
+        table.write(2 * stride, 50);
+
+        REQUIRE(table.getTables() == 2);
+        REQUIRE(table.getOther().read_bytes == 10);
+        REQUIRE(table.getOther().write_bytes == 0);
+
+        auto heat = regions(table);
+        REQUIRE(heat.count(0) == 1);
+        REQUIRE(heat.count(2 * RegionTable::TABLE_SIZE) == 1);
+
+        /* a region of an evicted table starts over */
+        table.read(1 * stride, 1);
+        REQUIRE(table.getTables() == 2);
+        REQUIRE(regions(table)[RegionTable::TABLE_SIZE].first == 1);
+    }
+
+    SECTION("snapshots hold the header and every region")
+    {
+        RegionTable table(12, 16);
+        table.read(0x1000, 8);
+        table.write(0x5000, 2);
+
+        auto bytes = serializeSnapshot(3, 7, table);
+        REQUIRE(bytes.size() == sizeof(SnapshotHeader) + 2 * sizeof(RegionRecord));
+
+        SnapshotHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        REQUIRE(header.thread == 3);
+        REQUIRE(header.events == 7);
+        REQUIRE(header.regions == 2);
+
+        RegionRecord records[2];
+        std::memcpy(records, bytes.data() + sizeof(header), sizeof(records));
+        REQUIRE(records[0].region == 0x1);
+        REQUIRE(records[0].read_bytes == 8);
+        REQUIRE(records[1].region == 0x5);
+        REQUIRE(records[1].write_bytes == 2);
+    }
+}
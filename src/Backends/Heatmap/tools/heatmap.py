@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+
+# Reads a sigil.heatmap.bin written by the Heatmap backend
+#
+#   heatmap.py csv sigil.heatmap.bin > heatmap.csv
+#   heatmap.py plot sigil.heatmap.bin heatmap.png --thread 1 --top 32
+#
+# Plotting needs matplotlib; CSV output only needs python
+
+import argparse
+import struct
+import sys
+
+FILE_HEADER = struct.Struct('<8sII')      # magic, version, region_bits
+SNAPSHOT_HEADER = struct.Struct('<QQQQQ')  # thread, events, other bytes read/written, regions
+REGION_RECORD = struct.Struct('<QQQ')      # region, bytes read, bytes written
+MAGIC = b'SGLHEAT\0'
+
+
+def read_snapshots(path):
+    """Returns the region size in bytes, and a list of snapshots,
+    each (thread, events, (other_read, other_write), [(start, read, write)])"""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    magic, version, region_bits = FILE_HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != 1:
+        sys.exit('not a version 1 heatmap: ' + path)
+
+    snapshots = []
+    offset = FILE_HEADER.size
+    while offset < len(data):
+        thread, events, other_read, other_write, count = SNAPSHOT_HEADER.unpack_from(data, offset)
+        offset += SNAPSHOT_HEADER.size
+
+        regions = []
+        for region, read, write in REGION_RECORD.iter_unpack(
+                data[offset:offset + count * REGION_RECORD.size]):
+            regions.append((region << region_bits, read, write))
+        offset += count * REGION_RECORD.size
+
+        snapshots.append((thread, events, (other_read, other_write), regions))
+    return 1 << region_bits, snapshots
+
+
+def write_csv(path):
+    region_size, snapshots = read_snapshots(path)
+    print('snapshot,thread,events,region_start,region_bytes,read_bytes,write_bytes')
+    for i, (thread, events, other, regions) in enumerate(snapshots):
+        for start, read, write in regions:
+            print('%d,%d,%d,0x%x,%d,%d,%d' % (i, thread, events, start, region_size, read, write))
+        if other != (0, 0):
+            print('%d,%d,%d,other,,%d,%d' % (i, thread, events, other[0], other[1]))
+
+
+def plot(path, output, thread, top):
+    import matplotlib
+    matplotlib.use('Agg')
+    import matplotlib.pyplot as plt
+
+    region_size, snapshots = read_snapshots(path)
+    if thread is None and len(snapshots) > 0:
+        thread = snapshots[0][0]
+    snapshots = [s for s in snapshots if s[0] == thread]
+    if len(snapshots) == 0:
+        sys.exit('no snapshots for thread %s' % thread)
+
+    # the hottest regions over all snapshots, in address order
+    totals = {}
+    for _, _, _, regions in snapshots:
+        for start, read, write in regions:
+            totals[start] = totals.get(start, 0) + read + write
+    hottest = sorted(sorted(totals, key=totals.get, reverse=True)[:top])
+    rows = {start: i for i, start in enumerate(hottest)}
+
+    heat = [[0] * len(snapshots) for _ in hottest]
+    for col, (_, _, _, regions) in enumerate(snapshots):
+        for start, read, write in regions:
+            if start in rows:
+                heat[rows[start]][col] = read + write
+
+    fig, ax = plt.subplots(figsize=(10, max(3, len(hottest) * 0.25)))
+    image = ax.imshow(heat, aspect='auto', interpolation='nearest', cmap='inferno')
+    ax.set_yticks(range(len(hottest)))
+    ax.set_yticklabels(['0x%x' % start for start in hottest], fontsize=6)
+    ax.set_xlabel('snapshot')
+    ax.set_ylabel('region (%d bytes)' % region_size)
+    ax.set_title('thread %d' % thread)
+    fig.colorbar(image, label='bytes')
+    fig.tight_layout()
+    fig.savefig(output)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Sigil2 heatmap snapshots')
+    commands = parser.add_subparsers(dest='command')
+    commands.required = True
+
+    csv = commands.add_parser('csv', help='print every snapshot as CSV')
+    csv.add_argument('heatmap')
+
+    image = commands.add_parser('plot', help='plot the hottest regions over time')
+    image.add_argument('heatmap')
+    image.add_argument('output')
+    image.add_argument('--thread', type=int, help='default: the first thread')
+    image.add_argument('--top', type=int, default=32, help='number of regions')
+
+    args = parser.parse_args()
+    if args.command == 'csv':
+        write_csv(args.heatmap)
+    else:
+        plot(args.heatmap, args.output, args.thread, args.top)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,190 @@
+#include "Handler.hpp"
+#include "Histograms.hpp"
+#include "Utils/BackendOptions.hpp"
+#include "Utils/FileLogger.hpp"
+#include <mutex>
+#include <set>
+
+using namespace PrismLog; // console logging
+namespace LockProf
+{
+
+/* Global to all threads */
+namespace
+{
+std::string outputPath{"."};
+unsigned topLocks{32};
+
+std::mutex gMtx;
+LockProfiles allLocks;
+Count unmatched{0};
+}; //end namespace
+
+
+//-----------------------------------------------------------------------------
+/** Event Handling **/
+auto Handler::onSyncEv(const prism::SyncEvent &ev) -> void
+{
+    switch (ev.type())
+    {
+    case SyncTypeEnum::PRISM_SYNC_SWAP:
+        tracker.swap(ev.data());
+        break;
+    case SyncTypeEnum::PRISM_SYNC_LOCK:
+    case SyncTypeEnum::PRISM_SYNC_SPINLOCK:
+        tracker.lock(ev.data());
+        break;
+    case SyncTypeEnum::PRISM_SYNC_UNLOCK:
+    case SyncTypeEnum::PRISM_SYNC_SPINUNLOCK:
+        tracker.unlock(ev.data());
+        break;
+    case SyncTypeEnum::PRISM_SYNC_CONDWAIT:
+        /* condition variable, then mutex */
+        tracker.condwait(ev.dataExtra());
+        break;
+    default:
+        break;
+    }
+}
+
+
+auto Handler::onMemEv(const prism::MemEvent &) -> void
+{
+    tracker.memAccesses(1);
+}
+
+
+auto Handler::onMemCountEv(const prism::MemEvent &, PtrVal count) -> void
+{
+    tracker.memAccesses(count);
+}
+
+
+auto Handler::onCxtEv(const prism::CxtEvent &ev) -> void
+{
+    if (ev.type() == CxtTypeEnum::PRISM_CXT_INSTR)
+        tracker.instr();
+}
+
+
+//-----------------------------------------------------------------------------
+/** Flush final stats and data **/
+Handler::~Handler()
+{
+    std::lock_guard<std::mutex> lock(gMtx);
+    for (auto &p : tracker.getLocks())
+        allLocks[p.first] += p.second;
+    unmatched += tracker.getUnmatched();
+}
+
+
+namespace
+{
+
+auto mean(Count total, Count count) -> double
+{
+    return count == 0 ? 0.0 : static_cast<double>(total) / count;
+}
+
+
+auto flushReport(std::string filePath) -> void
+{
+    auto loggerPair = prism::getFileLogger(filePath);
+    auto logger = std::move(loggerPair.first);
+    info("Flushing lock profile to: " + logger->name());
+
+    auto ranked = rankLocks(allLocks);
+    logger->info("Locks: {}", ranked.size());
+    logger->info("Unmatched releases: {}", unmatched);
+    logger->info("Most instructions held, top {}:", std::min<size_t>(topLocks, ranked.size()));
+
+    for (size_t i = 0; i < ranked.size() && i < topLocks; ++i)
+    {
+        auto &total = ranked[i].second;
+        auto &profile = allLocks.find(ranked[i].first)->second;
+
+        logger->info("Lock 0x{:x}", ranked[i].first);
+        logger->info("\tAcquisitions: {}, hand-offs: {} ({:.1f}%), nested: {}, condition waits: {}",
+                     total.acquisitions, total.handoffs,
+                     100 * mean(total.handoffs, total.acquisitions),
+                     total.nested, total.condwaits);
+        logger->info("\tHeld: {} instructions (mean {:.1f}), {} memory accesses (mean {:.1f})",
+                     total.instrs, mean(total.instrs, total.acquisitions),
+                     total.memAccesses, mean(total.memAccesses, total.acquisitions));
+
+        for (auto &p : profile.outer)
+            logger->info("\tInside 0x{:x}: {} times", p.first, p.second);
+
+        for (auto &p : profile.threads)
+            logger->info("\tThread {}: {} acquisitions, {} instructions, {} memory accesses",
+                         p.first, p.second.acquisitions, p.second.instrs, p.second.memAccesses);
+    }
+
+    logger->flush();
+    prism::blockingFlushAndDeleteLogger(logger);
+}
+
+}; //end namespace
+
+
+auto onExit() -> void
+{
+    std::lock_guard<std::mutex> lock(gMtx);
+    flushReport(outputPath + "/sigil.lockprof.out");
+
+    std::string histogramsPath = outputPath + "/sigil.lockprof.bin";
+    std::unique_ptr<FILE, int(*)(FILE*)> file(fopen(histogramsPath.c_str(), "w"), fclose);
+    if (file == nullptr || writeHistograms(file.get(), allLocks) == false ||
+        fflush(file.get()) != 0)
+        fatal("writing lock histograms: " + histogramsPath);
+}
+
+
+//-----------------------------------------------------------------------------
+/** Option Parsing **/
+auto onParse(Args args) -> void
+{
+    /* only accept short options */
+    std::set<char> options;
+    options.insert('o'); // -o OUTPUT_DIRECTORY
+    options.insert('k'); // -k LOCKS reported
+    auto matches = prism::parseShortOptions(args, options, "lockprof");
+
+    outputPath = prism::parseOutputPath(matches['o']);
+    topLocks = prism::parsePositive(matches['k'], 32, "LockProf locks");
+}
+
+
+auto requirements() -> prism::capabilities
+{
+    using namespace prism;
+    using namespace prism::capability;
+
+    auto caps = initCaps();
+
+    caps[MEMORY]         = availability::enabled;
+    caps[MEMORY_LDST]    = availability::disabled;
+    caps[MEMORY_SIZE]    = availability::disabled;
+    caps[MEMORY_ADDRESS] = availability::disabled;
+
+    caps[COMPUTE]              = availability::disabled;
+    caps[COMPUTE_INT_OR_FLOAT] = availability::disabled;
+    caps[COMPUTE_ARITY]        = availability::disabled;
+    caps[COMPUTE_OP]           = availability::disabled;
+    caps[COMPUTE_SIZE]         = availability::disabled;
+
+    caps[CONTROL_FLOW] = availability::disabled;
+
+    caps[SYNC]      = availability::enabled;
+    caps[SYNC_TYPE] = availability::enabled;
+    caps[SYNC_ARGS] = availability::enabled;
+
+    caps[CONTEXT_INSTRUCTION] = availability::enabled;
+    caps[CONTEXT_BASIC_BLOCK] = availability::disabled;
+    caps[CONTEXT_FUNCTION]    = availability::disabled;
+    caps[CONTEXT_THREAD]      = availability::enabled;
+
+    return caps;
+}
+
+}; //end namespace LockProf
@@ -0,0 +1,39 @@
+#ifndef LOCKPROF_H
+#define LOCKPROF_H
+
+#include "Core/Backends.hpp"
+#include "LockTracker.hpp"
+
+namespace LockProf
+{
+
+auto onParse(Args args) -> void;
+auto onExit() -> void;
+auto requirements() -> prism::capabilities;
+/* Prism hooks */
+
+class Handler : public BackendIface
+{
+    /* Profiles each lock: how often it is acquired, how long each thread
+     * holds it, in instructions and memory accesses, how often it is handed
+     * to another thread, and which locks are held around it. Only counts
+     * are needed from the frontend, not addresses */
+
+  public:
+    Handler() {}
+    Handler(const Handler &) = delete;
+    Handler &operator=(const Handler &) = delete;
+    virtual ~Handler() override;
+
+  private:
+    virtual auto onSyncEv(const prism::SyncEvent &ev) -> void override;
+    virtual auto onMemEv(const prism::MemEvent &ev) -> void override;
+    virtual auto onMemCountEv(const prism::MemEvent &ev, PtrVal count) -> void override;
+    virtual auto onCxtEv(const prism::CxtEvent &ev) -> void override;
+
+    LockTracker tracker;
+};
+
+}; //end namespace LockProf
+
+#endif
@@ -0,0 +1,37 @@
+#include "Histograms.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace LockProf
+{
+
+auto writeHistograms(FILE *file, const LockProfiles &locks) -> bool
+{
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.buckets = HoldHistogram::buckets;
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+        return false;
+
+    for (auto &lock : rankLocks(locks))
+    {
+        for (auto &p : locks.find(lock.first)->second.threads)
+        {
+            auto &stats = p.second;
+            HoldRecord record{lock.first, static_cast<uint64_t>(p.first),
+                              stats.acquisitions, stats.handoffs, stats.nested,
+                              stats.condwaits, stats.instrs, stats.memAccesses, {}, {}};
+            std::copy(stats.instrsHistogram.holds.begin(), stats.instrsHistogram.holds.end(),
+                      record.instrs_histogram);
+            std::copy(stats.memAccessesHistogram.holds.begin(), stats.memAccessesHistogram.holds.end(),
+                      record.mem_accesses_histogram);
+
+            if (fwrite(&record, sizeof(record), 1, file) != 1)
+                return false;
+        }
+    }
+    return true;
+}
+
+}; //end namespace LockProf
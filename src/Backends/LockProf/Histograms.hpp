@@ -0,0 +1,49 @@
+#ifndef LOCKPROF_HISTOGRAMS_H
+#define LOCKPROF_HISTOGRAMS_H
+
+#include "LockTracker.hpp"
+#include <cstdio>
+
+namespace LockProf
+{
+
+/* sigil.lockprof.bin is one FileHeader, then a HoldRecord for each thread
+ * that acquired each lock. Every field is in the byte order of the machine
+ * that ran Sigil2, i.e. little endian on x86 */
+
+constexpr char MAGIC[8] = {'S', 'G', 'L', 'L', 'O', 'C', 'K', '\0'};
+constexpr uint32_t VERSION = 1;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t buckets;
+    /* of each histogram; see HoldHistogram */
+};
+
+struct HoldRecord
+{
+    uint64_t lock;
+    uint64_t thread;
+    uint64_t acquisitions;
+    uint64_t handoffs;
+    uint64_t nested;
+    uint64_t condwaits;
+    uint64_t instrs;
+    uint64_t mem_accesses;
+    uint64_t instrs_histogram[HoldHistogram::buckets];
+    uint64_t mem_accesses_histogram[HoldHistogram::buckets];
+};
+
+static_assert(sizeof(FileHeader) == 16 &&
+              sizeof(HoldRecord) == (8 + 2 * HoldHistogram::buckets) * sizeof(uint64_t),
+              "histograms have no padding");
+
+
+/* in the order of rankLocks(), then by thread */
+auto writeHistograms(FILE *file, const LockProfiles &locks) -> bool;
+
+}; //end namespace LockProf
+
+#endif
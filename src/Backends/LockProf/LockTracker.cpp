@@ -0,0 +1,153 @@
+#include "LockTracker.hpp"
+#include <algorithm>
+
+namespace LockProf
+{
+
+constexpr unsigned HoldHistogram::buckets;
+
+
+auto HoldStats::operator+=(const HoldStats &rhs) -> HoldStats&
+{
+    acquisitions += rhs.acquisitions;
+    handoffs += rhs.handoffs;
+    nested += rhs.nested;
+    condwaits += rhs.condwaits;
+    instrs += rhs.instrs;
+    memAccesses += rhs.memAccesses;
+    for (unsigned i = 0; i < HoldHistogram::buckets; ++i)
+    {
+        instrsHistogram.holds[i] += rhs.instrsHistogram.holds[i];
+        memAccessesHistogram.holds[i] += rhs.memAccessesHistogram.holds[i];
+    }
+    return *this;
+}
+
+
+auto LockProfile::total() const -> HoldStats
+{
+    HoldStats ret;
+    for (auto &p : threads)
+        ret += p.second;
+    return ret;
+}
+
+
+auto LockProfile::operator+=(const LockProfile &rhs) -> LockProfile&
+{
+    for (auto &p : rhs.threads)
+        threads[p.first] += p.second;
+    for (auto &p : rhs.outer)
+        outer[p.first] += p.second;
+    return *this;
+}
+
+
+auto rankLocks(const LockProfiles &locks) -> std::vector<std::pair<Addr, HoldStats>>
+{
+    std::vector<std::pair<Addr, HoldStats>> ret;
+    for (auto &p : locks)
+        ret.emplace_back(p.first, p.second.total());
+
+    std::sort(ret.begin(), ret.end(), [](const auto &l, const auto &r)
+    {
+        if (l.second.instrs != r.second.instrs)
+            return l.second.instrs > r.second.instrs;
+        if (l.second.acquisitions != r.second.acquisitions)
+            return l.second.acquisitions > r.second.acquisitions;
+        return l.first < r.first;
+    });
+    return ret;
+}
+
+
+auto LockTracker::swap(TID tid) -> void
+{
+    if (current != nullptr && current->tid == tid)
+        return;
+
+    auto &thread = threads[tid];
+    if (thread == nullptr)
+    {
+        thread = std::make_unique<ThreadState>();
+        thread->tid = tid;
+    }
+    current = thread.get();
+}
+
+
+auto LockTracker::lock(Addr lock) -> void
+{
+    if (current == nullptr)
+        return;
+
+    auto &profile = locks[lock];
+    auto &stats = profile.threads[current->tid];
+    ++stats.acquisitions;
+
+    /* the owner is updated on acquisition, not release, so a condition
+     * wait's reacquisition sees any thread that held the mutex meanwhile */
+    auto &owner = lastOwner.emplace(lock, current->tid).first->second;
+    if (owner != current->tid)
+        ++stats.handoffs;
+    owner = current->tid;
+
+    if (current->held.empty() == false)
+    {
+        ++stats.nested;
+        for (auto &held : current->held)
+            ++profile.outer[held.lock];
+    }
+
+    current->held.push_back(Held{lock, current->instrs, current->memAccesses});
+}
+
+
+auto LockTracker::unlock(Addr lock) -> void
+{
+    if (current == nullptr)
+        return;
+
+    /* the most recent hold of the lock, for recursive locks */
+    auto &held = current->held;
+    auto it = std::find_if(held.rbegin(), held.rend(), [&](const Held &h) { return h.lock == lock; });
+    if (it == held.rend())
+    {
+        ++unmatched;
+        return;
+    }
+
+    release(*current, std::prev(it.base()));
+}
+
+
+auto LockTracker::condwait(Addr mutex) -> void
+{
+    if (current == nullptr)
+        return;
+
+    auto &held = current->held;
+    auto it = std::find_if(held.rbegin(), held.rend(), [&](const Held &h) { return h.lock == mutex; });
+    if (it != held.rend())
+        release(*current, std::prev(it.base()));
+
+    lock(mutex);
+    ++locks[mutex].threads[current->tid].condwaits;
+}
+
+
+auto LockTracker::release(ThreadState &thread, std::vector<Held>::iterator held) -> void
+{
+    auto &stats = locks[held->lock].threads[thread.tid];
+
+    Count instrs = thread.instrs - held->instrs;
+    Count memAccesses = thread.memAccesses - held->memAccesses;
+    stats.instrs += instrs;
+    stats.memAccesses += memAccesses;
+    stats.instrsHistogram.add(instrs);
+    stats.memAccessesHistogram.add(memAccesses);
+
+    thread.held.erase(held);
+}
+
+}; //end namespace LockProf
@@ -0,0 +1,136 @@
+#ifndef LOCKPROF_LOCK_TRACKER_H
+#define LOCKPROF_LOCK_TRACKER_H
+
+#include "Core/Primitive.h"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace LockProf
+{
+
+using Addr = PtrVal;
+using TID = SyncID;
+using Count = uint64_t;
+constexpr TID NO_THREAD = -1;
+
+struct HoldHistogram
+{
+    /* Bucket 0 counts zeros, bucket i counts values in [2^(i-1), 2^i) */
+    static constexpr unsigned buckets = 65;
+    std::array<Count, buckets> holds{};
+
+    static auto bucket(Count value) -> unsigned
+    {
+        return value == 0 ? 0 : 64 - __builtin_clzll(value);
+    }
+
+    auto add(Count value) -> void { ++holds[bucket(value)]; }
+};
+
+
+struct HoldStats
+{
+    /* Every acquisition of one lock by one thread */
+
+    Count acquisitions{0};
+    Count handoffs{0};
+    /* acquired after a different thread held it */
+    Count nested{0};
+    /* acquired while holding another lock */
+    Count condwaits{0};
+    /* released and acquired again by a condition wait */
+
+    Count instrs{0};
+    Count memAccesses{0};
+    HoldHistogram instrsHistogram;
+    HoldHistogram memAccessesHistogram;
+    /* instructions and memory accesses of the thread while holding the lock */
+
+    auto operator+=(const HoldStats &rhs) -> HoldStats&;
+};
+
+
+struct LockProfile
+{
+    std::map<TID, HoldStats> threads;
+    std::map<Addr, Count> outer;
+    /* locks already held when this one was acquired */
+
+    auto total() const -> HoldStats;
+    auto operator+=(const LockProfile &rhs) -> LockProfile&;
+};
+
+using LockProfiles = std::unordered_map<Addr, LockProfile>;
+
+/* Each lock's totals over all threads, most instructions held first */
+auto rankLocks(const LockProfiles &locks) -> std::vector<std::pair<Addr, HoldStats>>;
+
+
+class LockTracker
+{
+    /* Follows the locks each thread holds, from lock and unlock events,
+     * and counts its instructions and memory accesses while it holds them.
+     *
+     * Nothing is kept per address, only per lock, so this is cheap next
+     * to backends with shadow memory. Threads can hold several locks and
+     * release them in any order; a hold spans every event of the thread
+     * between acquiring and releasing the lock, including other holds.
+     * Hand-offs are only seen between threads of the same event stream */
+  public:
+    auto swap(TID tid) -> void;
+
+    auto instr() -> void
+    {
+        if (current != nullptr)
+            ++current->instrs;
+    }
+
+    auto memAccesses(Count count) -> void
+    {
+        if (current != nullptr)
+            current->memAccesses += count;
+    }
+
+    auto lock(Addr lock) -> void;
+    auto unlock(Addr lock) -> void;
+    auto condwait(Addr mutex) -> void;
+    /* releases and reacquires the mutex, if the thread holds it */
+
+    auto getLocks() const -> const LockProfiles& { return locks; }
+    auto getUnmatched() const -> Count { return unmatched; }
+    /* releases of locks the thread was not seen to acquire */
+
+  private:
+    struct Held
+    {
+        Addr lock;
+        Count instrs;
+        Count memAccesses;
+        /* the thread's counts when it acquired the lock */
+    };
+
+    struct ThreadState
+    {
+        TID tid;
+        Count instrs{0};
+        Count memAccesses{0};
+        std::vector<Held> held;
+    };
+
+    auto release(ThreadState &thread, std::vector<Held>::iterator held) -> void;
+
+    std::unordered_map<TID, std::unique_ptr<ThreadState>> threads;
+    ThreadState *current{nullptr};
+
+    LockProfiles locks;
+    std::unordered_map<Addr, TID> lastOwner;
+    Count unmatched{0};
+};
+
+}; //end namespace LockProf
+
+#endif
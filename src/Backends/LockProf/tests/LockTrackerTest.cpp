@@ -0,0 +1,166 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "LockProf/Histograms.hpp"
+#include <cstdlib>
+#include <cstring>
+
+using namespace LockProf;
+
+namespace
+{
+
+auto run(LockTracker &tracker, unsigned instrs, unsigned memAccesses) -> void
+{
+    for (unsigned i = 0; i < instrs; ++i)
+        tracker.instr();
+    tracker.memAccesses(memAccesses);
+}
+
+
+auto stats(const LockTracker &tracker, Addr lock, TID tid) -> const HoldStats&
+{
+    return tracker.getLocks().find(lock)->second.threads.find(tid)->second;
+}
+
+}; //end namespace
+
+TEST_CASE("lock holds", "[LockTracker]")
+{
+    SECTION("holds are counted in instructions and memory accesses")
+    {
+        LockTracker tracker;
+        tracker.swap(1);
+        run(tracker, 5, 5);
+        tracker.lock(0xA);
+        run(tracker, 10, 3);
+        tracker.unlock(0xA);
+        run(tracker, 5, 5);
+
+        auto &a = stats(tracker, 0xA, 1);
+        REQUIRE(a.acquisitions == 1);
+        REQUIRE(a.instrs == 10);
+        REQUIRE(a.memAccesses == 3);
+        REQUIRE(a.instrsHistogram.holds[HoldHistogram::bucket(10)] == 1);
+        REQUIRE(a.memAccessesHistogram.holds[HoldHistogram::bucket(3)] == 1);
+        REQUIRE(a.handoffs == 0);
+        REQUIRE(a.nested == 0);
+    }
+
+    SECTION("hand-offs are acquisitions after another thread's release")
+    {
+        LockTracker tracker;
+        for (TID tid : {1, 1, 2, 1, 2, 2})
+        {
+            tracker.swap(tid);
+            tracker.lock(0xA);
+            tracker.unlock(0xA);
+        }
+
+        REQUIRE(stats(tracker, 0xA, 1).acquisitions == 3);
+        REQUIRE(stats(tracker, 0xA, 1).handoffs == 1);
+        REQUIRE(stats(tracker, 0xA, 2).acquisitions == 3);
+        REQUIRE(stats(tracker, 0xA, 2).handoffs == 2);
+    }
+
+    SECTION("nested holds, released out of order")
+    {
+        LockTracker tracker;
+        tracker.swap(1);
+        tracker.lock(0xA);
+        run(tracker, 1, 0);
+        tracker.lock(0xB);
+        run(tracker, 2, 0);
+        tracker.unlock(0xA);
+        run(tracker, 4, 0);
+        tracker.unlock(0xB);
+        tracker.unlock(0xC);
+
+        REQUIRE(stats(tracker, 0xA, 1).instrs == 3);
+        REQUIRE(stats(tracker, 0xA, 1).nested == 0);
+        REQUIRE(stats(tracker, 0xB, 1).instrs == 6);
+        REQUIRE(stats(tracker, 0xB, 1).nested == 1);
+        REQUIRE(tracker.getLocks().find(0xB)->second.outer.at(0xA) == 1);
+        REQUIRE(tracker.getUnmatched() == 1);
+    }
+
+    SECTION("a condition wait releases and reacquires its mutex")
+    {
+        LockTracker tracker;
+        tracker.swap(1);
+        tracker.lock(0xA);
+        run(tracker, 4, 0);
+        tracker.condwait(0xA);
+        run(tracker, 2, 0);
+        tracker.unlock(0xA);
+
+        auto &a = stats(tracker, 0xA, 1);
+        REQUIRE(a.acquisitions == 2);
+        REQUIRE(a.condwaits == 1);
+        REQUIRE(a.instrs == 6);
+        REQUIRE(a.instrsHistogram.holds[HoldHistogram::bucket(4)] == 1);
+        REQUIRE(a.instrsHistogram.holds[HoldHistogram::bucket(2)] == 1);
+    }
+
+    SECTION("a condition wait hands off when another thread held the mutex meanwhile")
+    {
+        LockTracker tracker;
+        tracker.swap(1);
+        tracker.lock(0xA);
+
+        /* T1 waits, so T2 can take the mutex to signal */
+        tracker.swap(2);
+        tracker.lock(0xA);
+        tracker.unlock(0xA);
+
+        tracker.swap(1);
+        tracker.condwait(0xA);
+        tracker.unlock(0xA);
+
+        /* and a wait that nobody interrupts is no hand-off */
+        tracker.lock(0xA);
+        tracker.condwait(0xA);
+        tracker.unlock(0xA);
+
+        REQUIRE(stats(tracker, 0xA, 1).acquisitions == 4);
+        REQUIRE(stats(tracker, 0xA, 1).condwaits == 2);
+        REQUIRE(stats(tracker, 0xA, 1).handoffs == 1);
+        REQUIRE(stats(tracker, 0xA, 2).handoffs == 1);
+    }
+
+    SECTION("locks are ranked by instructions held, and written as histograms")
+    {
+        LockTracker tracker;
+        tracker.swap(1);
+        tracker.lock(0xA);
+        run(tracker, 1, 0);
+        tracker.unlock(0xA);
+        tracker.lock(0xB);
+        run(tracker, 8, 0);
+        tracker.unlock(0xB);
+        tracker.swap(2);
+        tracker.lock(0xB);
+        tracker.unlock(0xB);
+
+        auto ranked = rankLocks(tracker.getLocks());
+        REQUIRE(ranked.size() == 2);
+        REQUIRE(ranked[0].first == 0xB);
+        REQUIRE(ranked[0].second.acquisitions == 2);
+        REQUIRE(ranked[1].first == 0xA);
+
+        char *buf = nullptr;
+        size_t size = 0;
+        FILE *file = open_memstream(&buf, &size);
+        REQUIRE(writeHistograms(file, tracker.getLocks()) == true);
+        fclose(file);
+
+        REQUIRE(size == sizeof(FileHeader) + 3 * sizeof(HoldRecord));
+        HoldRecord first;
+        std::memcpy(&first, buf + sizeof(FileHeader), sizeof(first));
+        free(buf);
+        REQUIRE(first.lock == 0xB);
+        REQUIRE(first.thread == 1);
+        REQUIRE(first.instrs == 8);
+        REQUIRE(first.instrs_histogram[HoldHistogram::bucket(8)] == 1);
+    }
+}
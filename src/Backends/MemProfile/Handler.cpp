@@ -0,0 +1,269 @@
+#include "Handler.hpp"
+#include "Utils/BackendOptions.hpp"
+#include "Utils/FileLogger.hpp"
+#include "spdlog/fmt/fmt.h"
+#include <algorithm>
+#include <mutex>
+#include <set>
+
+using namespace PrismLog; // console logging
+namespace MemProfile
+{
+
+struct ThreadProfile
+{
+    ReuseHistogram histogram;
+    Count uses{0};
+    std::vector<Count> workingSets;
+};
+
+/* Global to all threads */
+namespace
+{
+std::string outputPath{"."};
+unsigned blockBits{6};
+unsigned sampleRate{1};
+Count window{1000000};
+constexpr size_t batchSize{4096};
+
+std::mutex gMtx;
+std::unique_ptr<ReuseStack> globalStack;
+std::map<TID, ThreadProfile> allThreadProfiles;
+}; //end namespace
+
+
+Handler::Handler()
+{
+    batch.reserve(batchSize);
+}
+
+
+//-----------------------------------------------------------------------------
+/** Synchronization Event Handling **/
+auto Handler::onSyncEv(const prism::SyncEvent &ev) -> void
+{
+    if (ev.type() != SyncTypeEnum::PRISM_SYNC_SWAP || ev.data() == currentTID)
+        return;
+
+    currentTID = ev.data();
+    auto it = stacks.find(currentTID);
+    if (it == stacks.end())
+        it = stacks.emplace(currentTID, std::make_unique<ReuseStack>(sampleRate, window)).first;
+    current = it->second.get();
+
+    /* hand over this thread's blocks before starting the next thread's */
+    flushBatch();
+}
+
+
+//-----------------------------------------------------------------------------
+/** Memory Event Handling **/
+auto Handler::onMemEv(const prism::MemEvent &ev) -> void
+{
+    if (current == nullptr)
+        fatal("MemProfile: memory event before any thread was seen");
+
+    Addr first = ev.addr() >> blockBits;
+    Addr last = (ev.addr() + std::max<Addr>(ev.bytes(), 1) - 1) >> blockBits;
+    for (Addr block = first; block <= last; ++block)
+    {
+        if (ReuseStack::sampled(block, sampleRate) == false)
+        {
+            current->skip(1);
+            ++skipped;
+            continue;
+        }
+
+        current->use(block);
+        batch.push_back({skipped, block});
+        skipped = 0;
+        if (batch.size() == batchSize)
+            flushBatch();
+    }
+}
+
+
+auto Handler::flushBatch() -> void
+{
+    if (batch.empty() == true && skipped == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(gMtx);
+    for (auto &use : batch)
+    {
+        globalStack->skip(use.skipped);
+        globalStack->use(use.block);
+    }
+    globalStack->skip(skipped);
+
+    batch.clear();
+    skipped = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+/** Flush final stats and data **/
+Handler::~Handler()
+{
+    flushBatch();
+
+    std::lock_guard<std::mutex> lock(gMtx);
+    for (auto &p : stacks)
+    {
+        /* a thread seen by more than one handler is summed window by window */
+        auto &profile = allThreadProfiles[p.first];
+        profile.histogram += p.second->getHistogram();
+        profile.uses += p.second->getUses();
+
+        auto sets = p.second->getWorkingSets();
+        if (profile.workingSets.size() < sets.size())
+            profile.workingSets.resize(sets.size(), 0);
+        for (size_t i = 0; i < sets.size(); ++i)
+            profile.workingSets[i] += sets[i];
+    }
+}
+
+
+namespace
+{
+
+auto formatHistogram(const ReuseHistogram &histogram) -> std::string
+{
+    /* non-empty buckets only, labelled by their exclusive upper bound */
+    std::string ret = fmt::format("cold:{}", histogram.cold);
+    for (unsigned i = 0; i < histogram.reuses.size(); ++i)
+    {
+        if (histogram.reuses[i] == 0)
+            continue;
+        if (i == 0)
+            fmt::format_to(std::back_inserter(ret), " 0:{}", histogram.reuses[i]);
+        else
+            fmt::format_to(std::back_inserter(ret), " <2^{}:{}", i, histogram.reuses[i]);
+    }
+    return ret;
+}
+
+
+auto formatWorkingSets(const std::vector<Count> &sets) -> std::string
+{
+    /* bytes per window */
+    std::string ret;
+    for (auto blocks : sets)
+    {
+        if (ret.empty() == false)
+            ret += ' ';
+        fmt::format_to(std::back_inserter(ret), "{}", blocks << blockBits);
+    }
+    return ret;
+}
+
+
+auto flushProfiles(std::string filePath, const ThreadProfile &global) -> void
+{
+    auto loggerPair = prism::getFileLogger(filePath);
+    auto logger = std::move(loggerPair.first);
+    info("Flushing memory profile to: " + logger->name());
+
+    logger->info("Block size: {} bytes", 1ULL << blockBits);
+    logger->info("Sampling: 1 in {} blocks", sampleRate);
+    logger->info("Window: {} block uses", window);
+
+    for (auto &p : allThreadProfiles)
+    {
+        logger->info("Thread: {}", p.first);
+        logger->info("\tUses: {}", p.second.uses);
+        logger->info("\tReuse distance: {}", formatHistogram(p.second.histogram));
+        logger->info("\tWorking set: {}", formatWorkingSets(p.second.workingSets));
+    }
+
+    logger->info("All threads:");
+    logger->info("\tUses: {}", global.uses);
+    logger->info("\tReuse distance: {}", formatHistogram(global.histogram));
+    logger->info("\tWorking set: {}", formatWorkingSets(global.workingSets));
+
+    logger->flush();
+    prism::blockingFlushAndDeleteLogger(logger);
+}
+
+}; //end namespace
+
+
+auto onExit() -> void
+{
+    std::lock_guard<std::mutex> lock(gMtx);
+    ThreadProfile global{globalStack->getHistogram(),
+                         globalStack->getUses(),
+                         globalStack->getWorkingSets()};
+    flushProfiles(outputPath + "/sigil.memprofile.out", global);
+}
+
+
+//-----------------------------------------------------------------------------
+/** Option Parsing **/
+namespace
+{
+
+auto parseBlockBits(std::string bytes) -> unsigned
+{
+    Count blockSize = prism::parsePositive(bytes, 64, "MemProfile block size");
+    if ((blockSize & (blockSize - 1)) != 0)
+        fatal("MemProfile block size: must be a power of two");
+    return __builtin_ctzll(blockSize);
+}
+
+
+}; //end namespace
+
+
+auto onParse(Args args) -> void
+{
+    /* only accept short options */
+    std::set<char> options;
+    options.insert('o'); // -o OUTPUT_DIRECTORY
+    options.insert('g'); // -g BLOCK_BYTES
+    options.insert('s'); // -s SAMPLE_RATE
+    options.insert('w'); // -w WINDOW_USES
+    auto matches = prism::parseShortOptions(args, options, "memprofile");
+
+    outputPath = prism::parseOutputPath(matches['o']);
+    blockBits = parseBlockBits(matches['g']);
+    sampleRate = prism::parsePositive(matches['s'], 1, "MemProfile sample rate");
+    window = prism::parsePositive(matches['w'], 1000000, "MemProfile window");
+
+    globalStack = std::make_unique<ReuseStack>(sampleRate, window);
+}
+
+
+auto requirements() -> prism::capabilities
+{
+    using namespace prism;
+    using namespace prism::capability;
+
+    auto caps = initCaps();
+
+    caps[MEMORY]         = availability::enabled;
+    caps[MEMORY_LDST]    = availability::disabled;
+    caps[MEMORY_SIZE]    = availability::enabled;
+    caps[MEMORY_ADDRESS] = availability::enabled;
+
+    caps[COMPUTE]              = availability::disabled;
+    caps[COMPUTE_INT_OR_FLOAT] = availability::disabled;
+    caps[COMPUTE_ARITY]        = availability::disabled;
+    caps[COMPUTE_OP]           = availability::disabled;
+    caps[COMPUTE_SIZE]         = availability::disabled;
+
+    caps[CONTROL_FLOW] = availability::disabled;
+
+    caps[SYNC]      = availability::enabled;
+    caps[SYNC_TYPE] = availability::enabled;
+    caps[SYNC_ARGS] = availability::enabled;
+
+    caps[CONTEXT_INSTRUCTION] = availability::disabled;
+    caps[CONTEXT_BASIC_BLOCK] = availability::disabled;
+    caps[CONTEXT_FUNCTION]    = availability::disabled;
+    caps[CONTEXT_THREAD]      = availability::enabled;
+
+    return caps;
+}
+
+}; //end namespace MemProfile
@@ -0,0 +1,55 @@
+#ifndef MEMPROFILE_H
+#define MEMPROFILE_H
+
+#include "Core/Backends.hpp"
+#include "ReuseStack.hpp"
+#include <map>
+
+namespace MemProfile
+{
+
+auto onParse(Args args) -> void;
+auto onExit() -> void;
+auto requirements() -> prism::capabilities;
+/* Prism hooks */
+
+using TID = SyncID;
+
+class Handler : public BackendIface
+{
+    /* Feeds every memory access, split into blocks, to the current
+     * thread's reuse stack, and to one reuse stack shared by all threads.
+     *
+     * Sampled blocks for the shared stack are batched and handed over
+     * under a lock, so its view of how threads interleave is only as fine
+     * as one batch */
+
+  public:
+    Handler();
+    Handler(const Handler &) = delete;
+    Handler &operator=(const Handler &) = delete;
+    virtual ~Handler() override;
+
+  private:
+    virtual auto onSyncEv(const prism::SyncEvent &ev) -> void override;
+    virtual auto onMemEv(const prism::MemEvent &ev) -> void override;
+
+    auto flushBatch() -> void;
+
+    std::map<TID, std::unique_ptr<ReuseStack>> stacks;
+    ReuseStack *current{nullptr};
+    TID currentTID{0};
+
+    struct Use
+    {
+        Count skipped;
+        Addr block;
+        /* blocks not sampled since the previous use, then the sampled block */
+    };
+    std::vector<Use> batch;
+    Count skipped{0};
+};
+
+}; //end namespace MemProfile
+
+#endif
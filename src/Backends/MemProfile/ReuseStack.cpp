@@ -0,0 +1,131 @@
+#include "ReuseStack.hpp"
+#include <cassert>
+
+namespace MemProfile
+{
+
+namespace
+{
+constexpr uint64_t minCapacity = 1 << 16;
+};
+
+
+ReuseStack::ReuseStack(unsigned sampleRate, Count window)
+    : sampleRate(sampleRate > 0 ? sampleRate : 1)
+    , window(window)
+    , tree(minCapacity + 1, 0)
+    , blockAt(minCapacity + 1, 0)
+{
+    assert(window > 0);
+}
+
+
+auto ReuseStack::use(Addr block) -> void
+{
+    if (now + 1 == tree.size())
+        compact();
+
+    auto &obj = shadow[block];
+    if (obj.lastUse == 0)
+    {
+        histogram.cold += sampleRate;
+    }
+    else
+    {
+        Count distance = marksUpTo(now) - marksUpTo(obj.lastUse);
+        histogram.add(distance * sampleRate, sampleRate);
+        mark(obj.lastUse, -1);
+    }
+
+    /* windows are numbered from 1 so that 0 means unused */
+    uint64_t currentWindow = uses / window + 1;
+    if (obj.lastWindow != currentWindow)
+    {
+        obj.lastWindow = currentWindow;
+        currentSet += sampleRate;
+    }
+
+    ++now;
+    mark(now, 1);
+    blockAt[now] = block;
+    obj.lastUse = now;
+
+    tick();
+}
+
+
+auto ReuseStack::skip(Count count) -> void
+{
+    for (Count i = 0; i < count; ++i)
+        tick();
+}
+
+
+auto ReuseStack::tick() -> void
+{
+    if (++uses % window == 0)
+    {
+        workingSets.push_back(currentSet);
+        currentSet = 0;
+    }
+}
+
+
+auto ReuseStack::getWorkingSets() const -> std::vector<Count>
+{
+    auto sets = workingSets;
+    if (uses % window != 0)
+        sets.push_back(currentSet);
+    return sets;
+}
+
+
+auto ReuseStack::compact() -> void
+{
+    /* renumber the last use of every block, keeping their order;
+     * grow if more than half of the clock is still live */
+    uint64_t live = 0;
+    for (uint64_t t = 1; t <= now; ++t)
+    {
+        auto &obj = shadow[blockAt[t]];
+        if (obj.lastUse == t)
+        {
+            obj.lastUse = ++live;
+            blockAt[live] = blockAt[t];
+        }
+    }
+
+    size_t capacity = tree.size() - 1;
+    while (live > capacity / 2)
+        capacity *= 2;
+    blockAt.resize(capacity + 1);
+
+    /* linear-time Fenwick build, with a mark at every live time */
+    tree.assign(capacity + 1, 0);
+    for (uint64_t t = 1; t <= capacity; ++t)
+    {
+        tree[t] += (t <= live ? 1 : 0);
+        uint64_t parent = t + (t & -t);
+        if (parent <= capacity)
+            tree[parent] += tree[t];
+    }
+    now = live;
+}
+
+
+auto ReuseStack::marksUpTo(uint64_t time) const -> Count
+{
+    Count sum = 0;
+    for (; time > 0; time -= time & -time)
+        sum += tree[time];
+    return sum;
+}
+
+
+auto ReuseStack::mark(uint64_t time, int64_t delta) -> void
+{
+    for (; time < tree.size(); time += time & -time)
+        tree[time] += delta;
+}
+
+}; //end namespace MemProfile
@@ -0,0 +1,113 @@
+#ifndef MEMPROFILE_REUSE_STACK_H
+#define MEMPROFILE_REUSE_STACK_H
+
+#include "SynchroTraceGen/ShadowMemory.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace MemProfile
+{
+
+using Count = uint64_t;
+
+struct ReuseHistogram
+{
+    /* Bucket 0 counts reuses at distance 0 (the same block twice in a row),
+     * bucket i counts distances in [2^(i-1), 2^i).
+     * Distances are in distinct blocks touched between two uses of a block */
+    static constexpr unsigned buckets = 65;
+    std::array<Count, buckets> reuses{};
+
+    Count cold{0};
+    /* first use of a block */
+
+    static auto bucket(Count distance) -> unsigned
+    {
+        return distance == 0 ? 0 : 64 - __builtin_clzll(distance);
+    }
+
+    auto add(Count distance, Count weight) -> void
+    {
+        reuses[bucket(distance)] += weight;
+    }
+
+    auto operator+=(const ReuseHistogram &rhs) -> ReuseHistogram&
+    {
+        for (unsigned i = 0; i < buckets; ++i)
+            reuses[i] += rhs.reuses[i];
+        cold += rhs.cold;
+        return *this;
+    }
+};
+
+
+class ReuseStack
+{
+    /* LRU stack (reuse) distance and working-set size of a stream of
+     * memory blocks.
+     *
+     * Each block remembers the time of its last use, and that time is marked
+     * in a Fenwick tree; the reuse distance of a block is the number of
+     * marks after its last use, found in O(log n). When the clock runs out of
+     * room, live marks are renumbered in order, so the tree stays within
+     * twice the number of distinct blocks seen.
+     *
+     * Blocks are sampled by address hash (1 in 'sampleRate'), and reported
+     * counts and distances are scaled back up by the same factor.
+     * The working set is the number of distinct blocks used in each window
+     * of 'window' uses */
+
+    struct ShadowObject
+    {
+        uint64_t lastUse{0};
+        uint64_t lastWindow{0};
+        /* 0 if never used */
+    };
+
+  public:
+    ReuseStack(unsigned sampleRate, Count window);
+    ReuseStack(const ReuseStack &) = delete;
+    ReuseStack &operator=(const ReuseStack &) = delete;
+
+    static auto sampled(Addr block, unsigned sampleRate) -> bool
+    {
+        /* the same blocks are sampled in every stack */
+        return sampleRate <= 1 || ((block * 0x9E3779B97F4A7C15ULL) >> 40) % sampleRate == 0;
+    }
+
+    auto use(Addr block) -> void;
+    /* use of a sampled block */
+
+    auto skip(Count uses) -> void;
+    /* uses of blocks that were not sampled */
+
+    auto getHistogram() const -> const ReuseHistogram& { return histogram; }
+    auto getUses() const -> Count { return uses; }
+    auto getWorkingSets() const -> std::vector<Count>;
+    /* distinct blocks per window, the last (partial) window included */
+
+  private:
+    auto compact() -> void;
+    auto marksUpTo(uint64_t time) const -> Count;
+    auto mark(uint64_t time, int64_t delta) -> void;
+    auto tick() -> void;
+
+    const unsigned sampleRate;
+    const Count window;
+
+    ShadowMemory<ShadowObject, 38, 20> shadow;
+    std::vector<Count> tree;
+    std::vector<Addr> blockAt;
+    /* Fenwick tree over use times, 1-based, and the block used at each time */
+    uint64_t now{0};
+
+    ReuseHistogram histogram;
+    Count uses{0};
+    std::vector<Count> workingSets;
+    Count currentSet{0};
+};
+
+}; //end namespace MemProfile
+
+#endif
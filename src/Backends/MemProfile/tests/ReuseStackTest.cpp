@@ -0,0 +1,123 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "MemProfile/ReuseStack.hpp"
+#include <algorithm>
+#include <list>
+#include <random>
+#include <set>
+
+using namespace MemProfile;
+
+TEST_CASE("reuse distances", "[ReuseStack]")
+{
+    SECTION("a simple stream")
+    {
+        /* A B C A A B */
+        ReuseStack stack(1, 100);
+        for (Addr block : {1, 2, 3, 1, 1, 2})
+            stack.use(block);
+
+        auto &histogram = stack.getHistogram();
+        REQUIRE(histogram.cold == 3);
+        REQUIRE(histogram.reuses[0] == 1);                        // A A
+        REQUIRE(histogram.reuses[ReuseHistogram::bucket(2)] == 2); // A..A, B..B
+        REQUIRE(stack.getUses() == 6);
+    }
+
+    SECTION("matches a plain LRU stack, across compactions")
+    {
+        /* enough uses to renumber the clock many times */
+        std::mt19937 gen(42);
+        std::geometric_distribution<Addr> near(0.02);
+        std::uniform_int_distribution<Addr> far(0, 300);
+
+        ReuseStack stack(1, 1000);
+        ReuseHistogram expected;
+        std::list<Addr> lru;
+        for (unsigned i = 0; i < 300000; ++i)
+        {
+            Addr block = (i % 7 == 0 ? far(gen) : near(gen));
+            stack.use(block);
+
+            auto it = std::find(lru.begin(), lru.end(), block);
+            if (it == lru.end())
+            {
+                ++expected.cold;
+            }
+            else
+            {
+                expected.add(std::distance(lru.begin(), it), 1);
+                lru.erase(it);
+            }
+            lru.push_front(block);
+        }
+
+        auto &histogram = stack.getHistogram();
+        REQUIRE(histogram.cold == expected.cold);
+        for (unsigned i = 0; i < ReuseHistogram::buckets; ++i)
+            REQUIRE(histogram.reuses[i] == expected.reuses[i]);
+    }
+}
+
+TEST_CASE("working sets and sampling", "[ReuseStack]")
+{
+    SECTION("distinct blocks per window")
+    {
+        ReuseStack stack(1, 4);
+        for (Addr block : {1, 1, 2, 1,  3, 4, 5, 6,  7, 7})
+            stack.use(block);
+
+        auto sets = stack.getWorkingSets();
+        REQUIRE(sets.size() == 3);
+        REQUIRE(sets[0] == 2);
+        REQUIRE(sets[1] == 4);
+        REQUIRE(sets[2] == 1);
+    }
+
+    SECTION("skipped uses still advance the window")
+    {
+        ReuseStack stack(1, 4);
+        stack.use(1);
+        stack.skip(3);
+        stack.use(1);
+        stack.use(2);
+
+        auto sets = stack.getWorkingSets();
+        REQUIRE(sets.size() == 2);
+        REQUIRE(sets[0] == 1);
+        REQUIRE(sets[1] == 2);
+        REQUIRE(stack.getUses() == 6);
+    }
+
+    SECTION("sampled counts are scaled back up")
+    {
+        constexpr unsigned rate = 8;
+        ReuseStack stack(rate, 1 << 20);
+
+        std::set<Addr> sampled;
+        for (unsigned pass = 0; pass < 2; ++pass)
+        {
+            for (Addr block = 0; block < 4096; ++block)
+            {
+                if (ReuseStack::sampled(block, rate) == false)
+                {
+                    stack.skip(1);
+                    continue;
+                }
+                sampled.insert(block);
+                stack.use(block);
+            }
+        }
+
+        /* roughly one in eight blocks, and each reuse is a full pass apart */
+        REQUIRE(sampled.size() > 4096 / rate / 2);
+        REQUIRE(sampled.size() < 4096 / rate * 2);
+
+        auto &histogram = stack.getHistogram();
+        REQUIRE(histogram.cold == sampled.size() * rate);
+        auto distance = (sampled.size() - 1) * rate;
+        REQUIRE(histogram.reuses[ReuseHistogram::bucket(distance)] == sampled.size() * rate);
+        REQUIRE(stack.getUses() == 2 * 4096);
+    }
+}
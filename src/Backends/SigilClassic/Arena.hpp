@@ -0,0 +1,60 @@
+#ifndef SC_ARENA_H
+#define SC_ARENA_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace SigilClassic
+{
+
+/* Bump allocator for records that live until exit, e.g. one per function call.
+ *
+ * Objects are default-constructed a chunk at a time, so allocating one is
+ * usually a pointer increment; pointers stay valid until the arena is destroyed */
+template <typename T, size_t CHUNK = 1024>
+class Arena
+{
+  public:
+    /* 'n' contiguous objects */
+    auto allocate(size_t n = 1) -> T*
+    {
+        if (chunks.empty() == true || chunks.back().used + n > chunks.back().size)
+        {
+            size_t size = std::max(n, CHUNK);
+            chunks.push_back(Chunk{std::unique_ptr<T[]>(new T[size]), size, 0});
+        }
+
+        Chunk &chunk = chunks.back();
+        T *ret = chunk.data.get() + chunk.used;
+        chunk.used += n;
+        allocated += n;
+        return ret;
+    }
+
+    auto size() const -> size_t { return allocated; }
+
+    /* visits every allocated object, in allocation order */
+    template <typename F>
+    auto forEach(F f) const -> void
+    {
+        for (auto &chunk : chunks)
+            for (size_t i = 0; i < chunk.used; ++i)
+                f(chunk.data[i]);
+    }
+
+  private:
+    struct Chunk
+    {
+        std::unique_ptr<T[]> data;
+        size_t size;
+        size_t used;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t allocated{0};
+};
+
+}; //end namespace SigilClassic
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef SC_FLATMAP_H
+#define SC_FLATMAP_H
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace SigilClassic
+{
+
+/* Open-addressing hash map for integer keys, with linear probing.
+ *
+ * Keys and values are stored inline in one array, so a lookup touches
+ * one or two cache lines and no memory is allocated until the first insert.
+ * Elements are never erased. 'EMPTY' marks unused slots and cannot be a key. */
+template <typename Key, typename Value, Key EMPTY = std::numeric_limits<Key>::min()>
+class FlatMap
+{
+  public:
+    using Slot = std::pair<Key, Value>;
+
+    auto operator[](Key key) -> Value&;
+    auto find(Key key) -> Value*;
+    auto find(Key key) const -> const Value*;
+    auto size() const -> size_t { return used; }
+
+    /* visits every (key, value) pair, in no particular order */
+    template <typename F>
+    auto forEach(F f) const -> void
+    {
+        for (auto &slot : slots)
+            if (slot.first != EMPTY)
+                f(slot.first, slot.second);
+    }
+
+  private:
+    static constexpr size_t MIN_CAPACITY{8};
+
+    auto probe(Key key) const -> size_t;
+    auto grow() -> void;
+
+    std::vector<Slot> slots;
+    size_t used{0};
+};
+
+
+template <typename Key, typename Value, Key EMPTY>
+inline auto FlatMap<Key, Value, EMPTY>::probe(Key key) const -> size_t
+{
+    /* Fibonacci hashing spreads consecutive keys, e.g. entity IDs;
+     * returns the slot holding 'key', or the empty slot where it belongs */
+    size_t mask = slots.size() - 1;
+    size_t i = (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL) >> 32 & mask;
+    while (slots[i].first != key && slots[i].first != EMPTY)
+        i = (i + 1) & mask;
+    return i;
+}
+
+
+template <typename Key, typename Value, Key EMPTY>
+inline auto FlatMap<Key, Value, EMPTY>::find(Key key) -> Value*
+{
+    if (used == 0)
+        return nullptr;
+
+    Slot &slot = slots[probe(key)];
+    return slot.first == key ? &slot.second : nullptr;
+}
+
+
+template <typename Key, typename Value, Key EMPTY>
+inline auto FlatMap<Key, Value, EMPTY>::find(Key key) const -> const Value*
+{
+    return const_cast<FlatMap*>(this)->find(key);
+}
+
+
+template <typename Key, typename Value, Key EMPTY>
+inline auto FlatMap<Key, Value, EMPTY>::operator[](Key key) -> Value&
+{
+    /* keep the table at most half full, so probe sequences stay short */
+    if ((used + 1) * 2 > slots.size())
+        grow();
+
+    Slot &slot = slots[probe(key)];
+    if (slot.first == EMPTY)
+    {
+        slot.first = key;
+        ++used;
+    }
+    return slot.second;
+}
+
+
+template <typename Key, typename Value, Key EMPTY>
+inline auto FlatMap<Key, Value, EMPTY>::grow() -> void
+{
+    size_t capacity = slots.empty() ? MIN_CAPACITY : slots.size() * 2;
+    std::vector<Slot> old(capacity, Slot{EMPTY, Value{}});
+    old.swap(slots);
+
+    for (auto &slot : old)
+        if (slot.first != EMPTY)
+            slots[probe(slot.first)] = std::move(slot);
+}
+
+}; //end namespace SigilClassic
+
+#endif
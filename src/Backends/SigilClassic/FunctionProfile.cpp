@@ -0,0 +1,270 @@
+#include "FunctionProfile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+namespace SigilClassic
+{
+
+namespace
+{
+
+using Totals = FlatMap<SymID, FunctionTotals, INVL_SYM>;
+using FilePtr = std::unique_ptr<FILE, int(*)(FILE*)>;
+
+
+template <typename F>
+auto parallelFor(size_t n, F f) -> void
+{
+    /* one worker per core, each taking the next index until none are left */
+    std::atomic<size_t> next{0};
+    auto work = [&]
+    {
+        for (size_t i = next++; i < n; i = next++)
+            f(i);
+    };
+
+    size_t workers = std::min<size_t>(n, std::max(1U, std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; ++i)
+        threads.emplace_back(work);
+    work();
+    for (auto &t : threads)
+        t.join();
+}
+
+
+auto aggregateThread(const TContext &tcxt, const std::vector<SymID> &translate,
+                     const std::vector<SymID> &names) -> Totals
+{
+    /* 'names' maps each entity ID, of any context, to its function;
+     * 'translate' maps this thread's own symbols to the same table */
+    auto functionOf = [&](EID eid)
+    {
+        return (eid >= 0 && static_cast<size_t>(eid) < names.size()) ? names[eid] : ROOT_SYM;
+    };
+
+    Totals totals;
+    tcxt.entity_data.forEach([&](const EntityData &entity)
+    {
+        SymID name = translate[entity.name];
+
+        /* the entity for events outside any function was not called */
+        if (entity.eid != INVL_EID)
+            ++totals[functionOf(entity.caller)].callees[name];
+
+        FunctionTotals &fn = totals[name];
+        if (entity.eid != INVL_EID)
+            ++fn.calls;
+        fn.iops += entity.iops;
+        fn.flops += entity.flops;
+        fn.local_bytes_read += entity.local_bytes_read;
+        entity.comm_edges.forEach([&](EID writer, UInt bytes)
+        {
+            fn.comm_bytes[functionOf(writer)] += bytes;
+        });
+    });
+    return totals;
+}
+
+
+auto csvName(const char *name) -> std::string
+{
+    /* function names often have commas, e.g. C++ templates */
+    std::string ret{'"'};
+    for (; *name != '\0'; ++name)
+    {
+        if (*name == '"')
+            ret += '"';
+        ret += *name;
+    }
+    return ret + '"';
+}
+
+
+auto dotEscape(const char *name) -> std::string
+{
+    std::string ret;
+    for (; *name != '\0'; ++name)
+    {
+        if (*name == '"' || *name == '\\')
+            ret += '\\';
+        ret += *name;
+    }
+    return ret;
+}
+
+
+auto dotName(const char *name) -> std::string
+{
+    return '"' + dotEscape(name) + '"';
+}
+
+}; //end namespace
+
+
+FunctionProfile::FunctionProfile(const std::vector<ContextEntities> &contexts)
+{
+    struct Task
+    {
+        const TContext *tcxt;
+        const std::vector<SymID> *translate;
+        Totals totals;
+    };
+
+    /* every context's symbols, under one table */
+    std::vector<std::vector<SymID>> translate(contexts.size());
+    std::vector<Task> tasks;
+    EID last_eid{INVL_EID};
+    for (size_t i = 0; i < contexts.size(); ++i)
+    {
+        for (SymID id = 0; id < contexts[i].symbols.size(); ++id)
+            translate[i].push_back(symbols.intern(contexts[i].symbols.name(id)));
+        for (auto &p : contexts[i].thread_contexts)
+            tasks.push_back(Task{&p.second, &translate[i], {}});
+        last_eid = std::max(last_eid, contexts[i].last_eid);
+    }
+
+    /* Entity IDs are unique across SigilContexts, which share shadow memory,
+     * so a writer from another context is still matched to its function and
+     * each thread fills in a disjoint set of names */
+    std::vector<SymID> names(last_eid + 1, ROOT_SYM);
+    parallelFor(tasks.size(), [&](size_t i)
+    {
+        tasks[i].tcxt->entity_data.forEach([&](const EntityData &entity)
+        {
+            if (entity.eid != INVL_EID)
+                names[entity.eid] = (*tasks[i].translate)[entity.name];
+        });
+    });
+
+    parallelFor(tasks.size(), [&](size_t i)
+    {
+        tasks[i].totals = aggregateThread(*tasks[i].tcxt, *tasks[i].translate, names);
+    });
+
+    /* the totals are per function, so merging is cheap next to aggregating */
+    for (auto &task : tasks)
+    {
+        task.totals.forEach([&](SymID fn, const FunctionTotals &totals)
+        {
+            merge(totals, fn);
+        });
+    }
+}
+
+
+auto FunctionProfile::merge(const FunctionTotals &from, SymID fn) -> void
+{
+    FunctionTotals &to = functions[fn];
+    to.calls += from.calls;
+    to.iops += from.iops;
+    to.flops += from.flops;
+    to.local_bytes_read += from.local_bytes_read;
+    from.comm_bytes.forEach([&](SymID producer, Count bytes)
+    {
+        to.comm_bytes[producer] += bytes;
+    });
+    from.callees.forEach([&](SymID callee, Count calls)
+    {
+        to.callees[callee] += calls;
+    });
+}
+
+
+auto FunctionProfile::sorted() const -> std::vector<SymID>
+{
+    std::vector<SymID> ret;
+    functions.forEach([&](SymID fn, const FunctionTotals &) { ret.push_back(fn); });
+    std::sort(ret.begin(), ret.end(), [&](SymID l, SymID r)
+    {
+        return std::strcmp(symbols.name(l), symbols.name(r)) < 0;
+    });
+    return ret;
+}
+
+
+auto FunctionProfile::writeFunctions(const std::string &path) const -> bool
+{
+    FilePtr file(fopen(path.c_str(), "w"), fclose);
+    if (file == nullptr ||
+        fputs("function,calls,iops,flops,local_bytes_read,comm_bytes_read\n", file.get()) < 0)
+        return false;
+
+    for (auto fn : sorted())
+    {
+        auto &totals = *functions.find(fn);
+        Count comm{0};
+        totals.comm_bytes.forEach([&](SymID, Count bytes) { comm += bytes; });
+
+        if (fprintf(file.get(), "%s,%llu,%llu,%llu,%llu,%llu\n",
+                    csvName(symbols.name(fn)).c_str(),
+                    static_cast<unsigned long long>(totals.calls),
+                    static_cast<unsigned long long>(totals.iops),
+                    static_cast<unsigned long long>(totals.flops),
+                    static_cast<unsigned long long>(totals.local_bytes_read),
+                    static_cast<unsigned long long>(comm)) < 0)
+            return false;
+    }
+    return true;
+}
+
+
+auto FunctionProfile::writeComm(const std::string &path) const -> bool
+{
+    FilePtr file(fopen(path.c_str(), "w"), fclose);
+    if (file == nullptr || fputs("producer,consumer,bytes\n", file.get()) < 0)
+        return false;
+
+    bool ok = true;
+    for (auto fn : sorted())
+    {
+        std::string consumer = csvName(symbols.name(fn));
+        functions.find(fn)->comm_bytes.forEach([&](SymID producer, Count bytes)
+        {
+            ok &= fprintf(file.get(), "%s,%s,%llu\n",
+                          csvName(symbols.name(producer)).c_str(), consumer.c_str(),
+                          static_cast<unsigned long long>(bytes)) >= 0;
+        });
+    }
+    return ok;
+}
+
+
+auto FunctionProfile::writeDot(const std::string &path) const -> bool
+{
+    FilePtr file(fopen(path.c_str(), "w"), fclose);
+    if (file == nullptr || fputs("digraph functions {\n", file.get()) < 0)
+        return false;
+
+    bool ok = true;
+    for (auto fn : sorted())
+    {
+        auto &totals = *functions.find(fn);
+        std::string name = dotName(symbols.name(fn));
+        ok &= fprintf(file.get(), "  %s [label=\"%s\\ncalls %llu, iops %llu, flops %llu\"];\n",
+                      name.c_str(), dotEscape(symbols.name(fn)).c_str(),
+                      static_cast<unsigned long long>(totals.calls),
+                      static_cast<unsigned long long>(totals.iops),
+                      static_cast<unsigned long long>(totals.flops)) >= 0;
+
+        totals.callees.forEach([&](SymID callee, Count calls)
+        {
+            ok &= fprintf(file.get(), "  %s -> %s [label=\"%llu\"];\n",
+                          name.c_str(), dotName(symbols.name(callee)).c_str(),
+                          static_cast<unsigned long long>(calls)) >= 0;
+        });
+        totals.comm_bytes.forEach([&](SymID producer, Count bytes)
+        {
+            ok &= fprintf(file.get(), "  %s -> %s [style=dashed label=\"%llu B\"];\n",
+                          dotName(symbols.name(producer)).c_str(), name.c_str(),
+                          static_cast<unsigned long long>(bytes)) >= 0;
+        });
+    }
+    return ok && fputs("}\n", file.get()) >= 0;
+}
+
+}; //end namespace SigilClassic
@@ -0,0 +1,71 @@
+#ifndef SC_FUNCTIONPROFILE_H
+#define SC_FUNCTIONPROFILE_H
+
+#include "SigilClassic.hpp"
+#include <string>
+#include <vector>
+
+namespace SigilClassic
+{
+
+using Count = uint64_t;
+
+
+/* Entities recorded by one SigilContext, kept until exit;
+ * 'last_eid' is the greatest entity ID the context handed out */
+struct ContextEntities
+{
+    SymbolTable symbols;
+    std::unordered_map<TID, TContext> thread_contexts;
+    EID last_eid{INVL_EID};
+};
+
+
+/* Totals over every call of one function */
+struct FunctionTotals
+{
+    Count calls{0};
+    Count iops{0};
+    Count flops{0};
+    Count local_bytes_read{0};
+
+    /* Unique bytes read, by the function that last wrote them;
+     * memory not written by any traced function is from ROOT_SYM */
+    FlatMap<SymID, Count, INVL_SYM> comm_bytes;
+
+    /* Calls made, by callee */
+    FlatMap<SymID, Count, INVL_SYM> callees;
+};
+
+
+class FunctionProfile
+{
+    /* Rolls every call of every thread up into per-function totals.
+     *
+     * Functions are matched by name across contexts, under one symbol
+     * table; each thread context is then aggregated on its own worker
+     * and the per-thread totals are merged */
+  public:
+    FunctionProfile(const std::vector<ContextEntities> &contexts);
+
+    /* function,calls,iops,flops,local_bytes_read,comm_bytes_read */
+    auto writeFunctions(const std::string &path) const -> bool;
+
+    /* producer,consumer,bytes */
+    auto writeComm(const std::string &path) const -> bool;
+
+    /* call edges solid, labelled by calls,
+     * communication edges dashed, labelled by bytes */
+    auto writeDot(const std::string &path) const -> bool;
+
+  private:
+    auto merge(const FunctionTotals &from, SymID fn) -> void;
+    auto sorted() const -> std::vector<SymID>;
+
+    SymbolTable symbols;
+    FlatMap<SymID, FunctionTotals, INVL_SYM> functions;
+};
+
+}; //end namespace SigilClassic
+
+#endif
@@ -1,8 +1,27 @@
 #include "Handler.hpp"
+#include "Utils/BackendOptions.hpp"
+#include "Utils/PrismLog.hpp"
+#include <map>
+#include <set>
 
+using namespace PrismLog; // console logging
 namespace SigilClassic
 {
 
+/* Global to all threads */
+namespace
+{
+std::string outputPath{"."};
+}; //end namespace
+
+
+Handler::Handler(BackendContext &context)
+    : shared(static_cast<Shared&>(context))
+    , cxt(shared.state)
+{
+}
+
+
 auto Handler::onSyncEv(const prism::SyncEvent &ev) -> void
 {
     /* save the current entity so that it can
@@ -53,4 +72,85 @@ auto Handler::onCxtEv(const prism::CxtEvent &ev) -> void
 }
 
 
+//-----------------------------------------------------------------------------
+/** Flush final stats and data **/
+Handler::~Handler()
+{
+    /* keep the entities until every handler is done;
+     * their IDs stay in the shared shadow memory */
+    std::lock_guard<std::mutex> lock(shared.mtx);
+    shared.finished.push_back(ContextEntities{std::move(cxt.symbols),
+                                       std::move(cxt.thread_contexts),
+                                       cxt.last_eid});
+}
+
+
+auto onExit(BackendContext &context) -> void
+{
+    auto &shared = static_cast<Shared&>(context);
+    std::lock_guard<std::mutex> lock(shared.mtx);
+
+    FunctionProfile profile(shared.finished);
+    shared.finished.clear();
+
+    std::string functionsPath = outputPath + "/sigil.functions.csv";
+    std::string commPath = outputPath + "/sigil.functions.comm.csv";
+    std::string dotPath = outputPath + "/sigil.functions.dot";
+    info("Flushing function profile to: " + functionsPath);
+
+    if (profile.writeFunctions(functionsPath) == false)
+        fatal("writing function profile: " + functionsPath);
+    if (profile.writeComm(commPath) == false)
+        fatal("writing function communication: " + commPath);
+    if (profile.writeDot(dotPath) == false)
+        fatal("writing function graph: " + dotPath);
+}
+
+
+//-----------------------------------------------------------------------------
+/** Option Parsing **/
+auto onParse(Args args) -> void
+{
+    /* only accept short options */
+    std::set<char> options;
+    options.insert('o'); // -o OUTPUT_DIRECTORY
+    auto matches = prism::parseShortOptions(args, options, "sigilclassic");
+
+    outputPath = prism::parseOutputPath(matches['o']);
+}
+
+
+auto requirements() -> prism::capabilities
+{
+    using namespace prism;
+    using namespace prism::capability;
+
+    auto caps = initCaps();
+
+    caps[MEMORY]         = availability::enabled;
+    caps[MEMORY_LDST]    = availability::enabled;
+    caps[MEMORY_SIZE]    = availability::enabled;
+    caps[MEMORY_ADDRESS] = availability::enabled;
+
+    caps[COMPUTE]              = availability::enabled;
+    caps[COMPUTE_INT_OR_FLOAT] = availability::enabled;
+    caps[COMPUTE_ARITY]        = availability::disabled;
+    caps[COMPUTE_OP]           = availability::disabled;
+    caps[COMPUTE_SIZE]         = availability::disabled;
+
+    caps[CONTROL_FLOW] = availability::disabled;
+
+    caps[SYNC]      = availability::enabled;
+    caps[SYNC_TYPE] = availability::enabled;
+    caps[SYNC_ARGS] = availability::enabled;
+
+    caps[CONTEXT_INSTRUCTION] = availability::disabled;
+    caps[CONTEXT_BASIC_BLOCK] = availability::disabled;
+    caps[CONTEXT_FUNCTION]    = availability::enabled;
+    caps[CONTEXT_THREAD]      = availability::enabled;
+
+    return caps;
+}
+
+
 }; //end namespace SigilClassic
@@ -2,19 +2,43 @@
 #define SIGILCLASSIC_HANDLER_H
 
 #include "Core/Backends.hpp"
-#include "SigilClassic.hpp"
+#include "FunctionProfile.hpp"
+#include <mutex>
 
 namespace SigilClassic
 {
 
+struct Shared : public BackendContext
+{
+    SharedState state;
+    /* every handler's context reads and writes the same shadow memory */
+
+    std::mutex mtx;
+    std::vector<ContextEntities> finished;
+    /* each handler's entities, kept until every handler is done */
+};
+
+auto onParse(Args args) -> void;
+auto onExit(BackendContext &context) -> void;
+auto requirements() -> prism::capabilities;
+/* Prism hooks */
+
 /* interface to Sigil2 */
 class Handler : public BackendIface
 {
+  public:
+    Handler(BackendContext &context);
+    Handler(const Handler &) = delete;
+    Handler &operator=(const Handler &) = delete;
+    virtual ~Handler() override;
+
+  private:
     virtual auto onSyncEv(const prism::SyncEvent &ev) -> void override;
     virtual auto onCompEv(const prism::CompEvent &ev) -> void override;
     virtual auto onMemEv(const prism::MemEvent &ev) -> void override;
     virtual auto onCxtEv(const prism::CxtEvent &ev) -> void override;
 
+    Shared &shared;
     SigilContext cxt;
 };
 
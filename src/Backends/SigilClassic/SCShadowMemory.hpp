@@ -2,6 +2,7 @@
 #define SC_SHADOWMEMORY_H
 
 #include "ShadowMemory.hpp"
+#include <algorithm>
 
 namespace SigilClassic
 {
@@ -28,27 +29,48 @@ class SCShadowMemory
         FID last_reader{SO_UNDEF}; //Last function to read addr
     };
 
+    /* Calls f(ShadowObject *objects, ByteCount count) for each run of
+     * the access that shares a secondary map, so a whole access
+     * is usually handled with one primary map lookup */
+    template <typename F>
+    auto forEachSpan(Addr addr, ByteCount bytes, F f) -> void;
+
     ShadowMemory<ShadowObject, 45, 28> sm;
 };
 
-inline auto SCShadowMemory::updateWriter(Addr addr, ByteCount bytes, FID fid) -> void
+
+template <typename F>
+inline auto SCShadowMemory::forEachSpan(Addr addr, ByteCount bytes, F f) -> void
 {
-    for (ByteCount i = 0; i < bytes; ++i)
+    while (bytes > 0)
     {
-        ShadowObject &so = sm[addr + i];
-        so.last_writer = fid;
-        so.last_reader = SO_UNDEF; // Reset readers on new write
+        ByteCount count = std::min<Addr>(bytes, sm.contiguous(addr));
+        f(&sm[addr], count);
+        addr += count;
+        bytes -= count;
     }
 }
 
+inline auto SCShadowMemory::updateWriter(Addr addr, ByteCount bytes, FID fid) -> void
+{
+    forEachSpan(addr, bytes, [fid](ShadowObject *so, ByteCount count)
+    {
+        for (ByteCount i = 0; i < count; ++i)
+        {
+            so[i].last_writer = fid;
+            so[i].last_reader = SO_UNDEF; // Reset readers on new write
+        }
+    });
+}
+
 
 inline auto SCShadowMemory::updateReader(Addr addr, ByteCount bytes, FID fid) -> void
 {
-    for (ByteCount i = 0; i < bytes; ++i)
+    forEachSpan(addr, bytes, [fid](ShadowObject *so, ByteCount count)
     {
-        ShadowObject &so = sm[addr + i];
-        so.last_reader = fid;
-    }
+        for (ByteCount i = 0; i < count; ++i)
+            so[i].last_reader = fid;
+    });
 }
 
 
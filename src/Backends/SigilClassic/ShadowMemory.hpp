@@ -4,10 +4,13 @@
 #include "Core/Primitive.h" // PtrVal type
 #include "Utils/PrismLog.hpp"
 
+#include <atomic>
 #include <limits>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <sys/mman.h>
 
 /* Shadow Memory tracks 'shadow state' for an address.
  * For further clarification, please read,
@@ -19,7 +22,10 @@ using Addr = PtrVal;
 using PrismLog::fatal;
 using PrismLog::warn;
 
-/* XXX: Setting {addr, pm} bits too large can cause bad_alloc errors */
+/* The primary map is only reserved, not committed: pages of it are backed
+ * as secondary maps are created, so a large PM_BITS costs address space only.
+ * Secondary maps are created at most once, so the shadow can be shared
+ * between threads; updates to shadow objects are not synchronized. */
 template <typename SO, unsigned ADDR_BITS = 38, unsigned PM_BITS = 16>
 class ShadowMemory
 {
@@ -34,8 +40,17 @@ class ShadowMemory
         , sm_bits(addr_bits - pm_bits)
         , pm_size(1ULL << pm_bits)
         , sm_size(1ULL << sm_bits)
-        , pm(pm_size)
-    {}
+    {
+        void *map = mmap(nullptr, pm_size * sizeof(*pm), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (map == MAP_FAILED)
+            fatal("shadow memory: could not reserve primary map");
+        pm = static_cast<std::atomic<SecondaryMap*>*>(map); /* zeroed, i.e. null */
+    }
+    ~ShadowMemory()
+    {
+        munmap(pm, pm_size * sizeof(*pm));
+    }
     ShadowMemory(const ShadowMemory &) = delete;
     ShadowMemory &operator=(const ShadowMemory &) = delete;
 
@@ -48,15 +63,17 @@ class ShadowMemory
 
     /* Implementation */
     using SecondaryMap = std::vector<SO>;
-    using PrimaryMap = std::vector<std::unique_ptr<SecondaryMap>>;
+    static_assert(ATOMIC_POINTER_LOCK_FREE == 2,
+                  "the primary map must be usable as zeroed memory");
 
     auto operator[](Addr addr) -> SO&
     {
         if ((addr >> addr_bits) == 0)
         {
-            auto &ptr = pm[addr >> sm_bits]; /* PM offset */
+            auto &slot = pm[addr >> sm_bits]; /* PM offset */
+            SecondaryMap *ptr = slot.load(std::memory_order_acquire);
             if (ptr == nullptr)
-                ptr = std::make_unique<SecondaryMap>(sm_size);
+                ptr = create(slot);
 
             return (*ptr)[addr & ((1ULL << sm_bits) - 1)]; /* SM offset */
         }
@@ -74,8 +91,31 @@ class ShadowMemory
         }
     }
 
+    /* Objects from 'addr' onwards that share its secondary map,
+     * so they are contiguous in memory */
+    auto contiguous(Addr addr) const -> Addr
+    {
+        return sm_size - (addr & (sm_size - 1));
+    }
+
   private:
-    PrimaryMap pm;
+    auto create(std::atomic<SecondaryMap*> &slot) -> SecondaryMap*
+    {
+        /* another thread may have created the same map */
+        std::lock_guard<std::mutex> lock(mtx);
+        SecondaryMap *ptr = slot.load(std::memory_order_relaxed);
+        if (ptr == nullptr)
+        {
+            sms.push_back(std::make_unique<SecondaryMap>(sm_size));
+            ptr = sms.back().get();
+            slot.store(ptr, std::memory_order_release);
+        }
+        return ptr;
+    }
+
+    std::atomic<SecondaryMap*> *pm;
+    std::vector<std::unique_ptr<SecondaryMap>> sms;
+    std::mutex mtx;
 
 };
 
@@ -1,29 +1,21 @@
 #include "SigilClassic.hpp"
 #include "Utils/PrismLog.hpp"
 
-/* XXX overflow builtin not in GCC <5.
- * This overflow check should only be used for
- * variables which increment by 1 each time. */
-#if __GNUC__ >= 5
-#define INCR_EID_OVERFLOW(var) __builtin_add_overflow(var, 1, &var)
-#else
-#define INCR_EID_OVERFLOW(var) (var == INT_MAX ? true : (var += 1) && false)
-#endif
-
-
 namespace SigilClassic
 {
 
-
-SigilContext::SigilContext()
+TContext::TContext()
 {
-    setThreadContext(0);
-    enterEntity("__BEGINNING_OF_SIGIL__");
+    callstack.push_back(entity_data.allocate());
+    callstack.back()->name = ROOT_SYM;
 }
 
-SigilContext::~SigilContext()
+
+SigilContext::SigilContext(SharedState &shared)
+    : shared(shared)
 {
-    /* TODO Print out stats */
+    setThreadContext(0);
+    enterEntity("__BEGINNING_OF_SIGIL__");
 }
 
 auto SigilContext::setThreadContext(TID tid) -> void
@@ -32,69 +24,85 @@ auto SigilContext::setThreadContext(TID tid) -> void
     {
         cur_tcxt = &thread_contexts[tid];
 
-        cur_eid         = &cur_tcxt->cur_eid;
-        cur_entity_ids  = &cur_tcxt->entity_ids;
-        cur_entity_data = &cur_tcxt->entity_data;
-        cur_callstack   = &cur_tcxt->callstack;
-        cur_entity      = &(*cur_entity_data)[*cur_eid];
+        cur_callstack = &cur_tcxt->callstack;
+        cur_entity    = cur_callstack->back();
 
         cur_tid = tid;
     }
 }
 
 
-auto SigilContext::enterEntity(std::string name) -> void
+auto SigilContext::enterEntity(const char *name) -> void
 {
-    /* Initialize new metadata in map, and set name */
+    /* Initialize new metadata in the arena, and set name */
 
     /* count is not bounded, error if too many functions */
-    if(INCR_EID_OVERFLOW(global_eid_cnt))
+    EID eid = shared.next_eid.fetch_add(1, std::memory_order_relaxed);
+    if(eid < 0 || eid == std::numeric_limits<EID>::max())
         PrismLog::fatal("SigilClassic detected overflow in entity count");
+    last_eid = eid;
 
-    EID caller = *cur_eid;
-    *cur_eid = global_eid_cnt;
-
-    auto it = cur_entity_ids->emplace(name, *cur_eid);
-    auto p  = cur_entity_data->emplace(*cur_eid, EntityData{});
+    EID caller = cur_entity->eid;
 
-    cur_entity         = &p.first->second;
-    cur_entity->name   = &it->first;
+    cur_entity         = cur_tcxt->entity_data.allocate();
+    cur_entity->eid    = eid;
+    cur_entity->name   = symbols.intern(name);
     cur_entity->caller = caller;
 
-    cur_callstack->push(*cur_eid);
+    cur_callstack->push_back(cur_entity);
 }
 
 
 auto SigilContext::exitEntity() -> void
 {
-    cur_callstack->pop();
-    *cur_eid = cur_callstack->top();
+    /* an exit without a matching entry, e.g. from a function entered
+     * before tracing started, stays in the outermost entity */
+    if(cur_callstack->size() > 1)
+        cur_callstack->pop_back();
+    cur_entity = cur_callstack->back();
 }
 
 
 auto SigilContext::monitorWrite(Addr addr, ByteCount bytes) -> void
 {
-    for(int i = 0; i < bytes; ++i)
-    {
-        auto cur_addr = addr + i;
-        sm.updateWriter(cur_addr, 1, *cur_eid);
-    }
+    shared.sm.updateWriter(addr, bytes, cur_entity->eid);
 }
 
 
 auto SigilContext::monitorRead(Addr addr, ByteCount bytes) -> void
 {
-    for(int i = 0; i < bytes; ++i)
+    /* Bytes of one access are usually written by the same entity,
+     * so communication is counted per run of bytes from one writer */
+    EID eid = cur_entity->eid;
+    FID writer = SO_UNDEF;
+    UInt comm = 0;
+    UInt local = 0;
+
+    shared.sm.forEachSpan(addr, bytes, [&](SCShadowMemory::ShadowObject *so, ByteCount count)
     {
-        auto cur_addr = addr + i;
-        auto writer = sm.getWriterFID(cur_addr);
-
-        if/*local*/((writer == *cur_eid) ||
-                    sm.isReaderFID(cur_addr, *cur_eid))
-            cur_entity->local_bytes_read++;
-        else/*unique*/
-            cur_entity->comm_edges[writer]++;
-    }
+        for(ByteCount i = 0; i < count; ++i)
+        {
+            if/*local*/((so[i].last_writer == eid) || (so[i].last_reader == eid))
+            {
+                ++local;
+            }
+            else/*unique*/
+            {
+                if(comm > 0 && so[i].last_writer != writer)
+                {
+                    cur_entity->comm_edges[writer] += comm;
+                    comm = 0;
+                }
+                writer = so[i].last_writer;
+                ++comm;
+                so[i].last_reader = eid;
+            }
+        }
+    });
+
+    if(comm > 0)
+        cur_entity->comm_edges[writer] += comm;
+    cur_entity->local_bytes_read += local;
 }
 
 
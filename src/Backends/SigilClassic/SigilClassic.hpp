@@ -1,12 +1,15 @@
 #ifndef SIGILCLASSIC_H
 #define SIGILCLASSIC_H
 
+#include <atomic>
 #include <unordered_map>
-#include <stack>
-#include <string>
+#include <vector>
 #include <cstdint>
 
 #include "SCShadowMemory.hpp"
+#include "SymbolTable.hpp"
+#include "FlatMap.hpp"
+#include "Arena.hpp"
 #include "Core/Primitive.h"
 
 namespace SigilClassic
@@ -27,15 +30,18 @@ using TID = Int;
 constexpr TID INVL_TID{-1};
 
 
-/* Keeps track of entity metadata */
+/* Keeps track of entity metadata, one per call */
 struct EntityData
 {
+    EID eid{INVL_EID};
+
     /* The same function name may be called many times.
-     * Save some space by pointing to the name */
-    const std::string *name{nullptr};
+     * Save some space by pointing to the interned name */
+    SymID name{INVL_SYM};
 
-    /* Unique communication between entities */
-    std::unordered_map<EID, UInt> comm_edges;
+    /* Unique communication between entities;
+     * the producer may be SO_UNDEF, so INT_MIN marks empty slots */
+    FlatMap<EID, UInt> comm_edges;
 
     /* Bytes read, that are written by this same entity */
     UInt local_bytes_read{0};
@@ -52,17 +58,32 @@ struct EntityData
 /* Keeps track of state between thread context switches */
 struct TContext
 {
-    std::unordered_multimap<std::string, EID> entity_ids;
-    std::unordered_map<EID, EntityData> entity_data;
-    std::stack<EID> callstack;
-    EID cur_eid{INVL_EID};
+    TContext();
+
+    Arena<EntityData> entity_data;
+    /* every entity entered by this thread, and the
+     * entity for events outside any function, first */
+
+    std::vector<EntityData*> callstack;
+    /* never empty; the current entity is at the back */
+};
+
+
+/* State every context of one run shares,
+ * whichever consumer thread handles it */
+struct SharedState
+{
+    SCShadowMemory sm;
+    /* so reads are attributed to writers from other event streams */
+
+    std::atomic<EID> next_eid{0};
+    /* so entity IDs are unique in shadow memory */
 };
 
 
 struct SigilContext
 {
-    SigilContext();
-    ~SigilContext();
+    SigilContext(SharedState &shared);
 
     /* Reset all the contexts to that of 'tid'.
      * Necessary because an entity (e.g. function) can be
@@ -71,7 +92,7 @@ struct SigilContext
 
     /* Beginning or end marker of a entity.
      * Creates or destroys new metadata for the entity */
-    auto enterEntity(std::string name) -> void;
+    auto enterEntity(const char *name) -> void;
     auto exitEntity() -> void;
 
     auto monitorWrite(Addr addr, ByteCount bytes) -> void;
@@ -80,18 +101,17 @@ struct SigilContext
     auto incrFLOPCost() -> void;
 
 
-    SCShadowMemory sm;
+    SharedState &shared;
+
+    SymbolTable symbols;
     std::unordered_map<TID, TContext> thread_contexts;
 
     TID cur_tid{INVL_TID};
-    EID global_eid_cnt{INVL_EID};
+    EID last_eid{INVL_EID};
     TContext *cur_tcxt;
 
     /* cache tcontext */
-    decltype(TContext::cur_eid)     *cur_eid{nullptr};
-    decltype(TContext::entity_ids)  *cur_entity_ids{nullptr};
-    decltype(TContext::entity_data) *cur_entity_data{nullptr};
-    decltype(TContext::callstack)   *cur_callstack{nullptr};
+    decltype(TContext::callstack) *cur_callstack{nullptr};
     EntityData *cur_entity{nullptr};
 };
 
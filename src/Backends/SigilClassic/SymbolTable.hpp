@@ -0,0 +1,106 @@
+#ifndef SC_SYMBOLTABLE_H
+#define SC_SYMBOLTABLE_H
+
+#include "Arena.hpp"
+#include "SCShadowMemory.hpp"
+#include <cstring>
+#include <vector>
+
+namespace SigilClassic
+{
+
+/* Interned function name */
+using SymID = UInt;
+constexpr SymID INVL_SYM{std::numeric_limits<SymID>::max()};
+constexpr SymID ROOT_SYM{0};
+constexpr const char *ROOT_NAME{"__OUTSIDE_FUNCTIONS__"};
+/* events outside any traced function; the first name every table interns */
+
+/* Interns function names into dense IDs.
+ *
+ * Each distinct name is copied once into an arena and looked up
+ * by its hash in an open-addressing table, so entering a function that
+ * was seen before allocates nothing. Names arrive through the per-buffer
+ * name slots of each event, whose offsets are not stable across buffers,
+ * so the name itself is the key. */
+class SymbolTable
+{
+  public:
+    SymbolTable() { intern(ROOT_NAME); }
+
+    auto intern(const char *name) -> SymID;
+    auto name(SymID id) const -> const char* { return names[id]; }
+    auto size() const -> size_t { return names.size(); }
+
+  private:
+    static constexpr size_t MIN_CAPACITY{1024};
+
+    auto probe(uint64_t hash, const char *name, size_t len) const -> size_t;
+    auto grow() -> void;
+
+    Arena<char, 1 << 16> storage;
+    std::vector<const char*> names;
+    std::vector<uint64_t> hashes;
+    /* by SymID */
+
+    std::vector<SymID> slots;
+    /* SymIDs by hash, INVL_SYM if empty */
+};
+
+
+inline auto SymbolTable::probe(uint64_t hash, const char *name, size_t len) const -> size_t
+{
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    for (; slots[i] != INVL_SYM; i = (i + 1) & mask)
+    {
+        SymID id = slots[i];
+        if (hashes[id] == hash && std::strncmp(names[id], name, len + 1) == 0)
+            break;
+    }
+    return i;
+}
+
+
+inline auto SymbolTable::intern(const char *name) -> SymID
+{
+    /* FNV-1a, and the length, in one pass */
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t len = 0;
+    for (; name[len] != '\0'; ++len)
+        hash = (hash ^ static_cast<unsigned char>(name[len])) * 0x100000001b3ULL;
+
+    if ((names.size() + 1) * 2 > slots.size())
+        grow();
+
+    size_t i = probe(hash, name, len);
+    if (slots[i] == INVL_SYM)
+    {
+        char *copy = storage.allocate(len + 1);
+        std::memcpy(copy, name, len + 1);
+
+        slots[i] = names.size();
+        names.push_back(copy);
+        hashes.push_back(hash);
+    }
+    return slots[i];
+}
+
+
+inline auto SymbolTable::grow() -> void
+{
+    slots.assign(slots.empty() ? MIN_CAPACITY : slots.size() * 2, INVL_SYM);
+
+    size_t mask = slots.size() - 1;
+    for (SymID id = 0; id < names.size(); ++id)
+    {
+        size_t i = hashes[id] & mask;
+        while (slots[i] != INVL_SYM)
+            i = (i + 1) & mask;
+        slots[i] = id;
+    }
+}
+
+}; //end namespace SigilClassic
+
+#endif
@@ -0,0 +1,181 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "SigilClassic/FunctionProfile.hpp"
+#include "Core/EventBuffer.h"
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <unistd.h>
+
+using namespace SigilClassic;
+
+namespace
+{
+
+auto readLines(const std::string &path) -> std::set<std::string>
+{
+    std::ifstream file(path);
+    std::set<std::string> lines;
+    for (std::string line; std::getline(file, line);)
+        lines.insert(line);
+    return lines;
+}
+
+
+auto takeEntities(SigilContext &cxt) -> ContextEntities
+{
+    return ContextEntities{std::move(cxt.symbols),
+                           std::move(cxt.thread_contexts),
+                           cxt.last_eid};
+}
+
+}; //end namespace
+
+TEST_CASE("function profile", "[FunctionProfile]")
+{
+    char dir[] = "/tmp/functionprofileXXXXXX";
+    REQUIRE(mkdtemp(dir) != nullptr);
+    std::string functions = std::string(dir) + "/sigil.functions.csv";
+    std::string comm = std::string(dir) + "/sigil.functions.comm.csv";
+    std::string dot = std::string(dir) + "/sigil.functions.dot";
+
+    SharedState shared;
+    std::vector<ContextEntities> contexts;
+    {
+        SigilContext cxt(shared);
+        cxt.enterEntity("producer");
+        cxt.monitorWrite(0x1000, 8);
+        cxt.incrIOPCost();
+        cxt.exitEntity();
+
+        cxt.enterEntity("consumer");
+        cxt.monitorRead(0x1000, 8);
+        cxt.monitorRead(0x1000, 4); // already read by this call
+        cxt.incrFLOPCost();
+        cxt.exitEntity();
+
+        cxt.enterEntity("consumer");
+        cxt.monitorRead(0x1004, 4);
+        cxt.exitEntity();
+
+        /* never written */
+        cxt.setThreadContext(1);
+        cxt.enterEntity("consumer");
+        cxt.monitorRead(0x2000, 2);
+        cxt.exitEntity();
+
+        contexts.push_back(takeEntities(cxt));
+    }
+    {
+        /* another handler's calls, matched by name */
+        ContextEntities other;
+        EntityData *call = other.thread_contexts[2].entity_data.allocate();
+        call->eid = shared.next_eid++;
+        call->name = other.symbols.intern("producer");
+        call->iops = 5;
+        other.last_eid = call->eid;
+        contexts.push_back(std::move(other));
+    }
+
+    FunctionProfile profile(contexts);
+    REQUIRE(profile.writeFunctions(functions) == true);
+    REQUIRE(profile.writeComm(comm) == true);
+    REQUIRE(profile.writeDot(dot) == true);
+
+    std::set<std::string> expectedFunctions{
+        "function,calls,iops,flops,local_bytes_read,comm_bytes_read",
+        "\"__BEGINNING_OF_SIGIL__\",1,0,0,0,0",
+        "\"__OUTSIDE_FUNCTIONS__\",0,0,0,0,0",
+        "\"consumer\",3,0,1,4,14",
+        "\"producer\",2,6,0,0,0"};
+    REQUIRE(readLines(functions) == expectedFunctions);
+
+    std::set<std::string> expectedComm{
+        "producer,consumer,bytes",
+        "\"producer\",\"consumer\",12",
+        "\"__OUTSIDE_FUNCTIONS__\",\"consumer\",2"};
+    REQUIRE(readLines(comm) == expectedComm);
+
+    auto graph = readLines(dot);
+    REQUIRE(graph.count("  \"__BEGINNING_OF_SIGIL__\" -> \"consumer\" [label=\"2\"];") == 1);
+    REQUIRE(graph.count("  \"__OUTSIDE_FUNCTIONS__\" -> \"producer\" [label=\"1\"];") == 1);
+    REQUIRE(graph.count("  \"producer\" -> \"consumer\" [style=dashed label=\"12 B\"];") == 1);
+
+    unlink(functions.c_str());
+    unlink(comm.c_str());
+    unlink(dot.c_str());
+    rmdir(dir);
+}
+
+
+TEST_CASE("communication across contexts", "[FunctionProfile]")
+{
+    char dir[] = "/tmp/functionprofileXXXXXX";
+    REQUIRE(mkdtemp(dir) != nullptr);
+    std::string comm = std::string(dir) + "/sigil.functions.comm.csv";
+
+    /* handlers share shadow memory, so a read in one context
+     * is attributed to the writer from another */
+    SharedState shared;
+    SigilContext producer(shared);
+    SigilContext consumer(shared);
+    producer.enterEntity("producer");
+    producer.monitorWrite(0x7ffff000, 0x2000); // crosses secondary maps
+    producer.exitEntity();
+
+    consumer.enterEntity("consumer");
+    consumer.monitorRead(0x7ffff000, 0x2000);
+    consumer.monitorRead(0x7ffff000, 0x10);
+    consumer.exitEntity();
+
+    std::vector<ContextEntities> contexts;
+    contexts.push_back(takeEntities(producer));
+    contexts.push_back(takeEntities(consumer));
+
+    FunctionProfile profile(contexts);
+    REQUIRE(profile.writeComm(comm) == true);
+
+    std::set<std::string> expectedComm{
+        "producer,consumer,bytes",
+        "\"producer\",\"consumer\",8192"};
+    REQUIRE(readLines(comm) == expectedComm);
+
+    unlink(comm.c_str());
+    rmdir(dir);
+}
+
+
+TEST_CASE("function names sent once", "[FunctionProfile]")
+{
+    /* the frontend writes each name with its first event,
+     * and only the name's ID afterwards */
+    NameBuffer buffer;
+    std::strcpy(buffer.names, "main");
+    std::strcpy(buffer.names + 5, "work");
+    GetNameBase nameBase = [&]{ return buffer.names; };
+    prism::CxtNames names(nameBase);
+
+    auto named = [](CxtType type, uint32_t idx, uint32_t len) {
+        PrismCxtEv ev{};
+        ev.type = type;
+        ev.idx = idx;
+        ev.len = len;
+        return ev;
+    };
+
+    auto mainEnter = named(PRISM_CXT_FUNC_ENTER, 0, 5);
+    auto workEnter = named(PRISM_CXT_FUNC_ENTER, 5, 5);
+    REQUIRE(std::string(prism::CxtEvent(mainEnter, names).getName()) == "main");
+    REQUIRE(std::string(prism::CxtEvent(workEnter, names).getName()) == "work");
+
+    /* the name buffer is reused for the next events */
+    std::strcpy(buffer.names, "gone");
+    auto workExit = named(PRISM_CXT_FUNC_EXIT, 1, 0);
+    auto mainExit = named(PRISM_CXT_FUNC_EXIT, 0, 0);
+    REQUIRE(std::string(prism::CxtEvent(workExit, names).getName()) == "work");
+    REQUIRE(std::string(prism::CxtEvent(mainExit, names).getName()) == "main");
+
+    auto unknown = named(PRISM_CXT_FUNC_ENTER, 2, 0);
+    REQUIRE_THROWS(prism::CxtEvent(unknown, names));
+}
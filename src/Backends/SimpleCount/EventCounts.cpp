@@ -0,0 +1,342 @@
+#include "EventCounts.hpp"
+#include "Utils/PrismLog.hpp"
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMPLECOUNT_X86
+#include <immintrin.h>
+#endif
+
+namespace SimpleCount
+{
+
+constexpr unsigned EventCounts::SIZE_BUCKETS;
+
+
+auto EventCounts::sizeBucket(ByteCount size) -> unsigned
+{
+    /* powers of two up to 32 bytes */
+    if (size == 0 || size > 32 || (size & (size - 1)) != 0)
+        return SIZE_BUCKETS - 1;
+    return __builtin_ctz(size);
+}
+
+
+auto EventCounts::addMem(MemType type, unsigned long count, ByteCount size) -> void
+{
+    mem_cnt += count;
+    if (type == PRISM_MEM_STORE || type == PRISM_MEM_STORE_COUNT)
+        write_cnt += count;
+    else if (type == PRISM_MEM_LOAD || type == PRISM_MEM_LOAD_COUNT)
+        read_cnt += count;
+
+    if (type < PRISM_MEM_LOAD_COUNT)
+        size_cnt[sizeBucket(size)] += count;
+    else
+        size_cnt[SIZE_BUCKETS - 1] += count;
+}
+
+
+auto EventCounts::addComp(CompCostType type) -> void
+{
+    ++comp_cnt;
+    if (type == PRISM_COMP_IOP)
+        ++iop_cnt;
+    else if (type == PRISM_COMP_FLOP)
+        ++flop_cnt;
+}
+
+
+auto EventCounts::addSync(SyncType type) -> void
+{
+    if (type == PRISM_SYNC_SWAP)
+    {
+        ++swap_cnt;
+    }
+    else
+    {
+        ++sync_cnt;
+        switch(type)
+        {
+        case PRISM_SYNC_CREATE:
+            ++spawn_cnt;
+            break;
+        case PRISM_SYNC_JOIN:
+            ++join_cnt;
+            break;
+        case PRISM_SYNC_LOCK:
+            ++lock_cnt;
+            break;
+        case PRISM_SYNC_UNLOCK:
+            ++unlock_cnt;
+            break;
+        case PRISM_SYNC_BARRIER:
+            ++barrier_cnt;
+            break;
+        case PRISM_SYNC_CONDWAIT:
+            ++wait_cnt;
+            break;
+        case PRISM_SYNC_CONDSIG:
+            ++sig_cnt;
+            break;
+        case PRISM_SYNC_CONDBROAD:
+            ++broad_cnt;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+
+auto EventCounts::addCxt(CxtType type) -> void
+{
+    ++cxt_cnt;
+    if (type == PRISM_CXT_INSTR)
+        ++instr_cnt;
+}
+
+
+auto EventCounts::add(const PrismEvVariant &ev) -> void
+{
+    switch (ev.tag)
+    {
+    case PRISM_MEM_TAG:
+        if (ev.mem.type < PRISM_MEM_LOAD_COUNT)
+            addMem(ev.mem.type, 1, ev.mem.size);
+        else
+            addMem(ev.mem.type, ev.mem.count, 0);
+        break;
+    case PRISM_COMP_TAG:
+        addComp(ev.comp.type);
+        break;
+    case PRISM_SYNC_TAG:
+        addSync(ev.sync.type);
+        break;
+    case PRISM_CXT_TAG:
+        addCxt(ev.cxt.type);
+        break;
+    case PRISM_CF_TAG:
+        addCF();
+        break;
+    default:
+        PrismLog::fatal("Received unhandled event in " __FILE__);
+    }
+}
+
+
+auto EventCounts::operator+=(const EventCounts &other) -> EventCounts&
+{
+    read_cnt    += other.read_cnt;
+    write_cnt   += other.write_cnt;
+    mem_cnt     += other.mem_cnt;
+    iop_cnt     += other.iop_cnt;
+    flop_cnt    += other.flop_cnt;
+    comp_cnt    += other.comp_cnt;
+    swap_cnt    += other.swap_cnt;
+    sync_cnt    += other.sync_cnt;
+    spawn_cnt   += other.spawn_cnt;
+    join_cnt    += other.join_cnt;
+    lock_cnt    += other.lock_cnt;
+    unlock_cnt  += other.unlock_cnt;
+    barrier_cnt += other.barrier_cnt;
+    wait_cnt    += other.wait_cnt;
+    sig_cnt     += other.sig_cnt;
+    broad_cnt   += other.broad_cnt;
+    cf_cnt      += other.cf_cnt;
+    instr_cnt   += other.instr_cnt;
+    cxt_cnt     += other.cxt_cnt;
+    for (unsigned b = 0; b < SIZE_BUCKETS; ++b)
+        size_cnt[b] += other.size_cnt[b];
+    return *this;
+}
+
+
+auto countEventsScalar(const PrismEvVariant *events, size_t n, EventCounts &counts) -> void
+{
+    for (size_t i = 0; i < n; ++i)
+        counts.add(events[i]);
+}
+
+
+#ifdef SIMPLECOUNT_X86
+namespace
+{
+
+__attribute__((target("avx2")))
+auto sum(__m256i lanes) -> unsigned long
+{
+    alignas(32) int32_t values[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(values), lanes);
+
+    unsigned long ret = 0;
+    for (auto value : values)
+        ret += static_cast<uint32_t>(value);
+    return ret;
+}
+
+
+template <bool Sizes>
+__attribute__((target("avx2")))
+auto countAVX2(const PrismEvVariant *events, size_t n, EventCounts &counts) -> void
+{
+    /* Eight events at a time: gather the word holding each event's tag and
+     * (non-memory) type, and the word holding its memory size and type, then
+     * count the common tag/type pairs and access sizes with compares. The
+     * rest, e.g. synchronization and counted memory events, are rare and
+     * counted one at a time */
+    constexpr int STRIDE = sizeof(PrismEvVariant);
+    constexpr int MEM_TYPE_WORD = offsetof(PrismEvVariant, mem.type) - 3;
+    static_assert(offsetof(PrismEvVariant, tag) == 0 &&
+                  offsetof(PrismEvVariant, comp.type) == 1 &&
+                  offsetof(PrismEvVariant, cxt.type) == 1 &&
+                  offsetof(PrismEvVariant, mem.size) == MEM_TYPE_WORD + 1,
+                  "event layout assumed by the AVX2 histogram");
+
+    const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                             _mm256_set1_epi32(STRIDE));
+    const __m256i byte = _mm256_set1_epi32(0xff);
+    const __m256i memTag = _mm256_set1_epi32(PRISM_MEM_TAG);
+    const __m256i compTag = _mm256_set1_epi32(PRISM_COMP_TAG);
+    const __m256i cxtTag = _mm256_set1_epi32(PRISM_CXT_TAG);
+    const __m256i cfTag = _mm256_set1_epi32(PRISM_CF_TAG);
+    const __m256i load = _mm256_set1_epi32(PRISM_MEM_LOAD);
+    const __m256i store = _mm256_set1_epi32(PRISM_MEM_STORE);
+    const __m256i iop = _mm256_set1_epi32(PRISM_COMP_IOP);
+    const __m256i flop = _mm256_set1_epi32(PRISM_COMP_FLOP);
+    const __m256i instr = _mm256_set1_epi32(PRISM_CXT_INSTR);
+    const __m256i halfword = _mm256_set1_epi32(0xffff);
+
+    /* lanes are 32-bit, so flush them well before they could overflow */
+    constexpr size_t CHUNK = size_t{1} << 30;
+
+    size_t i = 0;
+    while (n - i >= 8)
+    {
+        __m256i loads = _mm256_setzero_si256(), stores = _mm256_setzero_si256();
+        __m256i comps = _mm256_setzero_si256(), iops = _mm256_setzero_si256();
+        __m256i flops = _mm256_setzero_si256(), cxts = _mm256_setzero_si256();
+        __m256i instrs = _mm256_setzero_si256(), cfs = _mm256_setzero_si256();
+        __m256i sizes[EventCounts::SIZE_BUCKETS - 1];
+        for (auto &lanes : sizes)
+            lanes = _mm256_setzero_si256();
+
+        size_t end = (n - i > CHUNK ? i + CHUNK : n);
+        for (; end - i >= 8; i += 8)
+        {
+            auto base = reinterpret_cast<const char*>(events + i);
+            __m256i head = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base),
+                                                  index, 1);
+            __m256i memWord = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base + MEM_TYPE_WORD),
+                                                     index, 1);
+
+            __m256i tag = _mm256_and_si256(head, byte);
+            __m256i type = _mm256_and_si256(_mm256_srli_epi32(head, 8), byte);
+            __m256i memType = _mm256_srli_epi32(memWord, 24);
+            __m256i memSize = _mm256_and_si256(_mm256_srli_epi32(memWord, 8), halfword);
+
+            __m256i isMem = _mm256_cmpeq_epi32(tag, memTag);
+            __m256i isLoad = _mm256_and_si256(isMem, _mm256_cmpeq_epi32(memType, load));
+            __m256i isStore = _mm256_and_si256(isMem, _mm256_cmpeq_epi32(memType, store));
+            __m256i isComp = _mm256_cmpeq_epi32(tag, compTag);
+            __m256i isCxt = _mm256_cmpeq_epi32(tag, cxtTag);
+            __m256i isCF = _mm256_cmpeq_epi32(tag, cfTag);
+
+            /* a true compare is -1 */
+            loads = _mm256_sub_epi32(loads, isLoad);
+            stores = _mm256_sub_epi32(stores, isStore);
+            comps = _mm256_sub_epi32(comps, isComp);
+            iops = _mm256_sub_epi32(iops, _mm256_and_si256(isComp, _mm256_cmpeq_epi32(type, iop)));
+            flops = _mm256_sub_epi32(flops, _mm256_and_si256(isComp, _mm256_cmpeq_epi32(type, flop)));
+            cxts = _mm256_sub_epi32(cxts, isCxt);
+            instrs = _mm256_sub_epi32(instrs, _mm256_and_si256(isCxt, _mm256_cmpeq_epi32(type, instr)));
+            cfs = _mm256_sub_epi32(cfs, isCF);
+
+            __m256i isAccess = _mm256_or_si256(isLoad, isStore);
+            for (unsigned b = 0; Sizes == true && b < EventCounts::SIZE_BUCKETS - 1; ++b)
+                sizes[b] = _mm256_sub_epi32(sizes[b], _mm256_and_si256(isAccess,
+                    _mm256_cmpeq_epi32(memSize, _mm256_set1_epi32(1 << b))));
+
+            __m256i common = _mm256_or_si256(isAccess,
+                                             _mm256_or_si256(isComp, _mm256_or_si256(isCxt, isCF)));
+            unsigned rare = ~_mm256_movemask_ps(_mm256_castsi256_ps(common)) & 0xff;
+            for (; rare != 0; rare &= rare - 1)
+                counts.add(events[i + __builtin_ctz(rare)]);
+        }
+
+        unsigned long reads = sum(loads);
+        unsigned long writes = sum(stores);
+        counts.read_cnt += reads;
+        counts.write_cnt += writes;
+        counts.mem_cnt += reads + writes;
+        counts.comp_cnt += sum(comps);
+        counts.iop_cnt += sum(iops);
+        counts.flop_cnt += sum(flops);
+        counts.cxt_cnt += sum(cxts);
+        counts.instr_cnt += sum(instrs);
+        counts.cf_cnt += sum(cfs);
+
+        /* every other access was of some other size */
+        if (Sizes == true)
+        {
+            unsigned long sized = 0;
+            for (unsigned b = 0; b < EventCounts::SIZE_BUCKETS - 1; ++b)
+            {
+                unsigned long accesses = sum(sizes[b]);
+                counts.size_cnt[b] += accesses;
+                sized += accesses;
+            }
+            counts.size_cnt[EventCounts::SIZE_BUCKETS - 1] += reads + writes - sized;
+        }
+    }
+
+    countEventsScalar(events + i, n - i, counts);
+}
+
+}; //end namespace
+
+
+auto countEventsAVX2(const PrismEvVariant *events, size_t n, EventCounts &counts,
+                     bool sizes) -> void
+{
+    if (sizes == true)
+        countAVX2<true>(events, n, counts);
+    else
+        countAVX2<false>(events, n, counts);
+}
+
+
+auto hasAVX2() -> bool
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+#else
+
+auto countEventsAVX2(const PrismEvVariant *events, size_t n, EventCounts &counts,
+                     bool) -> void
+{
+    countEventsScalar(events, n, counts);
+}
+
+
+auto hasAVX2() -> bool
+{
+    return false;
+}
+
+#endif
+
+
+auto countEvents(const PrismEvVariant *events, size_t n, EventCounts &counts,
+                 bool sizes) -> void
+{
+    if (hasAVX2() == true)
+        countEventsAVX2(events, n, counts, sizes);
+    else
+        countEventsScalar(events, n, counts);
+}
+
+}; //end namespace SimpleCount
@@ -0,0 +1,68 @@
+#ifndef SIMPLECOUNT_EVENTCOUNTS_H
+#define SIMPLECOUNT_EVENTCOUNTS_H
+
+#include "Core/EventBuffer.h"
+
+namespace SimpleCount
+{
+
+struct EventCounts
+{
+    unsigned long read_cnt{0};
+    unsigned long write_cnt{0};
+    unsigned long mem_cnt{0};
+
+    unsigned long iop_cnt{0};
+    unsigned long flop_cnt{0};
+    unsigned long comp_cnt{0};
+
+    unsigned long swap_cnt{0};
+    unsigned long sync_cnt{0};
+    unsigned long spawn_cnt{0};
+    unsigned long join_cnt{0};
+    unsigned long lock_cnt{0};
+    unsigned long unlock_cnt{0};
+    unsigned long barrier_cnt{0};
+    unsigned long wait_cnt{0};
+    unsigned long sig_cnt{0};
+    unsigned long broad_cnt{0};
+
+    unsigned long cf_cnt{0};
+
+    unsigned long instr_cnt{0};
+    unsigned long cxt_cnt{0};
+
+    /* Memory accesses by size: 1, 2, 4, 8, 16, and 32 bytes, then
+     * any other size, including counted accesses, which have none */
+    static constexpr unsigned SIZE_BUCKETS = 7;
+    unsigned long size_cnt[SIZE_BUCKETS]{};
+
+    static auto sizeBucket(ByteCount size) -> unsigned;
+
+    auto addMem(MemType type, unsigned long count, ByteCount size) -> void;
+    auto addComp(CompCostType type) -> void;
+    auto addSync(SyncType type) -> void;
+    auto addCxt(CxtType type) -> void;
+    auto addCF() -> void { ++cf_cnt; }
+
+    auto add(const PrismEvVariant &ev) -> void;
+    auto operator+=(const EventCounts &other) -> EventCounts&;
+};
+
+
+/* Counts a buffer of events, as a histogram over each event's tag and type.
+ *
+ * countEvents() uses AVX2 when the CPU supports it, and the scalar loop
+ * otherwise; both are exposed so they can be checked against each other.
+ * Access sizes cost the AVX2 loop several compares per block, so it skips
+ * them unless 'sizes' is set, leaving the size histogram incomplete */
+auto countEvents(const PrismEvVariant *events, size_t n, EventCounts &counts,
+                 bool sizes) -> void;
+auto countEventsScalar(const PrismEvVariant *events, size_t n, EventCounts &counts) -> void;
+auto countEventsAVX2(const PrismEvVariant *events, size_t n, EventCounts &counts,
+                     bool sizes) -> void;
+auto hasAVX2() -> bool;
+
+}; //end namespace SimpleCount
+
+#endif
@@ -1,162 +1,152 @@
 #include "Handler.hpp"
+#include "Utils/BackendOptions.hpp"
+#include "Utils/PrismLog.hpp"
 #include "spdlog/spdlog.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/sinks/stdout_sinks.h"
 #include <iostream>
-#include <atomic>
+#include <map>
+#include <set>
 
 namespace
 {
-std::atomic<unsigned long> global_read_cnt{0};
-std::atomic<unsigned long> global_write_cnt{0};
-std::atomic<unsigned long> global_mem_cnt{0};
-std::atomic<unsigned long> global_iop_cnt{0};
-std::atomic<unsigned long> global_flop_cnt{0};
-std::atomic<unsigned long> global_comp_cnt{0};
-std::atomic<unsigned long> global_swap_cnt{0};
-std::atomic<unsigned long> global_sync_cnt{0};
-std::atomic<unsigned long> global_cf_cnt{0};
-std::atomic<unsigned long> global_instr_cnt{0};
-std::atomic<unsigned long> global_cxt_cnt{0};
-std::atomic<unsigned long> global_spawn_cnt{0};
-std::atomic<unsigned long> global_join_cnt{0};
-std::atomic<unsigned long> global_lock_cnt{0};
-std::atomic<unsigned long> global_unlock_cnt{0};
-std::atomic<unsigned long> global_barrier_cnt{0};
-std::atomic<unsigned long> global_wait_cnt{0};
-std::atomic<unsigned long> global_sig_cnt{0};
-std::atomic<unsigned long> global_broad_cnt{0};
+/* set once, before any events */
+std::string outputPath{"."};
+unsigned long intervalInstructions{0};
+double intervalSeconds{0};
+
+auto reporting() -> bool
+{
+    return intervalInstructions > 0 || intervalSeconds > 0;
+}
 };
 
 namespace SimpleCount
 {
 
+Shared::Shared()
+{
+    if (reporting() == false)
+        return;
+
+    auto period = std::chrono::duration<double>(intervalSeconds);
+    reporter = std::make_unique<IntervalReporter>(
+        outputPath + "/simplecount.intervals.csv",
+        std::chrono::duration_cast<IntervalReporter::Clock::duration>(period),
+        intervalInstructions);
+}
+
+
+Handler::Handler(BackendContext &context)
+    : shared(static_cast<Shared&>(context))
+{
+    if (shared.reporter != nullptr)
+        threads = std::make_unique<ThreadCounts>(*shared.reporter);
+}
+
+
+auto Handler::current() -> EventCounts&
+{
+    return threads != nullptr ? threads->current() : counts;
+}
+
+
 auto Handler::onSyncEv(const prism::SyncEvent &ev) -> void
 {
-    if (ev.type() == PRISM_SYNC_SWAP)
-    {
-        ++swap_cnt;
-    }
-    else
-    {
-        ++sync_cnt;
-        switch(ev.type())
-        {
-        case PRISM_SYNC_CREATE:
-            ++spawn_cnt;
-            break;
-        case PRISM_SYNC_JOIN:
-            ++join_cnt;
-            break;
-        case PRISM_SYNC_LOCK:
-            ++lock_cnt;
-            break;
-        case PRISM_SYNC_UNLOCK:
-            ++unlock_cnt;
-            break;
-        case PRISM_SYNC_BARRIER:
-            ++barrier_cnt;
-            break;
-        case PRISM_SYNC_CONDWAIT:
-            ++wait_cnt;
-            break;
-        case PRISM_SYNC_CONDSIG:
-            ++sig_cnt;
-            break;
-        case PRISM_SYNC_CONDBROAD:
-            ++broad_cnt;
-            break;
-
-        }
-    }
+    if (threads != nullptr && ev.type() == PRISM_SYNC_SWAP)
+        threads->swap(ev.data());
+    current().addSync(ev.type());
 }
 
 
 auto Handler::onCompEv(const prism::CompEvent &ev) -> void
 {
-    ++comp_cnt;
-    if (ev.isIOP())
-        ++iop_cnt;
-    else if (ev.isFLOP())
-        ++flop_cnt;
+    current().addComp(ev.type());
 }
 
 
 auto Handler::onMemEv(const prism::MemEvent &ev) -> void
 {
-    ++mem_cnt;
-    if (ev.isStore())
-        ++write_cnt;
-    else if (ev.isLoad())
-        ++read_cnt;
+    current().addMem(ev.type(), 1, ev.bytes());
 }
 
 
-auto Handler::onCFEv(const PrismCFEv &ev) -> void
+auto Handler::onMemCountEv(const prism::MemEvent &ev, PtrVal count) -> void
 {
-    ++cf_cnt;
+    current().addMem(ev.type(), count, 0);
+}
+
+
+auto Handler::onCFEv(const PrismCFEv &) -> void
+{
+    current().addCF();
 }
 
 
 auto Handler::onCxtEv(const prism::CxtEvent &ev) -> void
 {
-    ++cxt_cnt;
-    if (ev.type() == PRISM_CXT_INSTR)
-        ++instr_cnt;
+    current().addCxt(ev.type());
+}
+
+
+auto Handler::onEvents(const EventBuffer &buf, prism::CxtNames &) -> void
+{
+    /* only counts are kept, so the buffer is
+     * counted at once instead of per event */
+    if (threads != nullptr)
+        threads->count(buf.events, buf.used);
+    else
+        countEvents(buf.events, buf.used, counts, false);
 }
 
 
 Handler::~Handler()
 {
-    global_read_cnt    += read_cnt;
-    global_write_cnt   += write_cnt;
-    global_mem_cnt     += mem_cnt;
-    global_iop_cnt     += iop_cnt;
-    global_flop_cnt    += flop_cnt;
-    global_comp_cnt    += comp_cnt;
-    global_swap_cnt    += swap_cnt;
-    global_sync_cnt    += sync_cnt;
-    global_cf_cnt      += cf_cnt;
-    global_cxt_cnt     += cxt_cnt;
-    global_instr_cnt   += instr_cnt;
-    global_spawn_cnt   += spawn_cnt;
-    global_join_cnt    += join_cnt;
-    global_lock_cnt    += lock_cnt;
-    global_unlock_cnt  += unlock_cnt;
-    global_barrier_cnt += barrier_cnt;
-    global_wait_cnt    += wait_cnt;
-    global_sig_cnt     += sig_cnt;
-    global_broad_cnt   += broad_cnt;
-}
-
-
-auto cleanup() -> void
+    if (threads != nullptr)
+    {
+        threads->publish();
+        counts = threads->total();
+    }
+
+    std::lock_guard<std::mutex> lock(shared.mtx);
+    shared.totals += counts;
+}
+
+
+auto cleanup(BackendContext &context) -> void
 {
+    auto &shared = static_cast<Shared&>(context);
+    if (shared.reporter != nullptr)
+    {
+        shared.reporter->stop();
+        PrismLog::info("Flushed intervals to: " + outputPath + "/simplecount.intervals.csv");
+    }
+
     char const* logger_name = "simplecount-console";
     auto logger = isatty(fileno(stdout)) ? spdlog::stdout_color_st(logger_name) : 
         spdlog::stderr_logger_st(logger_name);
 
     logger->set_pattern("[SimpleCount] %v");
 
-    logger->info("Total Compute   Events: {}", std::to_string(global_comp_cnt));
-    logger->info("Total IOP       Events: {}", std::to_string(global_iop_cnt));
-    logger->info("Total FLOP      Events: {}", std::to_string(global_flop_cnt));
-    logger->info("Total Memory    Events: {}", std::to_string(global_mem_cnt));
-    logger->info("Total ReadMem   Events: {}", std::to_string(global_read_cnt));
-    logger->info("Total WriteMem  Events: {}", std::to_string(global_write_cnt));
-    logger->info("Total Swap      Events: {}", std::to_string(global_swap_cnt));
-    logger->info("Total Sync      Events: {}", std::to_string(global_sync_cnt));
-    logger->info("Total Spawn     Events: {}", std::to_string(global_spawn_cnt));
-    logger->info("Total Join      Events: {}", std::to_string(global_join_cnt));
-    logger->info("Total Lock      Events: {}", std::to_string(global_lock_cnt));
-    logger->info("Total Unlock    Events: {}", std::to_string(global_unlock_cnt));
-    logger->info("Total Barrier   Events: {}", std::to_string(global_barrier_cnt));
-    logger->info("Total Wait      Events: {}", std::to_string(global_wait_cnt));
-    logger->info("Total Signal    Events: {}", std::to_string(global_sig_cnt));
-    logger->info("Total Broadcast Events: {}", std::to_string(global_broad_cnt));
-    logger->info("Total CntlFlow  Events: {}", std::to_string(global_cf_cnt));
-    logger->info("Total Instr     Events: {}", std::to_string(global_instr_cnt));
-    logger->info("Total Context   Events: {}", std::to_string(global_cxt_cnt));
+    logger->info("Total Compute   Events: {}", std::to_string(shared.totals.comp_cnt));
+    logger->info("Total IOP       Events: {}", std::to_string(shared.totals.iop_cnt));
+    logger->info("Total FLOP      Events: {}", std::to_string(shared.totals.flop_cnt));
+    logger->info("Total Memory    Events: {}", std::to_string(shared.totals.mem_cnt));
+    logger->info("Total ReadMem   Events: {}", std::to_string(shared.totals.read_cnt));
+    logger->info("Total WriteMem  Events: {}", std::to_string(shared.totals.write_cnt));
+    logger->info("Total Swap      Events: {}", std::to_string(shared.totals.swap_cnt));
+    logger->info("Total Sync      Events: {}", std::to_string(shared.totals.sync_cnt));
+    logger->info("Total Spawn     Events: {}", std::to_string(shared.totals.spawn_cnt));
+    logger->info("Total Join      Events: {}", std::to_string(shared.totals.join_cnt));
+    logger->info("Total Lock      Events: {}", std::to_string(shared.totals.lock_cnt));
+    logger->info("Total Unlock    Events: {}", std::to_string(shared.totals.unlock_cnt));
+    logger->info("Total Barrier   Events: {}", std::to_string(shared.totals.barrier_cnt));
+    logger->info("Total Wait      Events: {}", std::to_string(shared.totals.wait_cnt));
+    logger->info("Total Signal    Events: {}", std::to_string(shared.totals.sig_cnt));
+    logger->info("Total Broadcast Events: {}", std::to_string(shared.totals.broad_cnt));
+    logger->info("Total CntlFlow  Events: {}", std::to_string(shared.totals.cf_cnt));
+    logger->info("Total Instr     Events: {}", std::to_string(shared.totals.instr_cnt));
+    logger->info("Total Context   Events: {}", std::to_string(shared.totals.cxt_cnt));
 }
 
 
@@ -169,7 +159,7 @@ auto requirements() -> prism::capabilities
 
     caps[MEMORY]         = availability::enabled;
     caps[MEMORY_LDST]    = availability::enabled;
-    caps[MEMORY_SIZE]    = availability::disabled;
+    caps[MEMORY_SIZE]    = (reporting() ? availability::enabled : availability::disabled);
     caps[MEMORY_ADDRESS] = availability::disabled;
 
     caps[COMPUTE]              = availability::enabled;
@@ -191,4 +181,53 @@ auto requirements() -> prism::capabilities
 
     return caps;
 }
+
+
+//-----------------------------------------------------------------------------
+/** Option Parsing **/
+namespace
+{
+
+auto parseInterval(const std::string &arg, const char *what) -> double
+{
+    if (arg.empty() == true)
+        return 0; //default, no intervals
+
+    size_t end = 0;
+    double value = 0;
+    try
+    {
+        value = std::stod(arg, &end);
+    }
+    catch (std::exception &e)
+    {
+        end = 0;
+    }
+
+    if (end != arg.length() || !(value > 0))
+        PrismLog::fatal(std::string("invalid simplecount interval ") + what + ": " + arg);
+    return value;
+}
+
+}; //end namespace
+
+
+auto onParse(Args args) -> void
+{
+    /* only accept short options */
+    std::set<char> options;
+    options.insert('i'); // -i INSTRUCTIONS per interval
+    options.insert('t'); // -t SECONDS per interval
+    options.insert('o'); // -o OUTPUT_DIRECTORY
+    auto matches = prism::parseShortOptions(args, options, "simplecount");
+
+    intervalInstructions = parseInterval(matches['i'], "instructions");
+    intervalSeconds = parseInterval(matches['t'], "seconds");
+
+    if (intervalInstructions > 0 && intervalSeconds > 0)
+        PrismLog::fatal("simplecount intervals are either by instructions (-i) or seconds (-t)");
+
+    outputPath = prism::parseOutputPath(matches['o']);
+}
+
 }; //end namespace SimpleCount
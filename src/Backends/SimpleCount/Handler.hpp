@@ -2,11 +2,29 @@
 #define SIMPLECOUNT_H
 
 #include "Core/Backends.hpp"
+#include "EventCounts.hpp"
+#include "Intervals.hpp"
+#include <mutex>
 
 namespace SimpleCount
 {
 
-auto cleanup() -> void;
+struct Shared : public BackendContext
+{
+    /* Created after options are parsed,
+     * and shared by every consumer's handler */
+    Shared();
+
+    std::mutex mtx;
+    EventCounts totals;
+    /* each handler adds its counts when it finishes */
+
+    std::unique_ptr<IntervalReporter> reporter;
+    /* null unless reporting intervals */
+};
+
+auto onParse(Args args) -> void;
+auto cleanup(BackendContext &context) -> void;
 auto requirements() -> prism::capabilities;
 /* Prism hooks */
 
@@ -17,34 +35,21 @@ class Handler : public BackendIface
     virtual auto onSyncEv(const prism::SyncEvent &ev) -> void override;
     virtual auto onCompEv(const prism::CompEvent &ev) -> void override;
     virtual auto onMemEv(const prism::MemEvent &ev) -> void override;
+    virtual auto onMemCountEv(const prism::MemEvent &ev, PtrVal count) -> void override;
     virtual auto onCFEv(const PrismCFEv &ev) -> void override;
     virtual auto onCxtEv(const prism::CxtEvent &ev) -> void override;
+    virtual auto onEvents(const EventBuffer &buf, prism::CxtNames &names) -> void override;
 
-    unsigned long read_cnt{0};
-    unsigned long write_cnt{0};
-    unsigned long mem_cnt{0};
-
-    unsigned long iop_cnt{0};
-    unsigned long flop_cnt{0};
-    unsigned long comp_cnt{0};
-
-    unsigned long swap_cnt{0};
-    unsigned long sync_cnt{0};
-    unsigned long spawn_cnt{0};
-    unsigned long join_cnt{0};
-    unsigned long lock_cnt{0};
-    unsigned long unlock_cnt{0};
-    unsigned long barrier_cnt{0};
-    unsigned long wait_cnt{0};
-    unsigned long sig_cnt{0};
-    unsigned long broad_cnt{0};
-
-    unsigned long cf_cnt{0};
+    auto current() -> EventCounts&;
 
-    unsigned long instr_cnt{0};
-    unsigned long cxt_cnt{0};
+    Shared &shared;
+    EventCounts counts;
+    std::unique_ptr<ThreadCounts> threads;
+    /* instead of 'counts' when reporting intervals,
+     * so each application thread gets its own rows */
 
   public:
+    Handler(BackendContext &context);
     virtual ~Handler() override;
 };
 
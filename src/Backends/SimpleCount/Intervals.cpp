@@ -0,0 +1,240 @@
+#include "Intervals.hpp"
+#include "Utils/PrismLog.hpp"
+#include <cstring>
+#include <type_traits>
+
+namespace SimpleCount
+{
+
+constexpr size_t CountsSnapshot::WORDS;
+static_assert(std::is_trivially_copyable<EventCounts>::value == true &&
+              sizeof(EventCounts) % sizeof(unsigned long) == 0,
+              "counts are published as words");
+
+
+auto CountsSnapshot::publish(const EventCounts &counts) -> void
+{
+    unsigned long raw[WORDS];
+    std::memcpy(raw, &counts, sizeof(raw));
+
+    /* odd while the words are being written */
+    auto s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < WORDS; ++i)
+        words[i].store(raw[i], std::memory_order_relaxed);
+    seq.store(s + 2, std::memory_order_release);
+}
+
+
+auto CountsSnapshot::read() const -> EventCounts
+{
+    unsigned long raw[WORDS];
+    while (true)
+    {
+        auto before = seq.load(std::memory_order_acquire);
+        if ((before & 1) == 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (size_t i = 0; i < WORDS; ++i)
+            raw[i] = words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (seq.load(std::memory_order_relaxed) == before)
+            break;
+    }
+
+    EventCounts counts;
+    std::memcpy(&counts, raw, sizeof(raw));
+    return counts;
+}
+
+
+auto writeIntervalHeader(FILE *file) -> bool
+{
+    return fputs("seconds,thread,instructions,instructions_per_s,memory_per_s,"
+                 "compute_per_s,sync_per_s,loads,stores,load_store_ratio,"
+                 "bytes_1,bytes_2,bytes_4,bytes_8,bytes_16,bytes_32,bytes_other\n",
+                 file) >= 0;
+}
+
+
+auto writeInterval(FILE *file, IntervalTime time, SyncID thread,
+                   const EventCounts &now, const EventCounts &last) -> bool
+{
+    auto rate = [&](unsigned long count)
+    {
+        return time.duration > 0 ? count / time.duration : 0.0;
+    };
+
+    unsigned long instrs = now.instr_cnt - last.instr_cnt;
+    unsigned long loads = now.read_cnt - last.read_cnt;
+    unsigned long stores = now.write_cnt - last.write_cnt;
+
+    /* no ratio without stores */
+    std::string ratio;
+    if (stores > 0)
+        ratio = std::to_string(static_cast<double>(loads) / stores);
+
+    bool ok = fprintf(file, "%.3f,%ld,%lu,%.1f,%.1f,%.1f,%.1f,%lu,%lu,%s",
+                      time.end, static_cast<long>(thread), instrs, rate(instrs),
+                      rate(now.mem_cnt - last.mem_cnt),
+                      rate(now.comp_cnt - last.comp_cnt),
+                      rate(now.sync_cnt - last.sync_cnt),
+                      loads, stores, ratio.c_str()) >= 0;
+    for (unsigned b = 0; b < EventCounts::SIZE_BUCKETS; ++b)
+        ok &= fprintf(file, ",%lu", now.size_cnt[b] - last.size_cnt[b]) >= 0;
+    return ok && fputs("\n", file) >= 0;
+}
+
+
+IntervalReporter::IntervalReporter(const std::string &path, Clock::duration period,
+                                   unsigned long instructions)
+    : file(fopen(path.c_str(), "w"), fclose)
+    , period(period)
+    , instructions(instructions)
+    , start(Clock::now())
+{
+    if (file == nullptr || writeIntervalHeader(file.get()) == false)
+        PrismLog::fatal("writing intervals: " + path);
+
+    reporter = std::thread(&IntervalReporter::run, this);
+}
+
+
+IntervalReporter::~IntervalReporter()
+{
+    stop();
+}
+
+
+auto IntervalReporter::add(SyncID thread) -> std::shared_ptr<CountsSnapshot>
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    threads.push_back(Thread{thread, std::make_shared<CountsSnapshot>(), {}, Clock::now()});
+    return threads.back().snapshot;
+}
+
+
+auto IntervalReporter::stop() -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (stopped == true)
+            return;
+        stopped = true;
+    }
+    cv.notify_one();
+    reporter.join();
+
+    std::lock_guard<std::mutex> lock(mtx);
+    report(true);
+}
+
+
+auto IntervalReporter::run() -> void
+{
+    /* instruction intervals are checked often, so they end close to on time */
+    auto wait = (instructions > 0 ? std::chrono::milliseconds(10) : period);
+
+    std::unique_lock<std::mutex> lock(mtx);
+    while (cv.wait_for(lock, wait, [&]{ return stopped; }) == false)
+        report(false);
+}
+
+
+auto IntervalReporter::report(bool final) -> void
+{
+    auto now = Clock::now();
+    IntervalTime time;
+    time.end = std::chrono::duration<double>(now - start).count();
+
+    for (auto &thread : threads)
+    {
+        auto counts = thread.snapshot->read();
+
+        if (final == false && instructions > 0 &&
+            counts.instr_cnt - thread.last.instr_cnt < instructions)
+            continue;
+
+        /* idle and finished threads have nothing to report */
+        if (counts.cxt_cnt == thread.last.cxt_cnt && counts.mem_cnt == thread.last.mem_cnt &&
+            counts.comp_cnt == thread.last.comp_cnt && counts.sync_cnt == thread.last.sync_cnt &&
+            counts.swap_cnt == thread.last.swap_cnt && counts.cf_cnt == thread.last.cf_cnt)
+            continue;
+
+        time.duration = std::chrono::duration<double>(now - thread.since).count();
+        if (writeInterval(file.get(), time, thread.thread, counts, thread.last) == false)
+            PrismLog::fatal("writing intervals");
+
+        thread.last = counts;
+        thread.since = now;
+    }
+    fflush(file.get());
+}
+
+
+
+constexpr SyncID ThreadCounts::NO_THREAD;
+
+
+auto ThreadCounts::count(const PrismEvVariant *events, size_t n) -> void
+{
+    size_t run = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (events[i].tag != PRISM_SYNC_TAG || events[i].sync.type != PRISM_SYNC_SWAP)
+            continue;
+
+        /* the swap itself is counted with the thread it names;
+         * nothing comes before a swap at the start of the buffer */
+        if (i > run)
+            countEvents(events + run, i - run, current(), true);
+        swap(events[i].sync.data[0]);
+        run = i;
+    }
+    if (n > run)
+        countEvents(events + run, n - run, current(), true);
+    publish();
+}
+
+
+auto ThreadCounts::swap(SyncID thread) -> void
+{
+    if (cur != nullptr)
+        cur->snapshot->publish(cur->counts);
+
+    auto it = threads.find(thread);
+    if (it == threads.end())
+        it = threads.emplace(thread, Thread{{}, reporter.add(thread)}).first;
+    cur = &it->second;
+}
+
+
+auto ThreadCounts::current() -> EventCounts&
+{
+    if (cur == nullptr)
+        swap(NO_THREAD);
+    return cur->counts;
+}
+
+
+auto ThreadCounts::publish() -> void
+{
+    if (cur != nullptr)
+        cur->snapshot->publish(cur->counts);
+}
+
+
+auto ThreadCounts::total() const -> EventCounts
+{
+    EventCounts total;
+    for (auto &p : threads)
+        total += p.second.counts;
+    return total;
+}
+
+}; //end namespace SimpleCount
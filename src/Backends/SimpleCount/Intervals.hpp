@@ -0,0 +1,138 @@
+#ifndef SIMPLECOUNT_INTERVALS_H
+#define SIMPLECOUNT_INTERVALS_H
+
+#include "EventCounts.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace SimpleCount
+{
+
+class CountsSnapshot
+{
+    /* The latest counts of one consumer, published without locks.
+     *
+     * The consumer is the only writer; a reader that overlaps a
+     * publish tries again (a sequence lock), so the consumer's
+     * event loop never waits on the reporter */
+  public:
+    auto publish(const EventCounts &counts) -> void;
+    auto read() const -> EventCounts;
+
+  private:
+    static constexpr size_t WORDS = sizeof(EventCounts) / sizeof(unsigned long);
+
+    std::atomic<unsigned long> seq{0};
+    std::array<std::atomic<unsigned long>, WORDS> words{};
+};
+
+
+/* Seconds since the start of reporting, and the duration of the interval */
+struct IntervalTime
+{
+    double end;
+    double duration;
+};
+
+/* seconds,thread,instructions,instructions_per_s,memory_per_s,
+ * compute_per_s,sync_per_s,loads,stores,load_store_ratio,
+ * bytes_1,bytes_2,bytes_4,bytes_8,bytes_16,bytes_32,bytes_other */
+auto writeIntervalHeader(FILE *file) -> bool;
+
+/* One row, of a thread's counts between 'last' and 'now' */
+auto writeInterval(FILE *file, IntervalTime time, SyncID thread,
+                   const EventCounts &now, const EventCounts &last) -> bool;
+
+
+class IntervalReporter
+{
+    /* Writes each thread's counts, as an interval CSV row, every 'period'
+     * or once the thread has run another 'instructions' since its last
+     * row. Threads are only read through their snapshots, which are at
+     * most one event buffer behind, so instruction intervals can overrun
+     * by up to a buffer */
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    IntervalReporter(const std::string &path, Clock::duration period,
+                     unsigned long instructions);
+    ~IntervalReporter();
+
+    /* each application thread, of each consumer, publishes to its own snapshot */
+    auto add(SyncID thread) -> std::shared_ptr<CountsSnapshot>;
+
+    /* write the rest of every interval and stop reporting */
+    auto stop() -> void;
+
+  private:
+    struct Thread
+    {
+        SyncID thread;
+        std::shared_ptr<CountsSnapshot> snapshot;
+        EventCounts last;
+        Clock::time_point since;
+    };
+
+    auto run() -> void;
+    auto report(bool final) -> void;
+
+    std::unique_ptr<FILE, int(*)(FILE*)> file;
+    Clock::duration period;
+    unsigned long instructions;
+    Clock::time_point start;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopped{false};
+    std::vector<Thread> threads;
+    std::thread reporter;
+};
+
+
+
+class ThreadCounts
+{
+    /* One consumer's counts, split by application thread.
+     *
+     * A consumer sees every thread of its event stream, and each swap
+     * event names the thread of the events that follow it. Each run
+     * between swaps is counted at once, into that thread's counts,
+     * which are published to the reporter after every buffer */
+  public:
+    static constexpr SyncID NO_THREAD = -1;
+    /* for events before the first swap */
+
+    ThreadCounts(IntervalReporter &reporter) : reporter(reporter) {}
+
+    auto count(const PrismEvVariant *events, size_t n) -> void;
+    auto swap(SyncID thread) -> void;
+    auto current() -> EventCounts&;
+    auto publish() -> void;
+
+    /* across every thread */
+    auto total() const -> EventCounts;
+
+  private:
+    struct Thread
+    {
+        EventCounts counts;
+        std::shared_ptr<CountsSnapshot> snapshot;
+    };
+
+    IntervalReporter &reporter;
+    std::unordered_map<SyncID, Thread> threads;
+    Thread *cur{nullptr};
+};
+
+}; //end namespace SimpleCount
+
+#endif
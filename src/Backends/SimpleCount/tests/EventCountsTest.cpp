@@ -0,0 +1,139 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "SimpleCount/EventCounts.hpp"
+#include <random>
+#include <vector>
+
+using namespace SimpleCount;
+
+namespace
+{
+
+auto randomEvents(size_t n) -> std::vector<PrismEvVariant>
+{
+    /* mostly memory, compute, and instructions, like a real event stream */
+    std::mt19937 gen(n);
+    std::uniform_int_distribution<int> kind(0, 99);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    std::vector<PrismEvVariant> events(n);
+    for (auto &ev : events)
+    {
+        /* garbage in the fields a histogram should ignore */
+        auto raw = reinterpret_cast<unsigned char*>(&ev);
+        for (size_t i = 0; i < sizeof(ev); ++i)
+            raw[i] = byte(gen);
+
+        int k = kind(gen);
+        if (k < 40)
+        {
+            ev.tag = PRISM_MEM_TAG;
+            ev.mem.type = (k % 2 == 0 ? PRISM_MEM_LOAD : PRISM_MEM_STORE);
+            if (k < 30)
+                ev.mem.size = 1 << (k % 7);
+        }
+        else if (k < 42)
+        {
+            ev.tag = PRISM_MEM_TAG;
+            ev.mem.type = (k % 2 == 0 ? PRISM_MEM_LOAD_COUNT : PRISM_MEM_STORE_COUNT);
+            ev.mem.count = byte(gen);
+        }
+        else if (k < 70)
+        {
+            ev.tag = PRISM_COMP_TAG;
+            ev.comp.type = k % 3; // including undefined
+        }
+        else if (k < 95)
+        {
+            ev.tag = PRISM_CXT_TAG;
+            ev.cxt.type = (k % 4 == 0 ? PRISM_CXT_FUNC_ENTER : PRISM_CXT_INSTR);
+        }
+        else if (k < 99)
+        {
+            ev.tag = PRISM_SYNC_TAG;
+            ev.sync.type = PRISM_SYNC_CREATE + k % 9;
+        }
+        else
+        {
+            ev.tag = PRISM_CF_TAG;
+        }
+    }
+    return events;
+}
+
+
+auto requireEqual(const EventCounts &l, const EventCounts &r) -> void
+{
+    REQUIRE(l.read_cnt == r.read_cnt);
+    REQUIRE(l.write_cnt == r.write_cnt);
+    REQUIRE(l.mem_cnt == r.mem_cnt);
+    REQUIRE(l.iop_cnt == r.iop_cnt);
+    REQUIRE(l.flop_cnt == r.flop_cnt);
+    REQUIRE(l.comp_cnt == r.comp_cnt);
+    REQUIRE(l.swap_cnt == r.swap_cnt);
+    REQUIRE(l.sync_cnt == r.sync_cnt);
+    REQUIRE(l.spawn_cnt == r.spawn_cnt);
+    REQUIRE(l.join_cnt == r.join_cnt);
+    REQUIRE(l.lock_cnt == r.lock_cnt);
+    REQUIRE(l.unlock_cnt == r.unlock_cnt);
+    REQUIRE(l.barrier_cnt == r.barrier_cnt);
+    REQUIRE(l.wait_cnt == r.wait_cnt);
+    REQUIRE(l.sig_cnt == r.sig_cnt);
+    REQUIRE(l.broad_cnt == r.broad_cnt);
+    REQUIRE(l.cf_cnt == r.cf_cnt);
+    REQUIRE(l.instr_cnt == r.instr_cnt);
+    REQUIRE(l.cxt_cnt == r.cxt_cnt);
+    for (unsigned b = 0; b < EventCounts::SIZE_BUCKETS; ++b)
+        REQUIRE(l.size_cnt[b] == r.size_cnt[b]);
+}
+
+}; //end namespace
+
+TEST_CASE("event counts", "[EventCounts]")
+{
+    SECTION("counted events")
+    {
+        std::vector<PrismEvVariant> events(3);
+        events[0].tag = PRISM_MEM_TAG;
+        events[0].mem.type = PRISM_MEM_LOAD;
+        events[0].mem.size = 8;
+        events[1].tag = PRISM_MEM_TAG;
+        events[1].mem.type = PRISM_MEM_STORE_COUNT;
+        events[1].mem.count = 5;
+        events[2].tag = PRISM_SYNC_TAG;
+        events[2].sync.type = PRISM_SYNC_SWAP;
+
+        EventCounts counts;
+        countEvents(events.data(), events.size(), counts, true);
+        REQUIRE(counts.read_cnt == 1);
+        REQUIRE(counts.write_cnt == 5);
+        REQUIRE(counts.mem_cnt == 6);
+        REQUIRE(counts.swap_cnt == 1);
+        REQUIRE(counts.sync_cnt == 0);
+
+        /* counted accesses have no size */
+        REQUIRE(counts.size_cnt[3] == 1);
+        REQUIRE(counts.size_cnt[EventCounts::SIZE_BUCKETS - 1] == 5);
+    }
+
+    SECTION("the AVX2 histogram matches the scalar one")
+    {
+        /* whole blocks of eight events, and leftovers */
+        for (size_t n : {0, 7, 8, 9, 4096, 4099})
+        {
+            auto events = randomEvents(n);
+
+            EventCounts scalar;
+            countEventsScalar(events.data(), n, scalar);
+
+            EventCounts avx2;
+            countEventsAVX2(events.data(), n, avx2, true);
+            requireEqual(scalar, avx2);
+
+            EventCounts dispatched;
+            countEvents(events.data(), n, dispatched, true);
+            requireEqual(scalar, dispatched);
+        }
+    }
+}
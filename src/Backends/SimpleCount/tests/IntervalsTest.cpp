@@ -0,0 +1,187 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "SimpleCount/Intervals.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace SimpleCount;
+
+namespace
+{
+
+auto lines(const std::string &path) -> std::vector<std::string>
+{
+    std::ifstream file(path);
+    std::vector<std::string> ret;
+    for (std::string line; std::getline(file, line);)
+        ret.push_back(line);
+    return ret;
+}
+
+
+auto fields(const std::string &line) -> std::vector<std::string>
+{
+    std::istringstream row(line);
+    std::vector<std::string> ret;
+    for (std::string field; std::getline(row, field, ',');)
+        ret.push_back(field);
+    return ret;
+}
+
+}; //end namespace
+
+TEST_CASE("interval reporting", "[Intervals]")
+{
+    SECTION("snapshots are consistent while being published")
+    {
+        CountsSnapshot snapshot;
+        std::atomic<bool> done{false};
+
+        /* every count of a published snapshot is the same */
+        std::thread consumer([&]
+        {
+            EventCounts counts;
+            for (unsigned long i = 1; i <= 200000; ++i)
+            {
+                counts.read_cnt = counts.write_cnt = counts.instr_cnt = i;
+                counts.size_cnt[EventCounts::SIZE_BUCKETS - 1] = i;
+                snapshot.publish(counts);
+            }
+            done = true;
+        });
+
+        unsigned long last = 0;
+        while (done == false)
+        {
+            auto counts = snapshot.read();
+            REQUIRE(counts.read_cnt == counts.write_cnt);
+            REQUIRE(counts.read_cnt == counts.instr_cnt);
+            REQUIRE(counts.read_cnt == counts.size_cnt[EventCounts::SIZE_BUCKETS - 1]);
+            REQUIRE(counts.read_cnt >= last);
+            last = counts.read_cnt;
+        }
+        consumer.join();
+        REQUIRE(snapshot.read().read_cnt == 200000);
+    }
+
+    SECTION("a row is the difference between two snapshots")
+    {
+        EventCounts last, now;
+        last.instr_cnt = 100;
+        now.instr_cnt = 300;
+        now.read_cnt = 30;
+        now.write_cnt = 10;
+        now.mem_cnt = 40;
+        now.sync_cnt = 2;
+        now.size_cnt[2] = 40;
+
+        char *buf = nullptr;
+        size_t size = 0;
+        FILE *file = open_memstream(&buf, &size);
+        REQUIRE(writeInterval(file, IntervalTime{3.0, 2.0}, 1, now, last) == true);
+        fclose(file);
+
+        auto row = fields(std::string(buf, size));
+        free(buf);
+        REQUIRE(row.size() == 17);
+        REQUIRE(row[1] == "1");
+        REQUIRE(row[2] == "200");
+        REQUIRE(std::stod(row[3]) == 100.0);
+        REQUIRE(std::stod(row[4]) == 20.0);
+        REQUIRE(std::stod(row[6]) == 1.0);
+        REQUIRE(row[7] == "30");
+        REQUIRE(row[8] == "10");
+        REQUIRE(std::stod(row[9]) == 3.0);
+        REQUIRE(row[12] == "40");
+    }
+
+    SECTION("each thread gets a row per interval of instructions")
+    {
+        std::string path = "simplecount.intervals.test.csv";
+        {
+            IntervalReporter reporter(path, IntervalReporter::Clock::duration::zero(), 1000);
+            auto first = reporter.add(7);
+            auto second = reporter.add(3);
+
+            EventCounts counts;
+            counts.cxt_cnt = counts.instr_cnt = 1500;
+            first->publish(counts);
+
+            /* until it is reported, then too few for another interval */
+            while (lines(path).size() < 2)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            counts.cxt_cnt = counts.instr_cnt = 1600;
+            first->publish(counts);
+
+            counts.cxt_cnt = counts.instr_cnt = 10;
+            second->publish(counts);
+            reporter.stop();
+        }
+
+        /* the rest of each interval is written at the end */
+        auto rows = lines(path);
+        REQUIRE(rows.size() == 4);
+        REQUIRE(fields(rows[1])[1] == "7");
+        REQUIRE(fields(rows[1])[2] == "1500");
+        REQUIRE(fields(rows[2])[1] == "7");
+        REQUIRE(fields(rows[2])[2] == "100");
+        REQUIRE(fields(rows[3])[1] == "3");
+        REQUIRE(fields(rows[3])[2] == "10");
+        std::remove(path.c_str());
+    }
+
+    SECTION("one consumer's events are split by the thread of each swap")
+    {
+        std::string path = "simplecount.intervals.test.csv";
+        {
+            IntervalReporter reporter(path, std::chrono::hours(1), 0);
+            ThreadCounts threads(reporter);
+
+            std::vector<PrismEvVariant> events;
+            auto instr = [&]
+            {
+                PrismEvVariant ev{};
+                ev.tag = PRISM_CXT_TAG;
+                ev.cxt.type = PRISM_CXT_INSTR;
+                events.push_back(ev);
+            };
+            auto swap = [&](SyncID tid)
+            {
+                PrismEvVariant ev{};
+                ev.tag = PRISM_SYNC_TAG;
+                ev.sync.type = PRISM_SYNC_SWAP;
+                ev.sync.data[0] = tid;
+                events.push_back(ev);
+            };
+
+            swap(1);
+            instr();
+            instr();
+            swap(2);
+            instr();
+            threads.count(events.data(), events.size());
+
+            /* a thread carries over to the next buffer */
+            events.clear();
+            instr();
+            swap(1);
+            instr();
+            threads.count(events.data(), events.size());
+
+            auto total = threads.total();
+            REQUIRE(total.instr_cnt == 5);
+            REQUIRE(total.swap_cnt == 3);
+            reporter.stop();
+        }
+
+        auto rows = lines(path);
+        REQUIRE(rows.size() == 3);
+        REQUIRE(fields(rows[1])[1] == "1");
+        REQUIRE(fields(rows[1])[2] == "3");
+        REQUIRE(fields(rows[2])[1] == "2");
+        REQUIRE(fields(rows[2])[2] == "2");
+        std::remove(path.c_str());
+    }
+}
@@ -2,13 +2,20 @@
 #define STGEN_BARRIER_MERGE_H
 
 #include "STTypes.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 /*****************************************************************************
  * Merge per-barrier statistics across threads.
  *
  * Each thread holds a list of aggregate stats for each barrier it comes across.
  * Because the barriers may not line up nicely between threads,
- * we do some ugly merging
+ * barrier regions are aligned by key instead of by position
  *****************************************************************************/
 
 
@@ -17,132 +24,253 @@ namespace STGen
 
 struct BarrierMerge
 {
-    /* Find the first element of 'from', that matches 'to'.
-     * Merge the first matching nodes, and insert all other
-     * nodes up to that point in 'from'. Continue until no
-     * nodes are left to merge
+    /* The k-th time a thread waits on a barrier is matched with the k-th time
+     * every other thread waits on that same barrier, i.e. regions are keyed on
+     * (barrier address, occurrence). Stats with the same key are summed.
      *
-     * For example, the following barriers may need to be merged:
-     * Assume barrier attributes (thread count) does not change.
-     * Tried to create sufficiently complex example...
+     * The merged list is ordered so that every thread's own barrier order is kept
+     * (a topological order of the per-thread sequences). Barriers that no thread
+     * orders relative to each other are placed by where they first appear,
+     * scanning the threads in the order given.
+     *
+     * For example, the following barriers are merged:
      *
      * T1  T2  T3  T4    Merged
-     * B1      B1
-     * B2  B2  B2  B2
-     * B2  B2  B2  B2
-     * B3      B3
-     * B2  B2  B2  B2
-     * B4          B4
-     * -----------------------
-     * T1  T2  T3  T4    Merged
-     * B1      B1
-     * B2  B2  B2          B2 <- this is the head
-     * B2  B2  B2          B2 <- important to keep these separate
-     * B3      B3                |   from previous barrier
-     * B2  B2  B2          B2 <--+
-     * B4                  B4
-     * -----------------------
-     * T1  T2  T3  T4    Merged
-     * B1                  B1
-     * B2  B2              B2 <- B2 found first for T3, insert B1 before
-     * B2  B2              B2 <- B2 should merge with same level
-     * B3                  B3 <- put after last inserted/merged (B2),
-     * B2  B2              B2 <- matched after last inserted/merged (B3)
-     * B4                  B4
-     * ------------------------
-     * T1  T2  T3  T4    Merged
-     * B1                  B1
-     * B2                  B2 <- B2 easily found, merged
-     * B2                  B2 <- should merge with same level
-     * B3                  B3    |
-     * B2                  B2 <--+
-     * B4                  B4
-     * ------------------------
-     * T1  T2  T3  T4    Merged
-     *                     B1
-     *                     B2
-     *                     B2
-     *                     B3
-     *                     B2
-     *                     B4
+     * B1      B1        B1     (B1,1)
+     * B2  B2  B2  B2    B2     (B2,1)
+     * B2  B2  B2  B2    B2     (B2,2)
+     * B3      B3        B3     (B3,1)
+     * B2  B2  B2  B2    B2     (B2,3)
+     * B4          B4    B4     (B4,1)
      *
-     * If someone comes up with counter examples, please fix :)
-     * This is non-exhaustive
-     */
-
-    using BarrierIt = AllBarriersStats::iterator;
-    using ConstBarrierIt = AllBarriersStats::const_iterator;
-
-    struct FromState
-    {
-        ConstBarrierIt begin;
-        ConstBarrierIt current;
-        ConstBarrierIt end;
-    };
-
-    struct ToState
-    {
-        BarrierIt current;
-        BarrierIt previous;
-        AllBarriersStats &mergedStats;
-    };
+     * If threads disagree on the order (e.g. T1 waits on B1 then B2,
+     * and T2 waits on B2 then B1), the earliest appearing barrier goes first.
+     *
+     * Keying each thread and summing each key are done in parallel;
+     * ordering is O(n log n) in the number of distinct keys */
 
+    using ThreadBarriers = std::vector<const AllBarriersStats*>;
 
     static auto merge(const AllBarriersStats &from, AllBarriersStats &to) -> void
     {
+        /* merge one more thread into an already merged list */
         if (from.empty())
             return;
 
         if (to.empty())
             return (void)(to = from);
 
-        merge({from.begin(), from.begin(), from.end()},
-              {to.begin(), to.end(), to});
+        to = merge({&to, &from});
     }
 
-    static auto merge(FromState from, ToState to) -> void
+    static auto merge(const ThreadBarriers &threads, unsigned workers = 1) -> AllBarriersStats
     {
-        /* nothing left */
-        if (from.begin == from.end)
-            return;
+        workers = std::max(1U, workers);
+        auto keys = keyThreads(threads, workers);
+        auto merged = sumKeys(threads, keys, workers);
+        return orderKeys(keys, merged);
+    }
 
-        /* no matches found previously */
-        if (from.current == from.end)
+  private:
+    struct Key
+    {
+        Addr barrier;
+        unsigned occurrence;
+        bool operator==(const Key &other) const
         {
-            to.mergedStats.insert(to.previous, from.begin, from.end);
-            return;
+            return barrier == other.barrier && occurrence == other.occurrence;
         }
+    };
 
-        auto match = findMatchTo(from.current, to.current, to.mergedStats.end());
-        if (match == to.mergedStats.end())
+    struct KeyHash
+    {
+        auto operator()(const Key &key) const -> size_t
         {
-            ++from.current;
-            merge(from, to);
+            return std::hash<Addr>()(key.barrier) * 31 + key.occurrence;
         }
-        else /* matched a barrier */
+    };
+
+    struct ThreadKeys
+    {
+        std::vector<Key> keys;
+        std::vector<unsigned> ids;
+        /* per region of one thread, in order: its key, and the key's merged ID */
+
+        std::vector<std::vector<unsigned>> shards;
+        /* positions of the regions, by the shard that owns their key */
+    };
+
+    struct Merged
+    {
+        std::vector<Addr> barrier;
+        std::vector<BarrierStats> stats;
+        std::vector<uint64_t> firstSeen;
+        /* per merged ID */
+    };
+
+    static auto parallelFor(size_t count, unsigned workers,
+                            const std::function<void(size_t)> &work) -> void
+    {
+        std::atomic<size_t> next{0};
+        auto loop = [&] {
+            for (size_t i = next++; i < count; i = next++)
+                work(i);
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < std::min<size_t>(workers, count); ++i)
+            pool.emplace_back(loop);
+        loop();
+        for (auto &thread : pool)
+            thread.join();
+    }
+
+    static auto keyThreads(const ThreadBarriers &threads,
+                           unsigned shards) -> std::vector<ThreadKeys>
+    {
+        /* number each thread's visits to each barrier */
+        std::vector<ThreadKeys> keys(threads.size());
+        parallelFor(threads.size(), shards, [&](size_t t) {
+            auto &thread = keys[t];
+            thread.shards.resize(shards);
+            thread.keys.reserve(threads[t]->size());
+            thread.ids.resize(threads[t]->size());
+
+            std::unordered_map<Addr, unsigned> seen;
+            for (auto &region : *threads[t])
+            {
+                Key key{region.first, seen[region.first]++};
+                thread.shards[KeyHash()(key) % shards].push_back(thread.keys.size());
+                thread.keys.push_back(key);
+            }
+        });
+        return keys;
+    }
+
+    static auto sumKeys(const ThreadBarriers &threads, std::vector<ThreadKeys> &keys,
+                        unsigned shards) -> Merged
+    {
+        /* each shard sums the stats of the keys it owns, across all threads */
+        std::vector<Merged> partial(shards);
+        parallelFor(shards, shards, [&](size_t s) {
+            std::unordered_map<Key, unsigned, KeyHash> ids;
+            auto &merged = partial[s];
+            for (size_t t = 0; t < threads.size(); ++t)
+            {
+                if (keys[t].shards[s].empty())
+                    continue;
+
+                /* positions in a shard are increasing, so walk the list once */
+                auto region = threads[t]->cbegin();
+                size_t at = 0;
+                for (auto pos : keys[t].shards[s])
+                {
+                    std::advance(region, pos - at);
+                    at = pos;
+
+                    auto &key = keys[t].keys[pos];
+                    auto inserted = ids.emplace(key, merged.stats.size());
+                    if (inserted.second == true)
+                    {
+                        merged.barrier.push_back(key.barrier);
+                        merged.stats.emplace_back();
+                        merged.firstSeen.push_back((static_cast<uint64_t>(t) << 32) | pos);
+                    }
+                    merged.stats[inserted.first->second] += region->second;
+                    keys[t].ids[pos] = inserted.first->second;
+                }
+            }
+        });
+
+        /* shard-local IDs to merged IDs */
+        std::vector<unsigned> offset(shards + 1, 0);
+        for (unsigned s = 0; s < shards; ++s)
+            offset[s + 1] = offset[s] + partial[s].stats.size();
+        parallelFor(threads.size(), shards, [&](size_t t) {
+            for (unsigned s = 0; s < shards; ++s)
+                for (auto pos : keys[t].shards[s])
+                    keys[t].ids[pos] += offset[s];
+        });
+
+        Merged merged;
+        for (auto &part : partial)
         {
-            /* merge current and insert any previous barriers */
-            match->second += from.current->second;
-            if (from.begin != from.current)
-                to.mergedStats.insert(match, from.begin, from.current);
-
-            /* continue with the rest of the barriers */
-            assert(match != to.mergedStats.end());
-            to.previous = ++match;
-            to.current = to.previous;
-
-            ++from.current;
-            from.begin = from.current;
-            merge(from, to);
+            merged.barrier.insert(merged.barrier.end(), part.barrier.begin(), part.barrier.end());
+            merged.stats.insert(merged.stats.end(), part.stats.begin(), part.stats.end());
+            merged.firstSeen.insert(merged.firstSeen.end(),
+                                    part.firstSeen.begin(), part.firstSeen.end());
         }
+        return merged;
     }
 
-    static auto findMatchTo(ConstBarrierIt from, BarrierIt to, BarrierIt toEnd) -> BarrierIt
+    static auto orderKeys(const std::vector<ThreadKeys> &keys,
+                          const Merged &merged) -> AllBarriersStats
     {
-        if (from->first == to->first || to == toEnd)
-            return to;
-        else
-            return findMatchTo(from, ++to, toEnd);
+        /* Kahn's algorithm over 'a comes right before b in some thread',
+         * always taking the earliest seen ready key */
+        size_t nodes = merged.stats.size();
+        std::vector<unsigned> edgeBegin(nodes + 1, 0);
+        std::vector<unsigned> inDegree(nodes, 0);
+        for (auto &thread : keys)
+            for (size_t i = 1; i < thread.ids.size(); ++i)
+                ++edgeBegin[thread.ids[i - 1] + 1];
+        for (size_t n = 0; n < nodes; ++n)
+            edgeBegin[n + 1] += edgeBegin[n];
+
+        std::vector<unsigned> edges(edgeBegin.back());
+        std::vector<unsigned> fill(edgeBegin.begin(), edgeBegin.end() - 1);
+        for (auto &thread : keys)
+        {
+            for (size_t i = 1; i < thread.ids.size(); ++i)
+            {
+                edges[fill[thread.ids[i - 1]]++] = thread.ids[i];
+                ++inDegree[thread.ids[i]];
+            }
+        }
+
+        auto later = [&](unsigned a, unsigned b) {
+            return merged.firstSeen[a] > merged.firstSeen[b];
+        };
+        std::priority_queue<unsigned, std::vector<unsigned>, decltype(later)> ready(later);
+        for (unsigned n = 0; n < nodes; ++n)
+            if (inDegree[n] == 0)
+                ready.push(n);
+
+        /* if the threads disagree on the order, there is a cycle;
+         * break it at the earliest seen key that is left */
+        std::vector<unsigned> bySeen(nodes);
+        for (unsigned n = 0; n < nodes; ++n)
+            bySeen[n] = n;
+        std::sort(bySeen.begin(), bySeen.end(),
+                  [&](unsigned a, unsigned b) { return later(b, a); });
+        auto nextSeen = bySeen.cbegin();
+
+        AllBarriersStats ordered;
+        std::vector<bool> done(nodes, false);
+        while (ordered.size() < nodes)
+        {
+            unsigned n;
+            if (ready.empty() == false)
+            {
+                n = ready.top();
+                ready.pop();
+                if (done[n] == true)
+                    continue;
+            }
+            else
+            {
+                while (done[*nextSeen] == true)
+                    ++nextSeen;
+                n = *nextSeen;
+            }
+
+            done[n] = true;
+            ordered.emplace_back(merged.barrier[n], merged.stats[n]);
+            for (auto e = edgeBegin[n]; e < edgeBegin[n + 1]; ++e)
+                if (--inDegree[edges[e]] == 0 && done[edges[e]] == false)
+                    ready.push(edges[e]);
+        }
+        return ordered;
     }
 };
 
@@ -172,6 +172,14 @@ CapnLoggerCompressed::~CapnLoggerCompressed()
 
 
 auto CapnLoggerCompressed::flush(const STCompEventCompressed& ev, EID eid, TID tid) -> void
+{
+    flushRepeat(ev, 1, 0, eid, tid);
+}
+
+
+auto CapnLoggerCompressed::flushRepeat(const STCompEventCompressed& ev,
+                                       unsigned repeat, int64_t stride,
+                                       EID eid, TID tid) -> void
 {
     (void)eid;
     (void)tid;
@@ -194,7 +202,7 @@ auto CapnLoggerCompressed::flush(const STCompEventCompressed& ev, EID eid, TID t
         rangeBuilder.setEnd(p.second);
     }
 
-    auto &readsRange = ev.uniqueWriteAddrs.get();
+    auto &readsRange = ev.uniqueReadAddrs.get();
     auto numReadRanges = readsRange.size();
     auto readAddrBuilder = comp.initReadAddrs(numReadRanges);
     size_t j = 0;
@@ -205,6 +213,13 @@ auto CapnLoggerCompressed::flush(const STCompEventCompressed& ev, EID eid, TID t
         rangeBuilder.setEnd(p.second);
     }
 
+    /* a single event leaves the repeat fields at their defaults */
+    if (repeat > 1)
+    {
+        comp.setRepeat(repeat);
+        comp.setStride(stride);
+    }
+
     orphans.emplace_back(std::move(orphan));
     flushOrphansOnMaxEvents();
 }
@@ -222,6 +237,7 @@ auto CapnLoggerCompressed::flush(const STCommEventCompressed& ev, EID eid, TID t
         auto &edge = ev.comms[i];
         commEdgesBuilder[i].setProducerThread(std::get<0>(edge));
         commEdgesBuilder[i].setProducerEvent(std::get<1>(edge));
+        commEdgesBuilder[i].setProducerEventHigh(std::get<1>(edge) >> 32);
 
         auto &ranges = std::get<2>(edge).get();
         auto edgesBuilder = commEdgesBuilder[i].initAddrs(ranges.size());
@@ -352,6 +368,7 @@ auto CapnLoggerUncompressed::flush(EID producerEID, TID producerTID, Addr start,
     auto orphan = orphanage->getOrphanage().newOrphan<Event>();
     auto commBuilder = orphan.get().initComm();
     commBuilder.setProducerEvent(producerEID);
+    commBuilder.setProducerEventHigh(producerEID >> 32);
     commBuilder.setProducerThread(producerTID);
     commBuilder.setStartAddr(start);
     commBuilder.setEndAddr(end);
@@ -32,6 +32,8 @@ class CapnLoggerCompressed : public STLoggerCompressed
     ~CapnLoggerCompressed() override final;
 
     auto flush(const STCompEventCompressed& ev, EID eid, TID tid) -> void override final;
+    auto flushRepeat(const STCompEventCompressed& ev, unsigned repeat, int64_t stride,
+                     EID eid, TID tid) -> void override final;
     auto flush(const STCommEventCompressed& ev, EID eid, TID tid) -> void override final;
     auto flush(unsigned char syncType, unsigned numArgs, Addr *syncArgs,
                EID eid, TID tid) -> void override final;
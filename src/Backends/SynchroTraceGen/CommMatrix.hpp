@@ -0,0 +1,163 @@
+#ifndef STGEN_COMM_MATRIX_H
+#define STGEN_COMM_MATRIX_H
+
+#include "STShadowMemory.hpp"
+#include "STTypes.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace STGen
+{
+
+class CommLog
+{
+    /* The producer x consumer byte matrix, over time, as CSV:
+     *
+     * window,producer,consumer,bytes
+     *
+     * one line per non-zero entry. Each consumer writes its row of a window,
+     * sorted by producer, as soon as the window closes, so nothing is kept
+     * past a window. Windows of different threads close at different times,
+     * so the file is not sorted by window; readers that need that order
+     * sort it themselves.
+     *
+     * One log is shared by every thread. Write errors are reported by close(),
+     * which is called once every thread has closed its last window */
+  public:
+    CommLog(const std::string &outputPath)
+        : path(outputPath + "/sigil.comm.csv")
+        , file(fopen(path.c_str(), "w"))
+    {
+        if (file == nullptr || fputs("window,producer,consumer,bytes\n", file) < 0)
+            fatal("opening communication matrix: " + path);
+    }
+    CommLog(const CommLog &) = delete;
+    CommLog &operator=(const CommLog &) = delete;
+    ~CommLog()
+    {
+        if (file != nullptr)
+            fclose(file);
+    }
+
+    auto add(unsigned window, TID consumer,
+             std::vector<std::pair<TID, StatCounter>> row) -> void
+    {
+        std::sort(row.begin(), row.end());
+
+        std::lock_guard<std::mutex> lock(mtx);
+        assert(file != nullptr);
+        for (auto &entry : row)
+            if (fprintf(file, "%u,%d,%d,%llu\n", window, entry.first, consumer, entry.second) < 0)
+                failed = true;
+    }
+
+    auto close() -> void
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (file == nullptr)
+            return;
+        if (fclose(file) != 0)
+            failed = true;
+        file = nullptr;
+        if (failed == true)
+            fatal("writing communication matrix: " + path);
+    }
+
+  private:
+    std::string path;
+    FILE *file;
+    bool failed{false};
+    std::mutex mtx;
+};
+
+
+class CommMatrix
+{
+    /* One consumer thread's row of the communication matrix:
+     * bytes read by this thread that were last written by each producer thread.
+     *
+     * Only the consumer thread updates its row, so counting needs no locks;
+     * the row is handed to the shared log and cleared when a window closes,
+     * either every 'window' instructions of this thread, or at each barrier.
+     *
+     * Instruction windows follow each thread's own instructions, not a
+     * global clock, so window 'k' of two threads may not overlap in time.
+     * Barrier regions line up across threads that wait at every barrier */
+  public:
+    static constexpr unsigned PER_BARRIER = UINT_MAX;
+
+    CommMatrix(TID consumer, unsigned window, unsigned firstWindow,
+               std::shared_ptr<CommLog> log)
+        : consumer(consumer)
+        , window(window)
+        , current(firstWindow)
+        , log(std::move(log))
+        , bytes(MAX_THREADS, 0)
+    {
+        assert(window > 0);
+    }
+    CommMatrix(const CommMatrix &) = delete;
+    CommMatrix &operator=(const CommMatrix &) = delete;
+    ~CommMatrix() { close(); }
+
+    auto onComm(TID producer, StatCounter count) -> void
+    {
+        assert(producer >= 0 && producer < MAX_THREADS);
+        if (bytes[producer] == 0)
+            producers.push_back(producer);
+        bytes[producer] += count;
+    }
+
+    auto onInstr() -> void
+    {
+        if (window != PER_BARRIER && ++instrs == window)
+        {
+            instrs = 0;
+            close();
+        }
+    }
+
+    auto onBarrier() -> void
+    {
+        if (window == PER_BARRIER)
+            close();
+    }
+
+  private:
+    auto close() -> void
+    {
+        if (producers.empty() == false)
+        {
+            std::vector<std::pair<TID, StatCounter>> row;
+            row.reserve(producers.size());
+            for (auto producer : producers)
+            {
+                row.emplace_back(producer, bytes[producer]);
+                bytes[producer] = 0;
+            }
+            producers.clear();
+
+            log->add(current, consumer, std::move(row));
+        }
+        ++current;
+    }
+
+    TID consumer;
+    unsigned window;
+    unsigned current;
+    unsigned instrs{0};
+    std::shared_ptr<CommLog> log;
+
+    std::vector<StatCounter> bytes;
+    std::vector<TID> producers;
+    /* bytes per producer in the current window, and the producers seen so far */
+};
+
+}; //end namespace STGen
+
+#endif
@@ -1,4 +1,5 @@
 #include "EventHandlers.hpp"
+#include "RegionOfInterest.hpp"
 #include "STTypes.hpp"
 #include "TextLogger.hpp"
 #include <cassert>
@@ -8,27 +9,28 @@ namespace STGen
 {
 
 STShadowMemory ThreadContext::shadow;
+std::atomic<unsigned> ThreadContext::maxBarriers{0};
 
 template <class TCxtType>
 auto ThreadContextGenerator(TID tid,
-                            unsigned primsPerStCompEv,
-                            std::string outputPath,
-                            std::string loggerType) -> std::unique_ptr<ThreadContext>
+                            const ThreadContextOptions &options) -> std::unique_ptr<ThreadContext>
 {
-    return std::make_unique<TCxtType>(tid, primsPerStCompEv, outputPath, loggerType);
+    return std::make_unique<TCxtType>(tid, options);
 }
 using TCxtGenerator = std::function<decltype(ThreadContextGenerator<ThreadContextCompressed>)>;
 
 /* Global to all threads */
 namespace
 {
-std::string outputPath{"."};
-unsigned primsPerStCompEv{100};
-std::string loggerType;
+ThreadContextOptions tcxtOptions;
 TCxtGenerator genTCxt;
+std::unique_ptr<RegionOfInterest> region;
+StatCounter sampleDetail{0};
+StatCounter samplePeriod{0};
 
 std::mutex gMtx;
 ThreadStatMap allThreadsStats;
+ThreadSegmentMap allThreadsSegments;
 SpawnList threadSpawns;
 ThreadList newThreadsInOrder;
 BarrierList barrierParticipants;
@@ -47,7 +49,17 @@ auto EventHandlers::onSyncEv(const prism::SyncEvent &ev) -> void
         return onSwapTCxt(syncID);
     else if (syncType == SyncTypeEnum::PRISM_SYNC_CREATE)
         onCreate(syncID);
-    else if (syncType == SyncTypeEnum::PRISM_SYNC_BARRIER)
+    /* spawns are kept even outside the region of interest,
+     * so threads created during the warm-up are still known */
+
+    StatCounter barrier = 0;
+    if (syncType == SyncTypeEnum::PRISM_SYNC_BARRIER)
+        barrier = ++threadBarriers[currentTID];
+
+    if (region->onSync(syncID, barrier) == false)
+        return;
+
+    if (syncType == SyncTypeEnum::PRISM_SYNC_BARRIER)
         onBarrier(syncID);
 
     convertAndFlush(ev);
@@ -58,6 +70,9 @@ auto EventHandlers::onSyncEv(const prism::SyncEvent &ev) -> void
 /** Compute Event Handling **/
 auto EventHandlers::onCompEv(const prism::CompEvent &ev) -> void
 {
+    if (region->isActive() == false || cachedWindow->detailed == false)
+        return;
+
     if (ev.isIOP())
         cachedTCxt->onIop();
     else if (ev.isFLOP())
@@ -69,6 +84,16 @@ auto EventHandlers::onCompEv(const prism::CompEvent &ev) -> void
 /** Memory Event Handling **/
 auto EventHandlers::onMemEv(const prism::MemEvent &ev) -> void
 {
+    if (region->isActive() == false)
+        return;
+
+    if (cachedWindow->detailed == false)
+    {
+        if (ev.isStore())
+            cachedTCxt->onSkippedWrite(ev.addr(), ev.bytes());
+        return;
+    }
+
     if (ev.isLoad())
         cachedTCxt->onRead(ev.addr(), ev.bytes());
     else if (ev.isStore())
@@ -80,8 +105,13 @@ auto EventHandlers::onMemEv(const prism::MemEvent &ev) -> void
 /** Context Event Handling (instructions) **/
 auto EventHandlers::onCxtEv(const prism::CxtEvent &ev) -> void
 {
-    if (ev.type() == CxtTypeEnum::PRISM_CXT_INSTR)
-        cachedTCxt->onInstr();
+    if (ev.type() != CxtTypeEnum::PRISM_CXT_INSTR || region->onInstr() == false)
+        return;
+
+    if (samplePeriod > 0 && sample() == false)
+        cachedTCxt->onSkippedInstr(ev.id());
+    else
+        cachedTCxt->onInstr(ev.id());
 }
 
 
@@ -91,16 +121,25 @@ EventHandlers::~EventHandlers()
 {
     std::lock_guard<std::mutex> lock(gMtx);
     for (auto& p : tcxts)
+    {
+        if (samplePeriod > 0)
+            p.second->endSample();
         allThreadsStats.emplace(p.first, p.second->getStats());
+        allThreadsSegments.emplace(p.first, p.second->getSegments());
+    }
 }
 
 
 auto onExit() -> void
 {
     std::lock_guard<std::mutex> lock(gMtx);
-    flushPthread(outputPath + "/sigil.pthread.out", newThreadsInOrder,
+    flushPthread(tcxtOptions.outputPath + "/sigil.pthread.out", newThreadsInOrder,
                  threadSpawns, barrierParticipants);
-    flushStats(outputPath + "/sigil.stats.out", allThreadsStats);
+    flushStats(tcxtOptions.outputPath + "/sigil.stats.out", allThreadsStats);
+    if (tcxtOptions.barriersPerSegment > 0)
+        flushSegments(tcxtOptions.outputPath + "/sigil.segments.out", allThreadsSegments);
+    if (tcxtOptions.commLog != nullptr)
+        tcxtOptions.commLog->close();
 }
 
 
@@ -120,8 +159,7 @@ auto EventHandlers::onSwapTCxt(TID newTID) -> void
             newThreadsInOrder.push_back(newTID);
             tcxts.emplace(std::piecewise_construct,
                           std::forward_as_tuple(newTID),
-                          std::forward_as_tuple(genTCxt(newTID, primsPerStCompEv,
-                                                        outputPath, loggerType)));
+                          std::forward_as_tuple(genTCxt(newTID, tcxtOptions)));
         }
 
         if (cachedTCxt != nullptr)
@@ -130,6 +168,7 @@ auto EventHandlers::onSwapTCxt(TID newTID) -> void
         currentTID = newTID;
         assert(tcxts.find(currentTID) != tcxts.cend());
         cachedTCxt = tcxts.at(currentTID).get();
+        cachedWindow = &sampleWindows[currentTID];
     }
 
     assert(currentTID = newTID);
@@ -160,6 +199,27 @@ auto EventHandlers::onBarrier(Addr data) -> void
         barrierParticipants[idx].second.insert(currentTID);
 }
 
+auto EventHandlers::sample() -> bool
+{
+    /* Each thread alternates between a detailed window of 'sampleDetail'
+     * instructions and a fast-forward window, every 'samplePeriod' instructions.
+     * Returns if this instruction is in a detailed window */
+    auto &window = *cachedWindow;
+    if (window.position == 0)
+    {
+        window.detailed = true;
+    }
+    else if (window.position == sampleDetail)
+    {
+        cachedTCxt->endSample();
+        window.detailed = false;
+    }
+
+    if (++window.position == samplePeriod)
+        window.position = 0;
+    return window.detailed;
+}
+
 auto EventHandlers::convertAndFlush(const prism::SyncEvent &ev) -> void
 {
     /* Convert sync type to SynchroTrace's expected value
@@ -207,7 +267,7 @@ auto EventHandlers::convertAndFlush(const prism::SyncEvent &ev) -> void
         stSyncType = 4;
         break;
     case ::PRISM_SYNC_BARRIER:
-        stSyncType = 5;
+        stSyncType = ST_SYNC_BARRIER;
         break;
     case ::PRISM_SYNC_CONDWAIT:
         stSyncType = 6;
@@ -326,6 +386,155 @@ auto parseCompression(std::string compression) -> int
 }
 
 
+auto parseBarriersPerSegment(std::string barriers) -> unsigned
+{
+    if (barriers.empty() == true)
+        return 0; // default, one segment per thread
+
+    try
+    {
+        int ret = std::stoi(barriers);
+        if (ret < 0)
+            fatal("SynchroTraceGen barriers per segment: invalid argument");
+        return ret;
+    }
+    catch (std::exception &e)
+    {
+        fatal("SynchroTraceGen barriers per segment: invalid argument");
+    }
+}
+
+
+auto parseMaxRepeat(std::string repeat) -> unsigned
+{
+    if (repeat.empty() == true)
+        return 0; // default, every compute event is logged separately
+
+    try
+    {
+        int ret = std::stoi(repeat);
+        if (ret < 0)
+            fatal("SynchroTraceGen repeat limit: invalid argument");
+        return ret;
+    }
+    catch (std::exception &e)
+    {
+        fatal("SynchroTraceGen repeat limit: invalid argument");
+    }
+}
+
+
+auto parseStatsMode(std::string statsArg) -> bool
+{
+    if (statsArg.empty() == true || statsArg == "full")
+        return false; // default, keep every barrier and lock region
+    else if (statsArg == "stream")
+        return true;
+    else
+        fatal("unexpected synchrotracegen options: -s " + statsArg);
+}
+
+
+auto parseCommWindow(std::string window) -> unsigned
+{
+    if (window.empty() == true)
+        return 0; // default, no communication matrix
+    else if (window == "barrier")
+        return CommMatrix::PER_BARRIER;
+
+    try
+    {
+        long long ret = std::stoll(window);
+        if (ret < 1 || ret >= CommMatrix::PER_BARRIER)
+            fatal("SynchroTraceGen communication window: invalid argument");
+        return ret;
+    }
+    catch (std::exception &e)
+    {
+        fatal("SynchroTraceGen communication window: invalid argument");
+    }
+}
+
+
+auto parsePcPairs(std::string pairs) -> unsigned
+{
+    if (pairs.empty() == true)
+        return 0; // default, no communication profile
+
+    try
+    {
+        long long ret = std::stoll(pairs);
+        if (ret < 1 || ret > UINT_MAX)
+            fatal("SynchroTraceGen instruction pairs: invalid argument");
+        return ret;
+    }
+    catch (std::exception &e)
+    {
+        fatal("SynchroTraceGen instruction pairs: invalid argument");
+    }
+}
+
+
+auto parseRegionBound(std::string bound, std::string option) -> RegionBound
+{
+    if (bound.empty() == true)
+        return {}; // default, from the start or to the end of the program
+
+    RegionBound ret;
+    auto sep = bound.find(':');
+    auto kind = bound.substr(0, sep);
+    if (kind == "instr")
+        ret.kind = RegionBound::Kind::INSTRUCTION;
+    else if (kind == "barrier")
+        ret.kind = RegionBound::Kind::BARRIER;
+    else if (kind == "sync")
+        ret.kind = RegionBound::Kind::SYNC;
+
+    if (ret.kind == RegionBound::Kind::NONE || sep == std::string::npos)
+        fatal("unexpected synchrotracegen options: -" + option + " " + bound);
+
+    try
+    {
+        /* sync addresses may be given in hex */
+        int base = (ret.kind == RegionBound::Kind::SYNC ? 0 : 10);
+        ret.value = std::stoull(bound.substr(sep + 1), nullptr, base);
+    }
+    catch (std::exception &e)
+    {
+        fatal("SynchroTraceGen region of interest: invalid argument: " + bound);
+    }
+
+    if (ret.kind == RegionBound::Kind::BARRIER && ret.value == 0)
+        fatal("SynchroTraceGen region of interest: barriers are counted from 1");
+
+    return ret;
+}
+
+
+auto parseSampling(std::string sampling) -> std::pair<StatCounter, StatCounter>
+{
+    if (sampling.empty() == true)
+        return {0, 0}; // default, every instruction is detailed
+
+    auto sep = sampling.find(':');
+    if (sep == std::string::npos)
+        fatal("unexpected synchrotracegen options: -p " + sampling);
+
+    try
+    {
+        long long detail = std::stoll(sampling.substr(0, sep));
+        long long period = std::stoll(sampling.substr(sep + 1));
+        if (detail < 1 || period <= detail)
+            fatal("SynchroTraceGen sampling: needs 0 < DETAIL < PERIOD");
+        return {detail, period};
+    }
+    catch (std::exception &e)
+    {
+        fatal("SynchroTraceGen sampling: invalid argument");
+    }
+}
+
+
 auto parseOutputPath(std::string outputPath) -> std::string
 {
     if (outputPath.empty() == true)
@@ -342,15 +551,40 @@ auto onParse(Args args) -> void
     options.insert('o'); // -o OUTPUT_DIRECTORY
     options.insert('c'); // -c COMPRESSION_VALUE
     options.insert('l'); // -l {text,capnp}
+    options.insert('b'); // -b BARRIERS_PER_SEGMENT
+    options.insert('r'); // -r MAX_REPEAT
+    options.insert('s'); // -s {full,stream}
+    options.insert('m'); // -m {INSTRUCTIONS,barrier}
+    options.insert('f'); // -f {instr:N,barrier:N,sync:ADDR}
+    options.insert('e'); // -e {instr:N,barrier:N,sync:ADDR}
+    options.insert('p'); // -p DETAIL:PERIOD
+    options.insert('a'); // -a INSTRUCTION_PAIRS
     auto matches = parseAll(args, options);
 
-    outputPath = parseOutputPath(matches['o']);
-    loggerType = parseLogger(matches['l']);
-    primsPerStCompEv = parseCompression(matches['c']);
-
-    if (primsPerStCompEv == 1)
+    tcxtOptions.outputPath = parseOutputPath(matches['o']);
+    tcxtOptions.loggerType = parseLogger(matches['l']);
+    tcxtOptions.primsPerStCompEv = parseCompression(matches['c']);
+    tcxtOptions.barriersPerSegment = parseBarriersPerSegment(matches['b']);
+    tcxtOptions.maxRepeat = parseMaxRepeat(matches['r']);
+    tcxtOptions.streamingStats = parseStatsMode(matches['s']);
+    tcxtOptions.commWindow = parseCommWindow(matches['m']);
+    if (tcxtOptions.commWindow > 0)
+        tcxtOptions.commLog = std::make_shared<CommLog>(tcxtOptions.outputPath);
+    tcxtOptions.pcPairs = parsePcPairs(matches['a']);
+
+    auto start = parseRegionBound(matches['f'], "f");
+    auto stop = parseRegionBound(matches['e'], "e");
+    if (start.kind == RegionBound::Kind::INSTRUCTION &&
+        stop.kind == RegionBound::Kind::INSTRUCTION &&
+        stop.value <= start.value)
+        fatal("SynchroTraceGen region of interest: stops before it starts");
+    region = std::make_unique<RegionOfInterest>(start, stop);
+
+    std::tie(sampleDetail, samplePeriod) = parseSampling(matches['p']);
+
+    if (tcxtOptions.primsPerStCompEv == 1)
         genTCxt = ThreadContextGenerator<ThreadContextUncompressed>;
-    else if (primsPerStCompEv > 1)
+    else if (tcxtOptions.primsPerStCompEv > 1)
         genTCxt = ThreadContextGenerator<ThreadContextCompressed>;
     else
         fatal("SynchroTraceGen: Invalid compression level detected");
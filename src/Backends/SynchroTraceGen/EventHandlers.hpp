@@ -31,11 +31,24 @@ class EventHandlers : public BackendIface
     auto onCreate(Addr data) -> void;
     auto onBarrier(Addr data) -> void;
     auto convertAndFlush(const prism::SyncEvent &ev) -> void;
+    auto sample() -> bool;
     /* helpers */
 
     std::unordered_map<TID, std::unique_ptr<ThreadContext>> tcxts;
     TID currentTID{SO_UNDEF};
     ThreadContext *cachedTCxt{nullptr};
+
+    std::unordered_map<TID, StatCounter> threadBarriers;
+    /* barriers seen by each thread, in or out of the region of interest */
+
+    struct SampleWindow
+    {
+        StatCounter position{0};
+        bool detailed{true};
+    };
+    std::unordered_map<TID, SampleWindow> sampleWindows;
+    SampleWindow *cachedWindow{nullptr};
+    /* each thread's place in its sampling period, if sampling */
 };
 
 }; //end namespace STGen
@@ -0,0 +1,188 @@
+#ifndef STGEN_PC_PROFILE_H
+#define STGEN_PC_PROFILE_H
+
+#include "ShadowMemory.hpp"
+#include "STTypes.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace STGen
+{
+
+using PcID = uint32_t;
+constexpr PcID PC_UNKNOWN = 0;
+
+class PcPairs
+{
+    /* Communication between instructions, for all threads:
+     *
+     * - every instruction that writes, or reads communicated data,
+     *   is interned into a 32-bit ID, so the side table stays compact
+     * - the side table shadows the last instruction to write each byte,
+     *   next to STShadowMemory's last writer thread and event
+     * - bytes communicated per (producer store, consumer load) pair
+     *
+     * When the last thread is done, the heaviest pairs are written as CSV:
+     *
+     * producer_pc,consumer_pc,bytes
+     *
+     * sorted by bytes; a producer_pc of 0 is a write that was not attributed */
+  public:
+    using Pairs = std::unordered_map<uint64_t, StatCounter>;
+
+    static auto open(const std::string &outputPath, unsigned maxPairs) -> std::shared_ptr<PcPairs>
+    {
+        /* one table shared by every thread; written out with the last thread */
+        static std::mutex mtx;
+        static std::weak_ptr<PcPairs> shared;
+
+        std::lock_guard<std::mutex> lock(mtx);
+        auto pairs = shared.lock();
+        if (pairs == nullptr)
+        {
+            pairs = std::shared_ptr<PcPairs>(new PcPairs(outputPath + "/sigil.commpc.csv",
+                                                         maxPairs));
+            shared = pairs;
+        }
+        return pairs;
+    }
+
+    PcPairs(const PcPairs &) = delete;
+    PcPairs &operator=(const PcPairs &) = delete;
+    ~PcPairs()
+    {
+        if (flush() == false)
+            warn("writing communication profile: " + path);
+    }
+
+    auto intern(Addr pc) -> PcID
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = ids.find(pc);
+        if (it != ids.end())
+            return it->second;
+
+        if (pcs.size() == std::numeric_limits<PcID>::max())
+            fatal("too many instructions in communication profile");
+        pcs.push_back(pc);
+        return ids.emplace(pc, pcs.size() - 1).first->second;
+    }
+
+    auto merge(const Pairs &threadPairs) -> void
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto &p : threadPairs)
+            pairs[p.first] += p.second;
+    }
+
+    ShadowMemory<PcID, 38, 20> writers;
+    /* the same layout as STShadowMemory; bytes never written are PC_UNKNOWN */
+
+  private:
+    PcPairs(const std::string &path, unsigned maxPairs)
+        : path(path)
+        , maxPairs(maxPairs)
+        , pcs{0}
+    {
+        assert(maxPairs > 0);
+    }
+
+    auto flush() -> bool
+    {
+        std::vector<std::pair<uint64_t, StatCounter>> ranked(pairs.cbegin(), pairs.cend());
+        auto heaviest = [](const std::pair<uint64_t, StatCounter> &l,
+                           const std::pair<uint64_t, StatCounter> &r)
+        {
+            return l.second > r.second || (l.second == r.second && l.first < r.first);
+        };
+        auto last = ranked.begin() + std::min<size_t>(maxPairs, ranked.size());
+        std::partial_sort(ranked.begin(), last, ranked.end(), heaviest);
+
+        std::unique_ptr<FILE, int(*)(FILE*)> file(fopen(path.c_str(), "w"), fclose);
+        if (file == nullptr || fputs("producer_pc,consumer_pc,bytes\n", file.get()) < 0)
+            return false;
+        for (auto it = ranked.begin(); it != last; ++it)
+            if (fprintf(file.get(), "0x%lx,0x%lx,%llu\n",
+                        pcs[it->first >> 32], pcs[it->first & 0xffffffff], it->second) < 0)
+                return false;
+        return true;
+    }
+
+    std::string path;
+    unsigned maxPairs;
+
+    std::mutex mtx;
+    std::vector<Addr> pcs;
+    std::unordered_map<Addr, PcID> ids;
+    /* instruction address of each ID, from PC_UNKNOWN; and the reverse */
+    Pairs pairs;
+};
+
+
+class PcProfile
+{
+    /* One thread's view of the communication profile.
+     *
+     * The current instruction is only interned once it writes or communicates,
+     * and each thread caches the IDs it has seen, so the shared table is rarely locked;
+     * pairs are counted locally and merged when the thread is done */
+  public:
+    PcProfile(std::shared_ptr<PcPairs> shared)
+        : shared(std::move(shared))
+    {
+    }
+    PcProfile(const PcProfile &) = delete;
+    PcProfile &operator=(const PcProfile &) = delete;
+    ~PcProfile() { shared->merge(pairs); }
+
+    auto onInstr(Addr pc) -> void
+    {
+        currentPc = pc;
+        currentID = PC_UNKNOWN;
+    }
+
+    auto onWrite(Addr start, Addr bytes) -> void
+    {
+        PcID id = current();
+        for (Addr i = 0; i < bytes; ++i)
+            shared->writers[start + i] = id;
+    }
+
+    auto onComm(Addr addr, StatCounter bytes) -> void
+    {
+        uint64_t producer = shared->writers[addr];
+        pairs[(producer << 32) | current()] += bytes;
+    }
+
+  private:
+    auto current() -> PcID
+    {
+        if (currentID == PC_UNKNOWN)
+        {
+            auto it = cache.find(currentPc);
+            if (it == cache.end())
+                it = cache.emplace(currentPc, shared->intern(currentPc)).first;
+            currentID = it->second;
+        }
+        return currentID;
+    }
+
+    std::shared_ptr<PcPairs> shared;
+    std::unordered_map<Addr, PcID> cache;
+    PcPairs::Pairs pairs;
+
+    Addr currentPc{0};
+    PcID currentID{PC_UNKNOWN};
+    /* the current instruction, and its ID once interned */
+};
+
+}; //end namespace STGen
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef STGEN_REGION_OF_INTEREST_H
+#define STGEN_REGION_OF_INTEREST_H
+
+#include "STTypes.hpp"
+#include <atomic>
+
+namespace STGen
+{
+
+struct RegionBound
+{
+    /* Where the region of interest starts or stops:
+     * - INSTRUCTION: after 'value' instructions, counted across all threads
+     * - BARRIER:     at the 'value'-th barrier (from 1) of the first thread to reach it
+     * - SYNC:        at the first synchronization event on address 'value' */
+    enum class Kind { NONE, INSTRUCTION, BARRIER, SYNC };
+
+    Kind kind{Kind::NONE};
+    StatCounter value{0};
+};
+
+
+class RegionOfInterest
+{
+    /* Gates which events SynchroTraceGen processes.
+     *
+     * Events before the start and from the stop onwards are skipped entirely:
+     * no shadow memory updates, statistics, or logging. The event that starts
+     * the region is its first event; the event that stops it is left out.
+     * Because the warm-up leaves no writers in shadow memory, the first read
+     * of an address in the region is treated as a local read.
+     *
+     * The region is the same for all threads, and can only be entered once */
+  public:
+    RegionOfInterest(RegionBound start, RegionBound stop)
+        : start(start)
+        , stop(stop)
+        , countInstrs(start.kind == RegionBound::Kind::INSTRUCTION ||
+                      stop.kind == RegionBound::Kind::INSTRUCTION)
+        , state(start.kind == RegionBound::Kind::NONE ? State::ACTIVE : State::BEFORE)
+    {
+    }
+    RegionOfInterest(const RegionOfInterest &) = delete;
+    RegionOfInterest &operator=(const RegionOfInterest &) = delete;
+
+    auto isActive() const -> bool
+    {
+        return state.load(std::memory_order_relaxed) == State::ACTIVE;
+    }
+
+    auto onInstr() -> bool
+    {
+        /* returns if this instruction is in the region */
+        if (countInstrs == false)
+            return isActive();
+
+        StatCounter before = instrs.fetch_add(1, std::memory_order_relaxed);
+        return update(reached(start, RegionBound::Kind::INSTRUCTION, before),
+                      reached(stop, RegionBound::Kind::INSTRUCTION, before));
+    }
+
+    auto onSync(Addr data, StatCounter barrier) -> bool
+    {
+        /* returns if this synchronization event is in the region;
+         * 'barrier' counts the thread's barriers including this one,
+         * or is 0 if this is not a barrier */
+        bool startReached = reached(start, RegionBound::Kind::SYNC, data) ||
+                            (barrier > 0 && reached(start, RegionBound::Kind::BARRIER, barrier));
+        bool stopReached = reached(stop, RegionBound::Kind::SYNC, data) ||
+                           (barrier > 0 && reached(stop, RegionBound::Kind::BARRIER, barrier));
+        return update(startReached, stopReached);
+    }
+
+  private:
+    enum class State : unsigned char { BEFORE, ACTIVE, AFTER };
+
+    static auto reached(const RegionBound &bound, RegionBound::Kind kind,
+                        StatCounter value) -> bool
+    {
+        /* instructions are counted before the current one */
+        if (bound.kind != kind)
+            return false;
+        else if (kind == RegionBound::Kind::SYNC)
+            return value == bound.value;
+        else
+            return value >= bound.value;
+    }
+
+    auto update(bool startReached, bool stopReached) -> bool
+    {
+        /* the stop only counts once the region has started,
+         * so start and stop can be the same address */
+        State current = state.load(std::memory_order_relaxed);
+        if (current == State::ACTIVE && stopReached == true)
+        {
+            state.compare_exchange_strong(current, State::AFTER);
+            return false;
+        }
+        else if (current == State::BEFORE && startReached == true)
+        {
+            state.compare_exchange_strong(current, State::ACTIVE);
+            return isActive();
+        }
+        return current == State::ACTIVE;
+    }
+
+    const RegionBound start;
+    const RegionBound stop;
+    const bool countInstrs;
+
+    std::atomic<State> state;
+    std::atomic<StatCounter> instrs{0};
+};
+
+}; //end namespace STGen
+
+#endif
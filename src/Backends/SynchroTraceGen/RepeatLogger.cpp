@@ -0,0 +1,139 @@
+#include "RepeatLogger.hpp"
+#include <cassert>
+
+namespace STGen
+{
+
+RepeatLogger::RepeatLogger(LogPtr logger, unsigned maxRepeat)
+    : logger(std::move(logger))
+    , maxRepeat(maxRepeat)
+{
+    assert(this->logger != nullptr);
+    assert(maxRepeat > 0);
+}
+
+
+RepeatLogger::~RepeatLogger()
+{
+    flushRun();
+}
+
+
+auto RepeatLogger::flush(const STCompEventCompressed& ev, EID eid, TID tid) -> void
+{
+    if (eid == firstEID + repeat && tid == runTID && extendsRun(ev) == true)
+        return;
+
+    flushRun();
+    startRun(ev, eid, tid);
+}
+
+
+auto RepeatLogger::flush(const STCommEventCompressed& ev, EID eid, TID tid) -> void
+{
+    flushRun();
+    logger->flush(ev, eid, tid);
+}
+
+
+auto RepeatLogger::flush(unsigned char syncType, unsigned numArgs, Addr *syncArgs,
+                         EID eid, TID tid) -> void
+{
+    flushRun();
+    logger->flush(syncType, numArgs, syncArgs, eid, tid);
+}
+
+
+auto RepeatLogger::instrMarker(int limit) -> void
+{
+    flushRun();
+    logger->instrMarker(limit);
+}
+
+
+auto RepeatLogger::extendsRun(const STCompEventCompressed& ev) -> bool
+{
+    if (repeat == 0 || repeat == maxRepeat)
+        return false;
+
+    if (ev.iops != first.iops || ev.flops != first.flops ||
+        ev.writes != first.writes || ev.reads != first.reads)
+        return false;
+
+    auto &writes = ev.uniqueWriteAddrs.get();
+    auto &reads = ev.uniqueReadAddrs.get();
+    if (writes.size() != first.uniqueWriteAddrs.get().size() ||
+        reads.size() != first.uniqueReadAddrs.get().size())
+        return false;
+
+    /* every range must move by the same amount as the first one,
+     * and by the same amount as the previous events in the run */
+    int64_t delta = 0;
+    if (last.empty() == false)
+    {
+        auto &range = (writes.empty() ? *reads.cbegin() : *writes.cbegin());
+        delta = static_cast<int64_t>(range.first - last.front().first);
+    }
+    if (repeat > 1 && delta != stride)
+        return false;
+
+    size_t i = 0;
+    for (auto *ranges : {&writes, &reads})
+    {
+        for (auto &range : *ranges)
+        {
+            if (static_cast<int64_t>(range.first - last[i].first) != delta ||
+                static_cast<int64_t>(range.second - last[i].second) != delta)
+                return false;
+            ++i;
+        }
+    }
+
+    i = 0;
+    for (auto *ranges : {&writes, &reads})
+        for (auto &range : *ranges)
+            last[i++] = range;
+
+    stride = delta;
+    ++repeat;
+    return true;
+}
+
+
+auto RepeatLogger::startRun(const STCompEventCompressed& ev, EID eid, TID tid) -> void
+{
+    first.reset();
+    first.iops = ev.iops;
+    first.flops = ev.flops;
+    first.writes = ev.writes;
+    first.reads = ev.reads;
+
+    last.clear();
+    for (auto &range : ev.uniqueWriteAddrs.get())
+    {
+        first.uniqueWriteAddrs.insert(range);
+        last.push_back(range);
+    }
+    for (auto &range : ev.uniqueReadAddrs.get())
+    {
+        first.uniqueReadAddrs.insert(range);
+        last.push_back(range);
+    }
+
+    repeat = 1;
+    stride = 0;
+    firstEID = eid;
+    runTID = tid;
+}
+
+
+auto RepeatLogger::flushRun() -> void
+{
+    if (repeat == 1)
+        logger->flush(first, firstEID, runTID);
+    else if (repeat > 1)
+        logger->flushRepeat(first, repeat, stride, firstEID, runTID);
+    repeat = 0;
+}
+
+}; //end namespace STGen
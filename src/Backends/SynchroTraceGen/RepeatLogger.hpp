@@ -0,0 +1,59 @@
+#ifndef STGEN_REPEAT_LOGGER_H
+#define STGEN_REPEAT_LOGGER_H
+
+#include "STLogger.hpp"
+#include <memory>
+#include <vector>
+
+namespace STGen
+{
+
+class RepeatLogger : public STLoggerCompressed
+{
+    /* Folds runs of Compute Events into repeat records before they reach
+     * the wrapped logger.
+     *
+     * Tight loops flush the same compute event over and over, with the same
+     * iops/flops/reads/writes and every address range moved by a constant stride.
+     * The run so far is kept as its first event, the last event's ranges, and
+     * the stride between them, so each new event is one comparison against
+     * the last, regardless of how long the run is.
+     * Any other event, or an event that breaks the stride, ends the run.
+     *
+     * See STLoggerCompressed::flushRepeat */
+
+    using LogPtr = std::unique_ptr<STLoggerCompressed>;
+    using AddrRange = AddrSet::AddrRange;
+  public:
+    RepeatLogger(LogPtr logger, unsigned maxRepeat);
+    RepeatLogger(const RepeatLogger &other) = delete;
+    ~RepeatLogger() override final;
+
+    auto flush(const STCompEventCompressed& ev, EID eid, TID tid) -> void override final;
+    auto flush(const STCommEventCompressed& ev, EID eid, TID tid) -> void override final;
+    auto flush(unsigned char syncType, unsigned numArgs, Addr *syncArgs,
+               EID eid, TID tid) -> void override final;
+    auto instrMarker(int limit) -> void override final;
+
+  private:
+    auto extendsRun(const STCompEventCompressed& ev) -> bool;
+    auto startRun(const STCompEventCompressed& ev, EID eid, TID tid) -> void;
+    auto flushRun() -> void;
+
+    LogPtr logger;
+    unsigned maxRepeat;
+    /* longest run folded into one record */
+
+    STCompEventCompressed first;
+    std::vector<AddrRange> last;
+    /* the run's first event, and the latest write then read ranges */
+
+    unsigned repeat{0};
+    int64_t stride{0};
+    EID firstEID{0};
+    TID runTID{0};
+};
+
+}; //end namespace STGen
+
+#endif
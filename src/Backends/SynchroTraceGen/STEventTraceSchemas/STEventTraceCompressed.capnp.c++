@@ -65,7 +65,7 @@ const ::capnp::_::RawSchema s_e57f0f2c60992cf5 = {
 static const ::capnp::_::AlignedData<66> b_a549639de263753a = {
   {   0,   0,   0,   0,   5,   0,   6,   0,
      58, 117,  99, 226, 157,  99,  73, 165,
-     51,   0,   0,   0,   1,   0,   2,   0,
+     51,   0,   0,   0,   1,   0,   3,   0,
     245,  44, 153,  96,  44,  15, 127, 229,
       2,   0,   7,   0,   0,   0,   4,   0,
       4,   0,   0,   0,   0,   0,   0,   0,
@@ -209,7 +209,7 @@ const ::capnp::_::RawSchema s_de81bb8c1098c164 = {
   0, 2, i_de81bb8c1098c164, nullptr, nullptr, { &s_de81bb8c1098c164, nullptr, nullptr, 0, 0, nullptr }
 };
 #endif  // !CAPNP_LITE
-static const ::capnp::_::AlignedData<74> b_87e1459470df7904 = {
+static const ::capnp::_::AlignedData<91> b_87e1459470df7904 = {
   {   0,   0,   0,   0,   5,   0,   6,   0,
       4, 121, 223, 112, 148,  69, 225, 135,
      57,   0,   0,   0,   1,   0,   1,   0,
@@ -219,7 +219,7 @@ static const ::capnp::_::AlignedData<74> b_87e1459470df7904 = {
      21,   0,   0,   0,  18,   2,   0,   0,
      53,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     49,   0,   0,   0, 175,   0,   0,   0,
+     49,   0,   0,   0, 231,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
      83,  84,  69, 118, 101, 110, 116,  84,
@@ -232,28 +232,35 @@ static const ::capnp::_::AlignedData<74> b_87e1459470df7904 = {
      46,  67, 111, 109, 109,  69, 100, 103,
     101,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   1,   0,   1,   0,
-     12,   0,   0,   0,   3,   0,   4,   0,
+     16,   0,   0,   0,   3,   0,   4,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   1,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     69,   0,   0,   0, 122,   0,   0,   0,
+     97,   0,   0,   0, 122,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     68,   0,   0,   0,   3,   0,   1,   0,
-     80,   0,   0,   0,   2,   0,   1,   0,
+     96,   0,   0,   0,   3,   0,   1,   0,
+    108,   0,   0,   0,   2,   0,   1,   0,
       1,   0,   0,   0,   1,   0,   0,   0,
       0,   0,   1,   0,   1,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     77,   0,   0,   0, 114,   0,   0,   0,
+    105,   0,   0,   0, 114,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     76,   0,   0,   0,   3,   0,   1,   0,
-     88,   0,   0,   0,   2,   0,   1,   0,
+    104,   0,   0,   0,   3,   0,   1,   0,
+    116,   0,   0,   0,   2,   0,   1,   0,
       2,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   1,   0,   2,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     85,   0,   0,   0,  50,   0,   0,   0,
+    113,   0,   0,   0,  50,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     80,   0,   0,   0,   3,   0,   1,   0,
-    108,   0,   0,   0,   2,   0,   1,   0,
+    108,   0,   0,   0,   3,   0,   1,   0,
+    136,   0,   0,   0,   2,   0,   1,   0,
+      3,   0,   0,   0,   1,   0,   0,   0,
+      0,   0,   1,   0,   3,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    133,   0,   0,   0, 146,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    136,   0,   0,   0,   3,   0,   1,   0,
+    148,   0,   0,   0,   2,   0,   1,   0,
     112, 114, 111, 100, 117,  99, 101, 114,
      84, 104, 114, 101,  97, 100,   0,   0,
       7,   0,   0,   0,   0,   0,   0,   0,
@@ -282,6 +289,16 @@ static const ::capnp::_::AlignedData<74> b_87e1459470df7904 = {
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
      14,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    112, 114, 111, 100, 117,  99, 101, 114,
+     69, 118, 101, 110, 116,  72, 105, 103,
+    104,   0,   0,   0,   0,   0,   0,   0,
+      7,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      7,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0, }
 };
@@ -290,11 +307,11 @@ static const ::capnp::_::AlignedData<74> b_87e1459470df7904 = {
 static const ::capnp::_::RawSchema* const d_87e1459470df7904[] = {
   &s_de81bb8c1098c164,
 };
-static const uint16_t m_87e1459470df7904[] = {2, 1, 0};
-static const uint16_t i_87e1459470df7904[] = {0, 1, 2};
+static const uint16_t m_87e1459470df7904[] = {2, 1, 3, 0};
+static const uint16_t i_87e1459470df7904[] = {0, 1, 2, 3};
 const ::capnp::_::RawSchema s_87e1459470df7904 = {
-  0x87e1459470df7904, b_87e1459470df7904.words, 74, d_87e1459470df7904, m_87e1459470df7904,
-  1, 3, i_87e1459470df7904, nullptr, nullptr, { &s_87e1459470df7904, nullptr, nullptr, 0, 0, nullptr }
+  0x87e1459470df7904, b_87e1459470df7904.words, 91, d_87e1459470df7904, m_87e1459470df7904,
+  1, 4, i_87e1459470df7904, nullptr, nullptr, { &s_87e1459470df7904, nullptr, nullptr, 0, 0, nullptr }
 };
 #endif  // !CAPNP_LITE
 static const ::capnp::_::AlignedData<72> b_f39ea1239dd73c82 = {
@@ -380,17 +397,17 @@ const ::capnp::_::RawSchema s_f39ea1239dd73c82 = {
 };
 #endif  // !CAPNP_LITE
 CAPNP_DEFINE_ENUM(SyncType_f39ea1239dd73c82, f39ea1239dd73c82);
-static const ::capnp::_::AlignedData<121> b_d2bf31fae8d0dc23 = {
+static const ::capnp::_::AlignedData<151> b_d2bf31fae8d0dc23 = {
   {   0,   0,   0,   0,   5,   0,   6,   0,
      35, 220, 208, 232, 250,  49, 191, 210,
-     57,   0,   0,   0,   1,   0,   2,   0,
+     57,   0,   0,   0,   1,   0,   3,   0,
      58, 117,  99, 226, 157,  99,  73, 165,
       2,   0,   7,   0,   1,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
      21,   0,   0,   0, 242,   1,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     41,   0,   0,   0,  87,   1,   0,   0,
+     41,   0,   0,   0, 199,   1,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
      83,  84,  69, 118, 101, 110, 116,  84,
@@ -401,49 +418,63 @@ static const ::capnp::_::AlignedData<121> b_d2bf31fae8d0dc23 = {
      67, 111, 109, 112, 114, 101, 115, 115,
     101, 100,  46,  69, 118, 101, 110, 116,
      46,  99, 111, 109, 112,   0,   0,   0,
-     24,   0,   0,   0,   3,   0,   4,   0,
+     32,   0,   0,   0,   3,   0,   4,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   1,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    153,   0,   0,   0,  42,   0,   0,   0,
+    209,   0,   0,   0,  42,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    148,   0,   0,   0,   3,   0,   1,   0,
-    160,   0,   0,   0,   2,   0,   1,   0,
+    204,   0,   0,   0,   3,   0,   1,   0,
+    216,   0,   0,   0,   2,   0,   1,   0,
       1,   0,   0,   0,   1,   0,   0,   0,
       0,   0,   1,   0,   1,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    157,   0,   0,   0,  50,   0,   0,   0,
+    213,   0,   0,   0,  50,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    152,   0,   0,   0,   3,   0,   1,   0,
-    164,   0,   0,   0,   2,   0,   1,   0,
+    208,   0,   0,   0,   3,   0,   1,   0,
+    220,   0,   0,   0,   2,   0,   1,   0,
       2,   0,   0,   0,   2,   0,   0,   0,
       0,   0,   1,   0,   2,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    161,   0,   0,   0,  58,   0,   0,   0,
+    217,   0,   0,   0,  58,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    156,   0,   0,   0,   3,   0,   1,   0,
-    168,   0,   0,   0,   2,   0,   1,   0,
+    212,   0,   0,   0,   3,   0,   1,   0,
+    224,   0,   0,   0,   2,   0,   1,   0,
       3,   0,   0,   0,   3,   0,   0,   0,
       0,   0,   1,   0,   3,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    165,   0,   0,   0,  50,   0,   0,   0,
+    221,   0,   0,   0,  50,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    160,   0,   0,   0,   3,   0,   1,   0,
-    172,   0,   0,   0,   2,   0,   1,   0,
+    216,   0,   0,   0,   3,   0,   1,   0,
+    228,   0,   0,   0,   2,   0,   1,   0,
       4,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   1,   0,   4,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    169,   0,   0,   0,  90,   0,   0,   0,
+    225,   0,   0,   0,  90,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    168,   0,   0,   0,   3,   0,   1,   0,
-    196,   0,   0,   0,   2,   0,   1,   0,
+    224,   0,   0,   0,   3,   0,   1,   0,
+    252,   0,   0,   0,   2,   0,   1,   0,
       5,   0,   0,   0,   1,   0,   0,   0,
       0,   0,   1,   0,   5,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    193,   0,   0,   0,  82,   0,   0,   0,
+    249,   0,   0,   0,  82,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    192,   0,   0,   0,   3,   0,   1,   0,
-    220,   0,   0,   0,   2,   0,   1,   0,
+    248,   0,   0,   0,   3,   0,   1,   0,
+     20,   1,   0,   0,   2,   0,   1,   0,
+      6,   0,   0,   0,   3,   0,   0,   0,
+      0,   0,   1,   0,  10,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     17,   1,   0,   0,  58,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     12,   1,   0,   0,   3,   0,   1,   0,
+     24,   1,   0,   0,   2,   0,   1,   0,
+      7,   0,   0,   0,   2,   0,   0,   0,
+      0,   0,   1,   0,  11,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     21,   1,   0,   0,  58,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     16,   1,   0,   0,   3,   0,   1,   0,
+     28,   1,   0,   0,   2,   0,   1,   0,
     105, 111, 112, 115,   0,   0,   0,   0,
       7,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -500,6 +531,22 @@ static const ::capnp::_::AlignedData<121> b_d2bf31fae8d0dc23 = {
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
      14,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    114, 101, 112, 101,  97, 116,   0,   0,
+      8,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      8,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    115, 116, 114, 105, 100, 101,   0,   0,
+      5,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0, }
 };
@@ -509,17 +556,17 @@ static const ::capnp::_::RawSchema* const d_d2bf31fae8d0dc23[] = {
   &s_a549639de263753a,
   &s_de81bb8c1098c164,
 };
-static const uint16_t m_d2bf31fae8d0dc23[] = {1, 0, 5, 3, 4, 2};
-static const uint16_t i_d2bf31fae8d0dc23[] = {0, 1, 2, 3, 4, 5};
+static const uint16_t m_d2bf31fae8d0dc23[] = {1, 0, 5, 3, 6, 7, 4, 2};
+static const uint16_t i_d2bf31fae8d0dc23[] = {0, 1, 2, 3, 4, 5, 6, 7};
 const ::capnp::_::RawSchema s_d2bf31fae8d0dc23 = {
-  0xd2bf31fae8d0dc23, b_d2bf31fae8d0dc23.words, 121, d_d2bf31fae8d0dc23, m_d2bf31fae8d0dc23,
-  2, 6, i_d2bf31fae8d0dc23, nullptr, nullptr, { &s_d2bf31fae8d0dc23, nullptr, nullptr, 0, 0, nullptr }
+  0xd2bf31fae8d0dc23, b_d2bf31fae8d0dc23.words, 151, d_d2bf31fae8d0dc23, m_d2bf31fae8d0dc23,
+  2, 8, i_d2bf31fae8d0dc23, nullptr, nullptr, { &s_d2bf31fae8d0dc23, nullptr, nullptr, 0, 0, nullptr }
 };
 #endif  // !CAPNP_LITE
 static const ::capnp::_::AlignedData<40> b_957495c263e2731b = {
   {   0,   0,   0,   0,   5,   0,   6,   0,
      27, 115, 226,  99, 194, 149, 116, 149,
-     57,   0,   0,   0,   1,   0,   2,   0,
+     57,   0,   0,   0,   1,   0,   3,   0,
      58, 117,  99, 226, 157,  99,  73, 165,
       2,   0,   7,   0,   1,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -574,7 +621,7 @@ const ::capnp::_::RawSchema s_957495c263e2731b = {
 static const ::capnp::_::AlignedData<55> b_8d9b0a9fce0b4a0b = {
   {   0,   0,   0,   0,   5,   0,   6,   0,
      11,  74,  11, 206, 159,  10, 155, 141,
-     57,   0,   0,   0,   1,   0,   2,   0,
+     57,   0,   0,   0,   1,   0,   3,   0,
      58, 117,  99, 226, 157,  99,  73, 165,
       2,   0,   7,   0,   1,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -644,7 +691,7 @@ const ::capnp::_::RawSchema s_8d9b0a9fce0b4a0b = {
 static const ::capnp::_::AlignedData<36> b_86453f87c831d9e8 = {
   {   0,   0,   0,   0,   5,   0,   6,   0,
     232, 217,  49, 200, 135,  63,  69, 134,
-     57,   0,   0,   0,   1,   0,   2,   0,
+     57,   0,   0,   0,   1,   0,   3,   0,
      58, 117,  99, 226, 157,  99,  73, 165,
       2,   0,   7,   0,   1,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
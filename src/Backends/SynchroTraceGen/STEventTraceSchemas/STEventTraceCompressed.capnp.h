@@ -80,7 +80,7 @@ struct EventStreamCompressed::Event {
   struct Marker;
 
   struct _capnpPrivate {
-    CAPNP_DECLARE_STRUCT_HEADER(a549639de263753a, 2, 2)
+    CAPNP_DECLARE_STRUCT_HEADER(a549639de263753a, 3, 2)
     #if !CAPNP_LITE
     static constexpr ::capnp::_::RawBrandedSchema const* brand() { return &schema->defaultBrand; }
     #endif  // !CAPNP_LITE
@@ -125,7 +125,7 @@ struct EventStreamCompressed::Event::Comp {
   class Pipeline;
 
   struct _capnpPrivate {
-    CAPNP_DECLARE_STRUCT_HEADER(d2bf31fae8d0dc23, 2, 2)
+    CAPNP_DECLARE_STRUCT_HEADER(d2bf31fae8d0dc23, 3, 2)
     #if !CAPNP_LITE
     static constexpr ::capnp::_::RawBrandedSchema const* brand() { return &schema->defaultBrand; }
     #endif  // !CAPNP_LITE
@@ -140,7 +140,7 @@ struct EventStreamCompressed::Event::Comm {
   class Pipeline;
 
   struct _capnpPrivate {
-    CAPNP_DECLARE_STRUCT_HEADER(957495c263e2731b, 2, 2)
+    CAPNP_DECLARE_STRUCT_HEADER(957495c263e2731b, 3, 2)
     #if !CAPNP_LITE
     static constexpr ::capnp::_::RawBrandedSchema const* brand() { return &schema->defaultBrand; }
     #endif  // !CAPNP_LITE
@@ -155,7 +155,7 @@ struct EventStreamCompressed::Event::Sync {
   class Pipeline;
 
   struct _capnpPrivate {
-    CAPNP_DECLARE_STRUCT_HEADER(8d9b0a9fce0b4a0b, 2, 2)
+    CAPNP_DECLARE_STRUCT_HEADER(8d9b0a9fce0b4a0b, 3, 2)
     #if !CAPNP_LITE
     static constexpr ::capnp::_::RawBrandedSchema const* brand() { return &schema->defaultBrand; }
     #endif  // !CAPNP_LITE
@@ -170,7 +170,7 @@ struct EventStreamCompressed::Event::Marker {
   class Pipeline;
 
   struct _capnpPrivate {
-    CAPNP_DECLARE_STRUCT_HEADER(86453f87c831d9e8, 2, 2)
+    CAPNP_DECLARE_STRUCT_HEADER(86453f87c831d9e8, 3, 2)
     #if !CAPNP_LITE
     static constexpr ::capnp::_::RawBrandedSchema const* brand() { return &schema->defaultBrand; }
     #endif  // !CAPNP_LITE
@@ -466,6 +466,8 @@ public:
   inline bool hasAddrs() const;
   inline  ::capnp::List< ::EventStreamCompressed::Event::AddrRange,  ::capnp::Kind::STRUCT>::Reader getAddrs() const;
 
+  inline  ::uint16_t getProducerEventHigh() const;
+
 private:
   ::capnp::_::StructReader _reader;
   template <typename, ::capnp::Kind>
@@ -507,6 +509,9 @@ public:
   inline void adoptAddrs(::capnp::Orphan< ::capnp::List< ::EventStreamCompressed::Event::AddrRange,  ::capnp::Kind::STRUCT>>&& value);
   inline ::capnp::Orphan< ::capnp::List< ::EventStreamCompressed::Event::AddrRange,  ::capnp::Kind::STRUCT>> disownAddrs();
 
+  inline  ::uint16_t getProducerEventHigh();
+  inline void setProducerEventHigh( ::uint16_t value);
+
 private:
   ::capnp::_::StructBuilder _builder;
   template <typename, ::capnp::Kind>
@@ -564,6 +569,10 @@ public:
   inline bool hasReadAddrs() const;
   inline  ::capnp::List< ::EventStreamCompressed::Event::AddrRange,  ::capnp::Kind::STRUCT>::Reader getReadAddrs() const;
 
+  inline  ::uint32_t getRepeat() const;
+
+  inline  ::int64_t getStride() const;
+
 private:
   ::capnp::_::StructReader _reader;
   template <typename, ::capnp::Kind>
@@ -618,6 +627,12 @@ public:
   inline void adoptReadAddrs(::capnp::Orphan< ::capnp::List< ::EventStreamCompressed::Event::AddrRange,  ::capnp::Kind::STRUCT>>&& value);
   inline ::capnp::Orphan< ::capnp::List< ::EventStreamCompressed::Event::AddrRange,  ::capnp::Kind::STRUCT>> disownReadAddrs();
 
+  inline  ::uint32_t getRepeat();
+  inline void setRepeat( ::uint32_t value);
+
+  inline  ::int64_t getStride();
+  inline void setStride( ::int64_t value);
+
 private:
   ::capnp::_::StructBuilder _builder;
   template <typename, ::capnp::Kind>
@@ -958,6 +973,8 @@ inline typename EventStreamCompressed::Event::Comp::Builder EventStreamCompresse
   _builder.setDataField< ::uint16_t>(::capnp::bounded<3>() * ::capnp::ELEMENTS, 0);
   _builder.getPointerField(::capnp::bounded<0>() * ::capnp::POINTERS).clear();
   _builder.getPointerField(::capnp::bounded<1>() * ::capnp::POINTERS).clear();
+  _builder.setDataField< ::uint32_t>(::capnp::bounded<3>() * ::capnp::ELEMENTS, 0);
+  _builder.setDataField< ::int64_t>(::capnp::bounded<2>() * ::capnp::ELEMENTS, 0);
   return typename EventStreamCompressed::Event::Comp::Builder(_builder);
 }
 inline bool EventStreamCompressed::Event::Reader::isComm() const {
@@ -1117,6 +1134,20 @@ inline ::capnp::Orphan< ::capnp::List< ::EventStreamCompressed::Event::AddrRange
       ::capnp::bounded<0>() * ::capnp::POINTERS));
 }
 
+inline  ::uint16_t EventStreamCompressed::Event::CommEdge::Reader::getProducerEventHigh() const {
+  return _reader.getDataField< ::uint16_t>(
+      ::capnp::bounded<1>() * ::capnp::ELEMENTS);
+}
+
+inline  ::uint16_t EventStreamCompressed::Event::CommEdge::Builder::getProducerEventHigh() {
+  return _builder.getDataField< ::uint16_t>(
+      ::capnp::bounded<1>() * ::capnp::ELEMENTS);
+}
+inline void EventStreamCompressed::Event::CommEdge::Builder::setProducerEventHigh( ::uint16_t value) {
+  _builder.setDataField< ::uint16_t>(
+      ::capnp::bounded<1>() * ::capnp::ELEMENTS, value);
+}
+
 inline  ::uint16_t EventStreamCompressed::Event::Comp::Reader::getIops() const {
   return _reader.getDataField< ::uint16_t>(
       ::capnp::bounded<0>() * ::capnp::ELEMENTS);
@@ -1241,6 +1272,34 @@ inline ::capnp::Orphan< ::capnp::List< ::EventStreamCompressed::Event::AddrRange
       ::capnp::bounded<1>() * ::capnp::POINTERS));
 }
 
+inline  ::uint32_t EventStreamCompressed::Event::Comp::Reader::getRepeat() const {
+  return _reader.getDataField< ::uint32_t>(
+      ::capnp::bounded<3>() * ::capnp::ELEMENTS);
+}
+
+inline  ::uint32_t EventStreamCompressed::Event::Comp::Builder::getRepeat() {
+  return _builder.getDataField< ::uint32_t>(
+      ::capnp::bounded<3>() * ::capnp::ELEMENTS);
+}
+inline void EventStreamCompressed::Event::Comp::Builder::setRepeat( ::uint32_t value) {
+  _builder.setDataField< ::uint32_t>(
+      ::capnp::bounded<3>() * ::capnp::ELEMENTS, value);
+}
+
+inline  ::int64_t EventStreamCompressed::Event::Comp::Reader::getStride() const {
+  return _reader.getDataField< ::int64_t>(
+      ::capnp::bounded<2>() * ::capnp::ELEMENTS);
+}
+
+inline  ::int64_t EventStreamCompressed::Event::Comp::Builder::getStride() {
+  return _builder.getDataField< ::int64_t>(
+      ::capnp::bounded<2>() * ::capnp::ELEMENTS);
+}
+inline void EventStreamCompressed::Event::Comp::Builder::setStride( ::int64_t value) {
+  _builder.setDataField< ::int64_t>(
+      ::capnp::bounded<2>() * ::capnp::ELEMENTS, value);
+}
+
 inline bool EventStreamCompressed::Event::Comm::Reader::hasEdges() const {
   return !_reader.getPointerField(
       ::capnp::bounded<0>() * ::capnp::POINTERS).isNull();
@@ -382,7 +382,7 @@ const ::capnp::_::RawSchema s_f898e2aa0b98c862 = {
   2, 5, i_f898e2aa0b98c862, nullptr, nullptr, { &s_f898e2aa0b98c862, nullptr, nullptr, 0, 0, nullptr }
 };
 #endif  // !CAPNP_LITE
-static const ::capnp::_::AlignedData<85> b_cea4422c054b82ae = {
+static const ::capnp::_::AlignedData<102> b_cea4422c054b82ae = {
   {   0,   0,   0,   0,   5,   0,   6,   0,
     174, 130,  75,   5,  44,  66, 164, 206,
      61,   0,   0,   0,   1,   0,   4,   0,
@@ -392,7 +392,7 @@ static const ::capnp::_::AlignedData<85> b_cea4422c054b82ae = {
      21,   0,   0,   0,  18,   2,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     45,   0,   0,   0, 231,   0,   0,   0,
+     45,   0,   0,   0,  31,   1,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
      83,  84,  69, 118, 101, 110, 116,  84,
@@ -404,35 +404,42 @@ static const ::capnp::_::AlignedData<85> b_cea4422c054b82ae = {
     114, 101, 115, 115, 101, 100,  46,  69,
     118, 101, 110, 116,  46,  99, 111, 109,
     109,   0,   0,   0,   0,   0,   0,   0,
-     16,   0,   0,   0,   3,   0,   4,   0,
+     20,   0,   0,   0,   3,   0,   4,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   1,   0,   5,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     97,   0,   0,   0, 122,   0,   0,   0,
+    125,   0,   0,   0, 122,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     96,   0,   0,   0,   3,   0,   1,   0,
-    108,   0,   0,   0,   2,   0,   1,   0,
+    124,   0,   0,   0,   3,   0,   1,   0,
+    136,   0,   0,   0,   2,   0,   1,   0,
       1,   0,   0,   0,   1,   0,   0,   0,
       0,   0,   1,   0,   6,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    105,   0,   0,   0, 114,   0,   0,   0,
+    133,   0,   0,   0, 114,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    104,   0,   0,   0,   3,   0,   1,   0,
-    116,   0,   0,   0,   2,   0,   1,   0,
+    132,   0,   0,   0,   3,   0,   1,   0,
+    144,   0,   0,   0,   2,   0,   1,   0,
       2,   0,   0,   0,   1,   0,   0,   0,
       0,   0,   1,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    113,   0,   0,   0,  82,   0,   0,   0,
+    141,   0,   0,   0,  82,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    112,   0,   0,   0,   3,   0,   1,   0,
-    124,   0,   0,   0,   2,   0,   1,   0,
+    140,   0,   0,   0,   3,   0,   1,   0,
+    152,   0,   0,   0,   2,   0,   1,   0,
       3,   0,   0,   0,   2,   0,   0,   0,
       0,   0,   1,   0,   8,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    121,   0,   0,   0,  66,   0,   0,   0,
+    149,   0,   0,   0,  66,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    144,   0,   0,   0,   3,   0,   1,   0,
+    156,   0,   0,   0,   2,   0,   1,   0,
+      4,   0,   0,   0,   1,   0,   0,   0,
+      0,   0,   1,   0,  12,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    153,   0,   0,   0, 146,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    116,   0,   0,   0,   3,   0,   1,   0,
-    128,   0,   0,   0,   2,   0,   1,   0,
+    156,   0,   0,   0,   3,   0,   1,   0,
+    168,   0,   0,   0,   2,   0,   1,   0,
     112, 114, 111, 100, 117,  99, 101, 114,
      84, 104, 114, 101,  97, 100,   0,   0,
       7,   0,   0,   0,   0,   0,   0,   0,
@@ -467,6 +474,16 @@ static const ::capnp::_::AlignedData<85> b_cea4422c054b82ae = {
       0,   0,   0,   0,   0,   0,   0,   0,
       9,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    112, 114, 111, 100, 117,  99, 101, 114,
+     69, 118, 101, 110, 116,  72, 105, 103,
+    104,   0,   0,   0,   0,   0,   0,   0,
+      7,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      7,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0, }
 };
 ::capnp::word const* const bp_cea4422c054b82ae = b_cea4422c054b82ae.words;
@@ -474,11 +491,11 @@ static const ::capnp::_::AlignedData<85> b_cea4422c054b82ae = {
 static const ::capnp::_::RawSchema* const d_cea4422c054b82ae[] = {
   &s_cafa57e6b5bbbc84,
 };
-static const uint16_t m_cea4422c054b82ae[] = {3, 1, 0, 2};
-static const uint16_t i_cea4422c054b82ae[] = {0, 1, 2, 3};
+static const uint16_t m_cea4422c054b82ae[] = {3, 1, 4, 0, 2};
+static const uint16_t i_cea4422c054b82ae[] = {0, 1, 2, 3, 4};
 const ::capnp::_::RawSchema s_cea4422c054b82ae = {
-  0xcea4422c054b82ae, b_cea4422c054b82ae.words, 85, d_cea4422c054b82ae, m_cea4422c054b82ae,
-  1, 4, i_cea4422c054b82ae, nullptr, nullptr, { &s_cea4422c054b82ae, nullptr, nullptr, 0, 0, nullptr }
+  0xcea4422c054b82ae, b_cea4422c054b82ae.words, 102, d_cea4422c054b82ae, m_cea4422c054b82ae,
+  1, 5, i_cea4422c054b82ae, nullptr, nullptr, { &s_cea4422c054b82ae, nullptr, nullptr, 0, 0, nullptr }
 };
 #endif  // !CAPNP_LITE
 static const ::capnp::_::AlignedData<56> b_f2caf87d6a7e9c4c = {
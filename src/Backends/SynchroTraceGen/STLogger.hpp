@@ -21,6 +21,29 @@ class STLoggerCompressed
     virtual auto flush(const STCompEventCompressed& ev, EID eid, TID tid) -> void = 0;
     /* Log a SynchroTrace aggregate Compute Event */
 
+    virtual auto flushRepeat(const STCompEventCompressed& ev, unsigned repeat, int64_t stride,
+                             EID eid, TID tid) -> void
+    {
+        /* Log 'repeat' consecutive Compute Events, the i-th being 'ev' with every
+         * address range shifted by i * 'stride' bytes, with event IDs from 'eid'.
+         * Loggers without a repeat record log each event separately */
+        STCompEventCompressed next;
+        for (unsigned i = 0; i < repeat; ++i)
+        {
+            Addr offset = static_cast<Addr>(stride) * i;
+            next.reset();
+            next.iops = ev.iops;
+            next.flops = ev.flops;
+            next.writes = ev.writes;
+            next.reads = ev.reads;
+            for (auto &range : ev.uniqueWriteAddrs.get())
+                next.uniqueWriteAddrs.insert({range.first + offset, range.second + offset});
+            for (auto &range : ev.uniqueReadAddrs.get())
+                next.uniqueReadAddrs.insert({range.first + offset, range.second + offset});
+            flush(next, eid + i, tid);
+        }
+    }
+
     virtual auto flush(const STCommEventCompressed& ev, EID eid, TID tid) -> void = 0;
     /* Log a SynchroTrace Communication Event */
 
@@ -30,13 +30,18 @@ class STShadowMemory
     struct ShadowObject
     {
         TID last_writer{SO_UNDEF};
-        EID last_writer_event{0};
-        /* Last thread/event to read/write to addr */
-    
+        uint16_t last_writer_event_hi{0};
+        uint32_t last_writer_event_lo{0};
+        /* Last thread/event to read/write to addr.
+         * The 48-bit event is split to fill the padding after the thread,
+         * so the object is no larger than with 32-bit events */
+
         std::bitset<MAX_THREADS> last_readers;
         /* A bitfield -- each bit represents a thread
          * each address can have multiple readers */
     };
+    static_assert(sizeof(ShadowObject) == 8 + MAX_THREADS / 8,
+                  "shadow object should pack the writer into 8 bytes");
 
     ShadowMemory<ShadowObject, 38, 20> sm;
     /* ADDR_BITS = 48, PM_BITS = 28 is more appropriate for DynamoRIO */
@@ -46,11 +51,13 @@ class STShadowMemory
 inline auto STShadowMemory::updateWriter(Addr addr, ByteCount bytes, TID tid, EID eid) -> void
 {
     assert(tid < MAX_THREADS);
+    assert(eid <= MAX_EID);
     for (ByteCount i = 0; i < bytes; ++i)
     {
         ShadowObject &so = sm[addr + i];
         so.last_writer = tid;
-        so.last_writer_event = eid;
+        so.last_writer_event_hi = eid >> 32;
+        so.last_writer_event_lo = eid;
         so.last_readers.reset();
     }
 }
@@ -83,7 +90,8 @@ inline auto STShadowMemory::getWriterTID(Addr addr) -> TID
 
 inline auto STShadowMemory::getWriterEID(Addr addr) -> EID
 {
-    return sm[addr].last_writer_event;
+    ShadowObject &so = sm[addr];
+    return (EID{so.last_writer_event_hi} << 32) | so.last_writer_event_lo;
 }
 
 }; //end namespace STGen
@@ -4,6 +4,13 @@
 #include "ShadowMemory.hpp" //Addr
 #include <tuple>
 #include <list>
+#include <map>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <cmath>
+#include <cstdio>
+#include <limits>
 
 /* TODO(someday) these names are confusing; change them */
 
@@ -59,9 +66,47 @@ struct LockStats
     StatCounter communication{0};
 };
 
+struct LockHistogram
+{
+    /* Statistics for every lock/unlock of one lock, in constant space.
+     * Bucket 0 counts zeros, bucket i counts values in [2**(i-1), 2**i) */
+
+    static constexpr unsigned buckets = 65;
+    using Buckets = std::array<StatCounter, buckets>;
+
+    static auto bucket(StatCounter value) -> unsigned
+    {
+        return value == 0 ? 0 : 64 - __builtin_clzll(value);
+    }
+
+    auto add(const LockStats &stats) -> void
+    {
+        ++count;
+        total.iops += stats.iops;
+        total.flops += stats.flops;
+        total.instrs += stats.instrs;
+        total.memAccesses += stats.memAccesses;
+        total.communication += stats.communication;
+        ++instrs[bucket(stats.instrs)];
+        ++memAccesses[bucket(stats.memAccesses)];
+        ++communication[bucket(stats.communication)];
+    }
+
+    StatCounter count{0};
+    LockStats total;
+    Buckets instrs{};
+    Buckets memAccesses{};
+    Buckets communication{};
+    /* hold time in instructions, and memory accesses and communication while held */
+};
+
 using AllBarriersStats = std::list<std::pair<Addr, BarrierStats>>;
 class PerBarrierStats
 {
+    /* Either keeps every barrier region in memory,
+     * or appends each region to a binary spill file as a fixed-size record:
+     * the barrier address, then iops, flops, instrs, communication,
+     * memAccesses, locks; all 64-bit in host byte order */
   public:
     auto incIOPs() -> void { ++current.iops; }
     auto incFLOPs() -> void { ++current.flops; }
@@ -71,20 +116,41 @@ class PerBarrierStats
     auto incLocks() -> void { ++current.locks; }
     auto barrier(Addr id) -> void
     {
-        barriers.push_back(std::make_pair(id, current));
+        if (spillFile != nullptr)
+        {
+            StatCounter record[] = {id, current.iops, current.flops, current.instrs,
+                                    current.communication, current.memAccesses, current.locks};
+            if (fwrite(record, sizeof(record), 1, spillFile.get()) != 1)
+                spillFailed = true;
+        }
+        else
+        {
+            barriers.push_back(std::make_pair(id, current));
+        }
         current = BarrierStats{};
     }
+    auto spill(std::shared_ptr<FILE> file) -> void { spillFile = std::move(file); }
+    auto isSpilled() const -> bool { return spillFile != nullptr; }
+    auto flushSpill() -> bool
+    {
+        return spillFile == nullptr || (fflush(spillFile.get()) == 0 && spillFailed == false);
+    }
     auto getAllBarriersStats() const -> AllBarriersStats { return barriers; }
 
   private:
     AllBarriersStats barriers;
     BarrierStats current;
+    std::shared_ptr<FILE> spillFile;
+    bool spillFailed{false};
 };
 
 using AllLocksStats = std::list<std::pair<Addr, LockStats>>;
+using LockHistograms = std::map<Addr, LockHistogram>;
 class PerLockStats
 {
     /* XXX Assumes common case of only one lock held at a time */
+    /* Either keeps every lock region in memory,
+     * or aggregates them into a histogram per lock */
   public:
     auto incIOPs() -> void { if (active == true) ++current.iops; }
     auto incFLOPs() -> void { if (active == true) ++current.flops; }
@@ -94,16 +160,86 @@ class PerLockStats
     auto lock() -> void { active = true; }
     auto unlock(Addr id) -> void
     {
-        locks.push_back(std::make_pair(id, current));
+        if (aggregated == true)
+            histograms[id].add(current);
+        else
+            locks.push_back(std::make_pair(id, current));
         current = LockStats{};
         active = false;
     }
+    auto aggregate() -> void { aggregated = true; }
+    auto isAggregated() const -> bool { return aggregated; }
     auto getAllLocksStats() const -> AllLocksStats { return locks; }
+    auto getLockHistograms() const -> const LockHistograms& { return histograms; }
 
   private:
     AllLocksStats locks;
+    LockHistograms histograms;
     LockStats current;
     bool active{false};
+    bool aggregated{false};
+};
+
+class SampleEstimator
+{
+    /* Extrapolates a thread's totals from the detailed windows of a sampled run.
+     *
+     * Each window's count per instruction is one sample of the thread's rate;
+     * a total is estimated as the mean rate times all of the thread's instructions,
+     * with a 95% confidence interval from the standard error of the rates,
+     * corrected for the finite number of windows in the run (as in SMARTS) */
+  public:
+    struct Estimate
+    {
+        double value;
+        double error;
+        /* the true total is within value +/- error with 95% confidence;
+         * error is NaN with fewer than 2 windows */
+    };
+
+    auto addWindow(const Stats &window) -> void
+    {
+        StatCounter instrs = std::get<INSTR>(window);
+        assert(instrs > 0);
+        std::array<double, INSTR> rates{static_cast<double>(std::get<IOP>(window)) / instrs,
+                                        static_cast<double>(std::get<FLOP>(window)) / instrs,
+                                        static_cast<double>(std::get<READ>(window)) / instrs,
+                                        static_cast<double>(std::get<WRITE>(window)) / instrs};
+
+        /* Welford's running mean and sum of squared differences */
+        ++windows;
+        windowInstrs += instrs;
+        for (unsigned i = 0; i < rates.size(); ++i)
+        {
+            double delta = rates[i] - mean[i];
+            mean[i] += delta / windows;
+            m2[i] += delta * (rates[i] - mean[i]);
+        }
+    }
+
+    auto estimate(StatsType type, StatCounter allInstrs) const -> Estimate
+    {
+        assert(type < INSTR);
+        if (windows == 0)
+            return {0, std::numeric_limits<double>::quiet_NaN()};
+
+        double value = mean[type] * allInstrs;
+        if (windows < 2)
+            return {value, std::numeric_limits<double>::quiet_NaN()};
+
+        double population = static_cast<double>(allInstrs) * windows / windowInstrs;
+        double correction = std::max(0.0, 1.0 - windows / population);
+        double stdError = std::sqrt(m2[type] / (windows - 1) / windows * correction);
+        return {value, 1.96 * stdError * allInstrs};
+    }
+
+    auto getWindows() const -> StatCounter { return windows; }
+
+  private:
+    StatCounter windows{0};
+    StatCounter windowInstrs{0};
+    std::array<double, INSTR> mean{};
+    std::array<double, INSTR> m2{};
 };
 
 class PerThreadStats
@@ -192,8 +328,68 @@ class PerThreadStats
         return lockStats.getAllLocksStats();
     }
 
+    auto stream(std::shared_ptr<FILE> barrierSpillFile) -> void
+    {
+        /* bounded memory: spill barrier regions to a file,
+         * and aggregate lock regions per lock */
+        barrierStats.spill(std::move(barrierSpillFile));
+        lockStats.aggregate();
+    }
+
+    auto isStreaming() const -> bool
+    {
+        return barrierStats.isSpilled();
+    }
+
+    auto flushStream() -> bool
+    {
+        return barrierStats.flushSpill();
+    }
+
+    auto getLockHistograms() const -> const LockHistograms&
+    {
+        return lockStats.getLockHistograms();
+    }
+
+    auto skipInstr() -> void
+    {
+        ++skippedInstrs;
+    }
+
+    auto endSample() -> void
+    {
+        /* closes a detailed window of a sampled run */
+        Stats window{std::get<IOP>(stats) - std::get<IOP>(sampleStart),
+                     std::get<FLOP>(stats) - std::get<FLOP>(sampleStart),
+                     std::get<READ>(stats) - std::get<READ>(sampleStart),
+                     std::get<WRITE>(stats) - std::get<WRITE>(sampleStart),
+                     std::get<INSTR>(stats) - std::get<INSTR>(sampleStart)};
+        if (std::get<INSTR>(window) > 0)
+            sampling.addWindow(window);
+        sampleStart = stats;
+    }
+
+    auto isSampled() const -> bool
+    {
+        return skippedInstrs > 0;
+    }
+
+    auto getSkippedInstrs() const -> StatCounter
+    {
+        return skippedInstrs;
+    }
+
+    auto getSampling() const -> const SampleEstimator&
+    {
+        return sampling;
+    }
+
   private:
     Stats stats{0,0,0,0,0};
+    Stats sampleStart{0,0,0,0,0};
+    StatCounter skippedInstrs{0};
+    SampleEstimator sampling;
+    /* instructions outside detailed windows, and the windows' counts */
     PerBarrierStats barrierStats;
     PerLockStats lockStats;
 };
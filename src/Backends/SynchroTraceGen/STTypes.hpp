@@ -10,14 +10,19 @@ namespace STGen
 {
 
 using TID = int16_t;
-using EID = uint32_t;
-/* XXX Thread ID (TID) and Event ID (EID)
- * set to 16-bits and 32-bits for memory usage considerations.
- * Increasing the sizes may be required in the future. */
+using EID = uint64_t;
+constexpr EID MAX_EID = (EID{1} << 48) - 1;
+/* XXX Thread ID (TID) set to 16-bits for memory usage considerations.
+ * Event IDs (EID) are limited to 48-bits, so that shadow memory
+ * and the trace schemas can pack them without growing */
 
 //-----------------------------------------------------------------------------
 /** Synchronization **/
 
+constexpr unsigned char ST_SYNC_BARRIER = 5;
+/* SynchroTrace numbers sync events differently from Prism;
+ * this is the trace's code for a PRISM_SYNC_BARRIER */
+
 using SpawnList = std::vector<std::pair<TID, Addr>>;
 /* Vector of:
  * - spawner
@@ -35,6 +40,14 @@ using BarrierList = std::vector<std::pair<Addr, std::set<TID>>>;
 using ThreadStatMap = std::map<TID, PerThreadStats>;
 /* Metrics per thread */
 
+using SegmentList = std::vector<std::pair<unsigned, EID>>;
+/* Vector of:
+ * - barrier region the trace segment belongs to
+ * - first event ID of the thread in that segment */
+
+using ThreadSegmentMap = std::map<TID, SegmentList>;
+/* Trace segments per thread */
+
 };
 
 #endif
@@ -30,6 +30,25 @@ auto flushInstrMarker(int limit, std::shared_ptr<spdlog::logger> &logger) -> voi
     logger->info("! {}", limit);
 }
 
+
+auto formatHistogram(const LockHistogram::Buckets &buckets) -> std::string
+{
+    /* non-empty buckets only, labelled by their exclusive upper bound */
+    std::string ret;
+    for (unsigned i = 0; i < buckets.size(); ++i)
+    {
+        if (buckets[i] == 0)
+            continue;
+        if (ret.empty() == false)
+            ret += ' ';
+        if (i == 0)
+            fmt::format_to(std::back_inserter(ret), "0:{}", buckets[i]);
+        else
+            fmt::format_to(std::back_inserter(ret), "<2^{}:{}", i, buckets[i]);
+    }
+    return ret;
+}
+
 }; //end namespace
 
 
@@ -244,7 +263,27 @@ auto flushStats(std::string filePath, ThreadStatMap allThreadsStats) -> void
         logger->info("\tReads : {}", std::get<READ>(stats));
         logger->info("\tWrites: {}", std::get<WRITE>(stats));
 
-        totalInstrs += std::get<INSTR>(stats);
+        totalInstrs += std::get<INSTR>(stats) + p.second.getSkippedInstrs();
+
+        if (p.second.isSampled() == true)
+        {
+            /* counts above are for the detailed windows only */
+            auto &sampling = p.second.getSampling();
+            StatCounter allInstrs = std::get<INSTR>(stats) + p.second.getSkippedInstrs();
+            logger->info("\tSampled instrs: {} of {} ({:.4f}) in {} windows",
+                         std::get<INSTR>(stats), allInstrs,
+                         static_cast<double>(std::get<INSTR>(stats)) / allInstrs,
+                         sampling.getWindows());
+
+            const std::pair<StatsType, const char*> estimated[] = {
+                {IOP, "IOPS  "}, {FLOP, "FLOPS "}, {READ, "Reads "}, {WRITE, "Writes"}};
+            for (auto &type : estimated)
+            {
+                auto estimate = sampling.estimate(type.first, allInstrs);
+                logger->info("\tEstimated {}: {:.0f} +/- {:.0f} (95%)",
+                             type.second, estimate.value, estimate.error);
+            }
+        }
 
         AllBarriersStats barrierStatsForThread = p.second.getBarrierStats();
         for (auto &p : barrierStatsForThread)
@@ -273,24 +312,62 @@ auto flushStats(std::string filePath, ThreadStatMap allThreadsStats) -> void
             logger->info("\t\tMemAccesses: {}",   p.second.memAccesses);
             logger->info("\t\tCommunication: {}", p.second.communication);
         }
+
+        if (p.second.isStreaming() == true)
+        {
+            logger->info("\tBarriers: sigil.barriers.out-{}.bin", tid);
+            for (auto &lock : p.second.getLockHistograms())
+            {
+                /* per lock, all of its lock regions */
+                auto &hist = lock.second;
+                logger->info("\tLock: {}",                lock.first);
+                logger->info("\t\tRegions: {}",           hist.count);
+                logger->info("\t\tIOPs: {}",              hist.total.iops);
+                logger->info("\t\tFLOPs: {}",             hist.total.flops);
+                logger->info("\t\tInstrs: {}",            hist.total.instrs);
+                logger->info("\t\tMemAccesses: {}",       hist.total.memAccesses);
+                logger->info("\t\tCommunication: {}",     hist.total.communication);
+                logger->info("\t\tInstrs/Region: {}",     formatHistogram(hist.instrs));
+                logger->info("\t\tMemAccesses/Region: {}", formatHistogram(hist.memAccesses));
+                logger->info("\t\tCommunication/Region: {}",
+                             formatHistogram(hist.communication));
+            }
+        }
     }
 
-    logger->info("Barrier statistics for all threads:");
-    AllBarriersStats mergedBarrierStats;
-    for (auto &p : allThreadsStats)
-        BarrierMerge::merge(p.second.getBarrierStats(), mergedBarrierStats);
-    for (auto &p : mergedBarrierStats)
+    bool streaming = (allThreadsStats.empty() == false &&
+                      allThreadsStats.begin()->second.isStreaming() == true);
+    if (streaming == true)
+    {
+        /* regions were spilled as they completed; see PerBarrierStats for the format */
+        logger->info("Barrier statistics for all threads: see sigil.barriers.out-*.bin");
+    }
+    else
     {
-        /* per barrier region, all threads */
-        logger->info("Barrier: ",       p.first);
-        logger->info("\tIOPs: ",        p.second.iops);
-        logger->info("\tFLOPs: ",       p.second.flops);
-        logger->info("\tInstrs: ",      p.second.instrs);
-        logger->info("\tMemAccesses: ", p.second.memAccesses);
-        logger->info("\tlocks: ",       p.second.locks);
-        logger->info("\tIOPs/Mem: ",    p.second.iopsPerMemAccess());
-        logger->info("\tFLOPs/Mem: ",   p.second.flopsPerMemAccess());
-        logger->info("\tlocks/OPs: ",   p.second.locksPerIopsPlusFlops());
+        logger->info("Barrier statistics for all threads:");
+        std::vector<AllBarriersStats> threadBarrierStats;
+        BarrierMerge::ThreadBarriers threadBarriers;
+        threadBarrierStats.reserve(allThreadsStats.size());
+        for (auto &p : allThreadsStats)
+        {
+            threadBarrierStats.push_back(p.second.getBarrierStats());
+            threadBarriers.push_back(&threadBarrierStats.back());
+        }
+        auto mergedBarrierStats = BarrierMerge::merge(threadBarriers,
+                                                      std::thread::hardware_concurrency());
+        for (auto &p : mergedBarrierStats)
+        {
+            /* per barrier region, all threads */
+            logger->info("Barrier: ",       p.first);
+            logger->info("\tIOPs: ",        p.second.iops);
+            logger->info("\tFLOPs: ",       p.second.flops);
+            logger->info("\tInstrs: ",      p.second.instrs);
+            logger->info("\tMemAccesses: ", p.second.memAccesses);
+            logger->info("\tlocks: ",       p.second.locks);
+            logger->info("\tIOPs/Mem: ",    p.second.iopsPerMemAccess());
+            logger->info("\tFLOPs/Mem: ",   p.second.flopsPerMemAccess());
+            logger->info("\tlocks/OPs: ",   p.second.locksPerIopsPlusFlops());
+        }
     }
 
     logger->info("Total instructions for all threads: {}", totalInstrs);
@@ -298,4 +375,28 @@ auto flushStats(std::string filePath, ThreadStatMap allThreadsStats) -> void
     prism::blockingFlushAndDeleteLogger(logger);
 }
 
+
+auto flushSegments(std::string filePath, ThreadSegmentMap allThreadsSegments) -> void
+{
+    auto loggerPair = prism::getFileLogger(filePath);
+    auto logger = std::move(loggerPair.first);
+    info("Flushing trace segments to: " + logger->name());
+
+    /* One line per thread per barrier region, ordered by region.
+     * Each region's traces are in 'region-N/', named as usual,
+     * and the thread's event IDs in that segment start from 'first_eid' */
+    std::map<unsigned, std::vector<std::pair<TID, EID>>> regions;
+    for (auto &p : allThreadsSegments)
+        for (auto &segment : p.second)
+            regions[segment.first].emplace_back(p.first, segment.second);
+
+    logger->info("region,directory,tid,first_eid");
+    for (auto &p : regions)
+        for (auto &thread : p.second)
+            logger->info("{},region-{},{},{}", p.first, p.first, thread.first, thread.second);
+
+    logger->flush();
+    prism::blockingFlushAndDeleteLogger(logger);
+}
+
 }; //end namespace STGen
@@ -71,6 +71,8 @@ auto flushPthread(std::string filePath,
 
 auto flushStats(std::string filePath, ThreadStatMap allThreadsStats) -> void;
 
+auto flushSegments(std::string filePath, ThreadSegmentMap allThreadsSegments) -> void;
+
 }; //end namespace STGen
 
 #endif
@@ -3,26 +3,95 @@
 #include "TextLoggerV2.hpp"
 #include "CapnLogger.hpp"
 #include "NullLogger.hpp"
+#include "RepeatLogger.hpp"
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
 
 using PrismLog::fatal;
 
 namespace STGen
 {
 
+namespace
+{
+
+auto segmentPath(const std::string &outputPath, unsigned region) -> std::string
+{
+    /* each barrier region gets a directory laid out like a normal output directory */
+    auto path = outputPath + "/region-" + std::to_string(region);
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+        fatal(std::string("creating trace segment directory: ") + strerror(errno));
+    return path;
+}
+
+auto streamStats(PerThreadStats &stats, const std::string &outputPath, TID tid) -> void
+{
+    auto path = outputPath + "/sigil.barriers.out-" + std::to_string(tid) + ".bin";
+    std::shared_ptr<FILE> file(fopen(path.c_str(), "wb"), [](FILE *f) { if (f) fclose(f); });
+    if (file == nullptr)
+        fatal(std::string("opening barrier statistics file: ") + strerror(errno));
+    stats.stream(std::move(file));
+}
+
+auto openCommMatrix(TID tid, const ThreadContextOptions &options,
+                    unsigned barriers) -> std::unique_ptr<CommMatrix>
+{
+    if (options.commWindow == 0)
+        return nullptr;
+    assert(options.commLog != nullptr);
+
+    /* barrier regions are numbered the same way for every thread */
+    unsigned firstWindow = (options.commWindow == CommMatrix::PER_BARRIER ? barriers : 0);
+    return std::make_unique<CommMatrix>(tid, options.commWindow, firstWindow, options.commLog);
+}
+
+auto openPcProfile(unsigned pcPairs, const std::string &outputPath) -> std::unique_ptr<PcProfile>
+{
+    if (pcPairs == 0)
+        return nullptr;
+    return std::make_unique<PcProfile>(PcPairs::open(outputPath, pcPairs));
+}
+
+auto flushStatsStream(PerThreadStats &stats, TID tid) -> void
+{
+    if (stats.flushStream() == false)
+        fatal("writing barrier statistics for thread: " + std::to_string(tid));
+}
+
+}; //end namespace
+
 //-----------------------------------------------------------------------------
 /** Compressed ThreadContext **/
 ThreadContextCompressed::ThreadContextCompressed(TID tid,
-                                                 unsigned primsPerStCompEv,
-                                                 std::string outputPath,
-                                                 std::string loggerType)
+                                                 const ThreadContextOptions &options)
     : tid(tid)
-    , primsPerStCompEv(primsPerStCompEv)
+    , primsPerStCompEv(options.primsPerStCompEv)
+    , outputPath(options.outputPath)
+    , loggerType(options.loggerType)
+    , barriersPerSegment(options.barriersPerSegment)
+    , maxRepeat(options.maxRepeat)
 {
     /* current shadow memory limit */
     assert(tid <= 128);
     assert(primsPerStCompEv > 0 && primsPerStCompEv <= 100);
 
-    logger = getLogger(tid, outputPath, loggerType);
+    if (options.streamingStats == true)
+        streamStats(stats, outputPath, tid);
+
+    barriers = maxBarriers.load();
+    comm = openCommMatrix(tid, options, barriers);
+    pcs = openPcProfile(options.pcPairs, outputPath);
+
+    if (barriersPerSegment > 0)
+    {
+        segments.emplace_back(barriers / barriersPerSegment, events);
+        logger = openLogger(segmentPath(outputPath, segments.back().first));
+    }
+    else
+    {
+        logger = openLogger(outputPath);
+    }
 }
 
 
@@ -30,6 +99,7 @@ ThreadContextCompressed::~ThreadContextCompressed()
 {
     compFlushIfActive();
     commFlushIfActive();
+    flushStatsStream(stats, tid);
 }
 
 
@@ -39,6 +109,12 @@ auto ThreadContextCompressed::getStats() const -> PerThreadStats
 }
 
 
+auto ThreadContextCompressed::getSegments() const -> SegmentList
+{
+    return segments;
+}
+
+
 auto ThreadContextCompressed::onIop() -> void
 {
     commFlushIfActive();
@@ -76,6 +152,10 @@ auto ThreadContextCompressed::onRead(Addr start, Addr bytes) -> void
             {
                 isCommEdge = true;
                 stComm.addEdge(writer, shadow.getWriterEID(addr), addr);
+                if (comm != nullptr)
+                    comm->onComm(writer, 1);
+                if (pcs != nullptr)
+                    pcs->onComm(addr, 1);
             }
             else /*local load, comp event*/
             {
@@ -121,6 +201,8 @@ auto ThreadContextCompressed::onWrite(Addr start, Addr bytes) -> void
     try
     {
         shadow.updateWriter(start, bytes, tid, events);
+        if (pcs != nullptr)
+            pcs->onWrite(start, bytes);
     }
     catch(std::out_of_range &e)
     {
@@ -143,12 +225,20 @@ auto ThreadContextCompressed::onSync(unsigned char syncType,
 
     if (INCR_EID_OVERFLOW(events))
         fatal("Event ID overflow detected in thread: " + std::to_string(tid));
+
+    /* SynchroTrace barrier wait */
+    if (syncType == ST_SYNC_BARRIER)
+        segmentOnBarrier();
 }
 
 
-auto ThreadContextCompressed::onInstr() -> void
+auto ThreadContextCompressed::onInstr(Addr pc) -> void
 {
     stats.incInstrs();
+    if (comm != nullptr)
+        comm->onInstr();
+    if (pcs != nullptr)
+        pcs->onInstr(pc);
 
     /* add marker every 2**N instructions */
     constexpr int limit = 1 << 12;
@@ -200,6 +290,67 @@ auto ThreadContextCompressed::flushAll() -> void
 }
 
 
+auto ThreadContextCompressed::onSkippedInstr(Addr pc) -> void
+{
+    stats.skipInstr();
+    if (pcs != nullptr)
+        pcs->onInstr(pc);
+}
+
+
+auto ThreadContextCompressed::onSkippedWrite(Addr start, Addr bytes) -> void
+{
+    /* the producer is the thread's next event, which is conservative:
+     * a consumer waits at least until the write is done */
+    try
+    {
+        shadow.updateWriter(start, bytes, tid, events);
+        if (pcs != nullptr)
+            pcs->onWrite(start, bytes);
+    }
+    catch(std::out_of_range &e)
+    {
+        warn(e.what());
+    }
+}
+
+
+auto ThreadContextCompressed::endSample() -> void
+{
+    compFlushIfActive();
+    commFlushIfActive();
+    stats.endSample();
+}
+
+
+auto ThreadContextCompressed::segmentOnBarrier() -> void
+{
+    ++barriers;
+    unsigned seen = maxBarriers.load();
+    while (seen < barriers && maxBarriers.compare_exchange_weak(seen, barriers) == false);
+
+    if (comm != nullptr)
+        comm->onBarrier();
+
+    if (barriersPerSegment > 0 && barriers % barriersPerSegment == 0)
+    {
+        /* the barrier event closes the current segment */
+        logger.reset();
+        segments.emplace_back(barriers / barriersPerSegment, events);
+        logger = openLogger(segmentPath(outputPath, segments.back().first));
+    }
+}
+
+
+auto ThreadContextCompressed::openLogger(std::string path) -> LogPtr
+{
+    if (maxRepeat > 1)
+        return std::make_unique<RepeatLogger>(getLogger(tid, path, loggerType), maxRepeat);
+    else
+        return getLogger(tid, path, loggerType);
+}
+
+
 auto ThreadContextCompressed::getLogger(TID tid, std::string outputPath,
                                         std::string loggerType) -> LogPtr
 {
@@ -219,23 +370,40 @@ auto ThreadContextCompressed::getLogger(TID tid, std::string outputPath,
 //-----------------------------------------------------------------------------
 /** Uncompressed ThreadContext **/
 ThreadContextUncompressed::ThreadContextUncompressed(TID tid,
-                                                     unsigned primsPerStCompEv,
-                                                     std::string outputPath,
-                                                     std::string loggerType)
+                                                     const ThreadContextOptions &options)
     : tid(tid)
-    , primsPerStCompEv(primsPerStCompEv)
+    , primsPerStCompEv(options.primsPerStCompEv)
+    , outputPath(options.outputPath)
+    , loggerType(options.loggerType)
+    , barriersPerSegment(options.barriersPerSegment)
 {
     /* current shadow memory limit */
     assert(tid <= 128);
     assert(primsPerStCompEv > 0 && primsPerStCompEv <= 100);
 
-    logger = getLogger(tid, outputPath, loggerType);
+    if (options.streamingStats == true)
+        streamStats(stats, outputPath, tid);
+
+    barriers = maxBarriers.load();
+    comm = openCommMatrix(tid, options, barriers);
+    pcs = openPcProfile(options.pcPairs, outputPath);
+
+    if (barriersPerSegment > 0)
+    {
+        segments.emplace_back(barriers / barriersPerSegment, events);
+        logger = getLogger(tid, segmentPath(outputPath, segments.back().first), loggerType);
+    }
+    else
+    {
+        logger = getLogger(tid, outputPath, loggerType);
+    }
 }
 
 
 ThreadContextUncompressed::~ThreadContextUncompressed()
 {
     compFlushIfActive();
+    flushStatsStream(stats, tid);
 }
 
 
@@ -245,6 +413,12 @@ auto ThreadContextUncompressed::getStats() const -> PerThreadStats
 }
 
 
+auto ThreadContextUncompressed::getSegments() const -> SegmentList
+{
+    return segments;
+}
+
+
 auto ThreadContextUncompressed::onIop() -> void
 {
     stComp.incIOP();
@@ -262,12 +436,13 @@ auto ThreadContextUncompressed::onFlop() -> void
 auto ThreadContextUncompressed::onRead(Addr start, Addr bytes) -> void
 {
     /* Each byte of the read may have been touched by a different thread
-     * If one byte was touched by another thread, consider the entire read
-     * a communication event, from that thread without checking the rest of the
-     * bytes. The case where a single 'read' was written to by multiple threads
-     * is rare in our use case of user-space synchronization e.g. spinlocks.
+     * If one byte was touched by another thread, the trace records the entire
+     * read as a communication event, from the first such thread. The case
+     * where a single 'read' was written to by multiple threads is rare in our
+     * use case of user-space synchronization e.g. spinlocks.
      *
-     * TODO MDL20170321 Create parity with compressed read event */
+     * Every byte is still checked, as in the compressed read event, so the
+     * communication matrix and PC pairs count each byte against its own writer */
 
     bool isCommEdge = false;
     TID producerTID{0};
@@ -286,10 +461,16 @@ auto ThreadContextUncompressed::onRead(Addr start, Addr bytes) -> void
 
             if /*comm edge*/((isReader == false) && (writer != tid) && (writer != SO_UNDEF))
             {
-                isCommEdge = true;
-                producerTID = writer;
-                producerEID = shadow.getWriterEID(addr);
-                break;
+                if (isCommEdge == false)
+                {
+                    isCommEdge = true;
+                    producerTID = writer;
+                    producerEID = shadow.getWriterEID(addr);
+                }
+                if (comm != nullptr)
+                    comm->onComm(writer, 1);
+                if (pcs != nullptr)
+                    pcs->onComm(addr, 1);
             }
         }
         catch(std::out_of_range &e)
@@ -315,6 +496,8 @@ auto ThreadContextUncompressed::onWrite(Addr start, Addr bytes) -> void
     try
     {
         shadow.updateWriter(start, bytes, tid, events);
+        if (pcs != nullptr)
+            pcs->onWrite(start, bytes);
     }
     catch(std::out_of_range &e)
     {
@@ -334,12 +517,20 @@ auto ThreadContextUncompressed::onSync(unsigned char syncType,
 
     if (INCR_EID_OVERFLOW(events))
         fatal("Event ID overflow detected in thread: " + std::to_string(tid));
+
+    /* SynchroTrace barrier wait */
+    if (syncType == ST_SYNC_BARRIER)
+        segmentOnBarrier();
 }
 
 
-auto ThreadContextUncompressed::onInstr() -> void
+auto ThreadContextUncompressed::onInstr(Addr pc) -> void
 {
     stats.incInstrs();
+    if (comm != nullptr)
+        comm->onInstr();
+    if (pcs != nullptr)
+        pcs->onInstr(pc);
 
     /* add marker every 2**N instructions */
     constexpr int limit = 1 << 12;
@@ -390,6 +581,55 @@ auto ThreadContextUncompressed::flushAll() -> void
 }
 
 
+auto ThreadContextUncompressed::onSkippedInstr(Addr pc) -> void
+{
+    stats.skipInstr();
+    if (pcs != nullptr)
+        pcs->onInstr(pc);
+}
+
+
+auto ThreadContextUncompressed::onSkippedWrite(Addr start, Addr bytes) -> void
+{
+    try
+    {
+        shadow.updateWriter(start, bytes, tid, events);
+        if (pcs != nullptr)
+            pcs->onWrite(start, bytes);
+    }
+    catch(std::out_of_range &e)
+    {
+        warn(e.what());
+    }
+}
+
+
+auto ThreadContextUncompressed::endSample() -> void
+{
+    compFlushIfActive();
+    stats.endSample();
+}
+
+
+auto ThreadContextUncompressed::segmentOnBarrier() -> void
+{
+    ++barriers;
+    unsigned seen = maxBarriers.load();
+    while (seen < barriers && maxBarriers.compare_exchange_weak(seen, barriers) == false);
+
+    if (comm != nullptr)
+        comm->onBarrier();
+
+    if (barriersPerSegment > 0 && barriers % barriersPerSegment == 0)
+    {
+        /* the barrier event closes the current segment */
+        logger.reset();
+        segments.emplace_back(barriers / barriersPerSegment, events);
+        logger = getLogger(tid, segmentPath(outputPath, segments.back().first), loggerType);
+    }
+}
+
+
 auto ThreadContextUncompressed::getLogger(TID tid, std::string outputPath,
                                           std::string loggerType) -> LogPtr
 {
@@ -10,20 +10,43 @@
  * out what to do with them */
 #define ALLOW_ADDRESS_OVERFLOW 1
 #include "STShadowMemory.hpp"
+#include "CommMatrix.hpp"
+#include "PcProfile.hpp"
 
-/* XXX overflow builtin not in GCC <5.
- * This overflow check should only be used for
+/* This overflow check should only be used for
  * variables which increment by 1 each time. */
-#if __GNUC__ >= 5
-#define INCR_EID_OVERFLOW(var) __builtin_add_overflow(var, 1, &var)
-#else
-#define INCR_EID_OVERFLOW(var) (var == UINT_MAX ? true : (var += 1) && false)
-#endif
+#define INCR_EID_OVERFLOW(var) (var == MAX_EID ? true : ((var += 1), false))
 
 
 namespace STGen
 {
 
+struct ThreadContextOptions
+{
+    unsigned primsPerStCompEv{100};
+    /* compression level of events */
+
+    std::string outputPath{"."};
+    std::string loggerType;
+
+    unsigned barriersPerSegment{0};
+    /* start a new trace segment every N barriers, if non-zero;
+     * barriers are counted per thread, so a thread's N-th barrier
+     * begins its segment N / barriersPerSegment */
+
+    unsigned maxRepeat{0};
+    /* fold runs of up to N strided compute events into one record, if > 1;
+     * only compressed events are folded */
+
+    bool streamingStats{false};
+    unsigned pcPairs{0};
+
+    unsigned commWindow{0};
+    std::shared_ptr<CommLog> commLog;
+    /* shared by every thread, if 'commWindow' is non-zero */
+};
+
+
 class ThreadContext
 {
     /* SynchroTraceGen makes use of 3 SynchroTrace events,
@@ -35,6 +58,7 @@ class ThreadContext
   public:
     virtual ~ThreadContext() {}
     virtual auto getStats() const -> PerThreadStats = 0;
+    virtual auto getSegments() const -> SegmentList = 0;
     virtual auto onIop() -> void = 0;
     virtual auto onFlop() -> void = 0;
     virtual auto onRead(Addr start, Addr bytes) -> void = 0;
@@ -43,11 +67,23 @@ class ThreadContext
     /* sync functions support one or two arguments;
      * the second argument is optional */
 
-    virtual auto onInstr() -> void = 0;
+    virtual auto onInstr(Addr pc) -> void = 0;
     virtual auto flushAll() -> void = 0;
 
+    virtual auto onSkippedInstr(Addr pc) -> void = 0;
+    virtual auto onSkippedWrite(Addr start, Addr bytes) -> void = 0;
+    virtual auto endSample() -> void = 0;
+    /* Sampling: outside detailed windows, only instructions are counted,
+     * and writes only update shadow memory, so that reads in later windows
+     * still find their producer; endSample closes a detailed window */
+
   protected:
     static STShadowMemory shadow; // Shadow memory is shared amongst all threads
+
+    static std::atomic<unsigned> maxBarriers;
+    /* Most barriers passed by any one thread so far.
+     * Threads created later start in the barrier region
+     * the other threads have already reached */
 };
 
 
@@ -55,24 +91,31 @@ class ThreadContextCompressed : public ThreadContext
 {
     using LogPtr = std::unique_ptr<STLoggerCompressed>;
   public:
-    ThreadContextCompressed(TID tid, unsigned primsPerStCompEv,
-                            std::string outputPath, std::string loggerType);
+    ThreadContextCompressed(TID tid, const ThreadContextOptions &options);
     ~ThreadContextCompressed();
 
     auto getStats() const -> PerThreadStats override final;
+    auto getSegments() const -> SegmentList override final;
     auto onIop() -> void override final;
     auto onFlop() -> void override final;
     auto onRead(Addr start, Addr bytes) -> void override final;
     auto onWrite(Addr start, Addr bytes) -> void override final;
     auto onSync(unsigned char syncType, unsigned numArgs, Addr *syncArgs) -> void override final;
-    auto onInstr() -> void override final;
+    auto onInstr(Addr pc) -> void override final;
     auto flushAll() -> void override final;
+    auto onSkippedInstr(Addr pc) -> void override final;
+    auto onSkippedWrite(Addr start, Addr bytes) -> void override final;
+    auto endSample() -> void override final;
+
+    static auto getLogger(TID tid, std::string outputPath, std::string loggerType) -> LogPtr;
+    /* also used to re-encode existing traces (stgen-convert) */
 
   private:
     auto checkCompFlushLimit() -> void;
     auto compFlushIfActive() -> void;
     auto commFlushIfActive() -> void;
-    static auto getLogger(TID tid, std::string outputPath, std::string loggerType) -> LogPtr;
+    auto segmentOnBarrier() -> void;
+    auto openLogger(std::string path) -> LogPtr;
 
     STCompEventCompressed stComp;
     STCommEventCompressed stComm;
@@ -81,11 +124,28 @@ class ThreadContextCompressed : public ThreadContext
     unsigned primsPerStCompEv;
     /* compression level of events */
 
-    StatCounter events{0};
+    EID events{0};
     PerThreadStats stats;
     /* track statistics */
 
     LogPtr logger;
+    std::string outputPath;
+    std::string loggerType;
+
+    unsigned barriersPerSegment;
+    unsigned barriers{0};
+    SegmentList segments;
+    /* start a new trace segment every 'barriersPerSegment' barriers, if non-zero;
+     * 'barriers' counts this thread's barriers, not the whole program's */
+
+    std::unique_ptr<CommMatrix> comm;
+    /* bytes communicated from each producer thread, per window; null if disabled */
+
+    std::unique_ptr<PcProfile> pcs;
+    /* bytes communicated per producer/consumer instruction pair; null if disabled */
+
+    unsigned maxRepeat;
+    /* fold runs of up to 'maxRepeat' strided compute events into one record, if > 1 */
 };
 
 
@@ -93,24 +153,29 @@ class ThreadContextUncompressed : public ThreadContext
 {
     using LogPtr = std::unique_ptr<STLoggerUncompressed>;
   public:
-    ThreadContextUncompressed(TID tid, unsigned primsPerStCompEv,
-                              std::string outputPath, std::string loggerType);
+    ThreadContextUncompressed(TID tid, const ThreadContextOptions &options);
     ~ThreadContextUncompressed();
 
     auto getStats() const -> PerThreadStats override final;
+    auto getSegments() const -> SegmentList override final;
     auto onIop() -> void override final;
     auto onFlop() -> void override final;
     auto onRead(Addr start, Addr bytes) -> void override final;
     auto onWrite(Addr start, Addr bytes) -> void override final;
     auto onSync(unsigned char syncType, unsigned numArgs, Addr *syncArgs) -> void override final;
-    auto onInstr() -> void override final;
+    auto onInstr(Addr pc) -> void override final;
     auto flushAll() -> void override final;
+    auto onSkippedInstr(Addr pc) -> void override final;
+    auto onSkippedWrite(Addr start, Addr bytes) -> void override final;
+    auto endSample() -> void override final;
+
+    static auto getLogger(TID tid, std::string outputPath, std::string loggerType) -> LogPtr;
 
   private:
     auto compFlushIfActive() -> void;
     auto compFlush(STCompEventUncompressed::MemType type, Addr start, Addr end) -> void;
     auto commFlush(EID producerEID, TID producerTID, Addr start, Addr end) -> void;
-    static auto getLogger(TID tid, std::string outputPath, std::string loggerType) -> LogPtr;
+    auto segmentOnBarrier() -> void;
 
     STCompEventUncompressed stComp;
 
@@ -118,11 +183,25 @@ class ThreadContextUncompressed : public ThreadContext
     unsigned primsPerStCompEv;
     /* compression level of events */
 
-    StatCounter events{0};
+    EID events{0};
     PerThreadStats stats;
     /* track statistics */
 
     LogPtr logger;
+    std::string outputPath;
+    std::string loggerType;
+
+    unsigned barriersPerSegment;
+    unsigned barriers{0};
+    SegmentList segments;
+    /* start a new trace segment every 'barriersPerSegment' barriers, if non-zero;
+     * 'barriers' counts this thread's barriers, not the whole program's */
+
+    std::unique_ptr<CommMatrix> comm;
+    /* bytes communicated from each producer thread, per window; null if disabled */
+
+    std::unique_ptr<PcProfile> pcs;
+    /* bytes communicated per producer/consumer instruction pair; null if disabled */
 };
 
 }; //end namespace STGen
@@ -1,6 +1,7 @@
 #include "Utils/PrismLog.hpp"
 #include "StgenCapnpParser.hpp"
 #include "argparse/argparse.hpp"
+#include <algorithm>
 
 using Event = EventStreamCompressed::Event;
 using SyncType = EventStreamCompressed::Event::SyncType;
@@ -23,6 +24,11 @@ auto parseStgenCapnp(std::string fpath) {
                     auto reads [[maybe_unused]]  = comp.getReads();
                     auto writes [[maybe_unused]] = comp.getWrites();
 
+                    // the record stands for 'repeat' events (0 means 1),
+                    // the i-th with its addresses shifted by i * 'stride' bytes
+                    auto repeat [[maybe_unused]] = std::max(comp.getRepeat(), 1U);
+                    auto stride [[maybe_unused]] = comp.getStride();
+
                     if (comp.hasReadAddrs()) {
                         for (auto addr : comp.getReadAddrs()) {
                             (void)addr;
@@ -40,7 +46,8 @@ auto parseStgenCapnp(std::string fpath) {
                 if (event.getComm().hasEdges()) {
                     for (auto comm : event.getComm().getEdges()) {
                         auto producerThread [[maybe_unused]] = comm.getProducerThread();
-                        auto producerEvent [[maybe_unused]]  = comm.getProducerEvent();
+                        auto producerEvent [[maybe_unused]]  = (uint64_t{comm.getProducerEventHigh()} << 32) |
+                                                               comm.getProducerEvent();
                         for (auto addr : comm.getAddrs()) {
                             auto start [[maybe_unused]] = addr.getStart();
                             auto end [[maybe_unused]]   = addr.getEnd();
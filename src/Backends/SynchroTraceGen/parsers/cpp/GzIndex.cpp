@@ -0,0 +1,530 @@
+#include "Utils/PrismLog.hpp"
+#include "GzIndex.hpp"
+#include "STEventTraceSchemas/STEventTraceCompressed.capnp.h"
+#include "STEventTraceSchemas/STEventTraceUncompressed.capnp.h"
+#include <capnp/message.h>
+#include <capnp/serialize-packed.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+constexpr char indexMagic[8] = {'S', 'T', 'G', 'Z', 'I', 'D', 'X', '\0'};
+constexpr uint32_t indexVersion = 1;
+constexpr size_t windowSize = 1UL << 15;
+constexpr size_t chunkSize = 1UL << 20;
+
+auto endsWith(const std::string &str, const std::string &suffix) -> bool {
+    return (str.size() >= suffix.size() &&
+            str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0);
+}
+
+template <typename T>
+auto put(std::ofstream &ofs, const T &val) -> void {
+    ofs.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template <typename T>
+auto get(std::ifstream &ifs) -> T {
+    T val;
+    if (!ifs.read(reinterpret_cast<char*>(&val), sizeof(T)))
+        PrismLog::fatal("truncated gz index file");
+    return val;
+}
+
+
+class IndexBuilder {
+    // An access point is first recorded at a deflate block boundary,
+    // and then completed once the scanner reaches the next event boundary.
+    // Only one access point is pending at a time, so no two access points
+    // ever resolve to the same event.
+  public:
+    explicit IndexBuilder(GzIndex &index) : index(index) {}
+
+    auto onBlockBoundary(const GzInflater &inflater) -> void {
+        if (pending == false &&
+            (index.points.empty() ||
+             inflater.totalOut() - index.points.back().out >= index.span)) {
+            point = inflater.accessPoint();
+            pending = true;
+        }
+    }
+
+    auto onEvent(const EventPosition &pos) -> void {
+        if (pending == true && pos.offset >= point.out) {
+            point.first = pos;
+            index.points.emplace_back(std::move(point));
+            pending = false;
+        }
+    }
+
+  private:
+    GzIndex &index;
+    GzAccessPoint point;
+    bool pending{false};
+};
+
+
+auto scanText(GzInflater &inflater, IndexBuilder &builder) -> EventPosition {
+    // Each line is one event, except instruction markers which start with '!'.
+    // This holds for both the v1 and v2 text formats.
+    std::vector<char> buf(chunkSize);
+    EventPosition pos;
+    uint64_t base = 0;
+    bool lineStart = true;
+
+    while (size_t n = inflater.read(buf.data(), buf.size())) {
+        const char *p = buf.data();
+        const char *end = p + n;
+        while (p < end) {
+            if (lineStart) {
+                pos.offset = base + (p - buf.data());
+                builder.onEvent(pos);
+                if (*p == '!')
+                    ++pos.markers;
+                else if (*p != '\n')
+                    ++pos.eid;
+                lineStart = false;
+            }
+
+            auto nl = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (nl == nullptr)
+                break;
+            p = nl + 1;
+            lineStart = true;
+        }
+        base += n;
+    }
+
+    pos.offset = base;
+    return pos;
+}
+
+
+class GzInflaterInputStream : public kj::InputStream {
+  public:
+    explicit GzInflaterInputStream(GzInflater &inflater) : inflater(inflater) {}
+    KJ_DISALLOW_COPY(GzInflaterInputStream);
+
+    virtual auto tryRead(void* buffer, size_t minBytes, size_t maxBytes) -> size_t
+        override final {
+        (void)minBytes; // the inflater always fills the buffer unless at EOF
+        return inflater.read(buffer, maxBytes);
+    }
+
+  private:
+    GzInflater &inflater;
+};
+
+
+template <typename EventStream>
+auto scanCapnp(GzInflater &inflater, IndexBuilder &builder) -> EventPosition {
+    // Packed capnproto messages can only be decoded from a message boundary.
+    // Everything the inflater produced, but is still buffered, starts the next message.
+    using Event = typename EventStream::Event;
+
+    capnp::ReaderOptions options;
+    options.traversalLimitInWords = (1UL << 63);
+
+    GzInflaterInputStream stream(inflater);
+    kj::BufferedInputStreamWrapper buffered(stream);
+    EventPosition pos;
+
+    for (auto avail = buffered.tryGetReadBuffer(); avail.size() != 0;
+         avail = buffered.tryGetReadBuffer()) {
+        pos.offset = inflater.totalOut() - avail.size();
+        builder.onEvent(pos);
+
+        capnp::PackedMessageReader message(buffered, options);
+        for (auto event : message.getRoot<EventStream>().getEvents()) {
+            if (event.which() == Event::MARKER)
+                ++pos.markers;
+            else
+                ++pos.eid;
+        }
+    }
+
+    pos.offset = inflater.totalOut();
+    return pos;
+}
+
+}; //end namespace
+
+
+auto guessTraceFormat(const std::filesystem::path &fpath) -> TraceFormat {
+    auto name = fpath.filename().string();
+    if (endsWith(name, ".compressed.capn.bin.gz"))
+        return TraceFormat::CAPNP_COMPRESSED;
+    else if (endsWith(name, ".uncompressed.capn.bin.gz"))
+        return TraceFormat::CAPNP_UNCOMPRESSED;
+    else
+        return TraceFormat::TEXT;
+}
+
+
+//-----------------------------------------------------------------------------
+auto GzIndex::build(const std::filesystem::path &trace, uint64_t span) -> GzIndex {
+    if (span == 0)
+        PrismLog::fatal("gz index span must be greater than 0");
+
+    GzIndex index;
+    index.format = guessTraceFormat(trace);
+    index.span = span;
+
+    IndexBuilder builder(index);
+    GzInflater inflater(trace);
+    inflater.onBlockBoundary = [&](const GzInflater &inf) { builder.onBlockBoundary(inf); };
+
+    switch (index.format) {
+    case TraceFormat::TEXT:
+        index.total = scanText(inflater, builder);
+        break;
+    case TraceFormat::CAPNP_COMPRESSED:
+        index.total = scanCapnp<EventStreamCompressed>(inflater, builder);
+        break;
+    case TraceFormat::CAPNP_UNCOMPRESSED:
+        index.total = scanCapnp<EventStreamUncompressed>(inflater, builder);
+        break;
+    }
+
+    return index;
+}
+
+
+auto GzIndex::defaultPath(const std::filesystem::path &trace) -> std::filesystem::path {
+    return trace.string() + ".idx";
+}
+
+
+auto GzIndex::save(const std::filesystem::path &idx) const -> void {
+    std::ofstream ofs(idx, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+        PrismLog::fatal("Error opening gz index file: {}", idx.string());
+
+    ofs.write(indexMagic, sizeof(indexMagic));
+    put(ofs, indexVersion);
+    put(ofs, format);
+    put(ofs, span);
+    put(ofs, total);
+    put(ofs, static_cast<uint64_t>(points.size()));
+    for (auto &point : points) {
+        put(ofs, point.out);
+        put(ofs, point.in);
+        put(ofs, point.bits);
+        put(ofs, point.first);
+        put(ofs, static_cast<uint32_t>(point.window.size()));
+        ofs.write(reinterpret_cast<const char*>(point.window.data()), point.window.size());
+    }
+
+    if (!ofs)
+        PrismLog::fatal("Error writing gz index file: {}", idx.string());
+}
+
+
+auto GzIndex::load(const std::filesystem::path &idx) -> GzIndex {
+    std::ifstream ifs(idx, std::ios::binary);
+    if (!ifs)
+        PrismLog::fatal("Error opening gz index file: {}", idx.string());
+
+    char magic[sizeof(indexMagic)];
+    ifs.read(magic, sizeof(magic));
+    if (!ifs || memcmp(magic, indexMagic, sizeof(magic)) != 0)
+        PrismLog::fatal("Not a gz index file: {}", idx.string());
+    if (get<uint32_t>(ifs) != indexVersion)
+        PrismLog::fatal("Unsupported gz index version: {}", idx.string());
+
+    GzIndex index;
+    index.format = get<TraceFormat>(ifs);
+    index.span = get<uint64_t>(ifs);
+    index.total = get<EventPosition>(ifs);
+    index.points.resize(get<uint64_t>(ifs));
+    for (auto &point : index.points) {
+        point.out = get<uint64_t>(ifs);
+        point.in = get<uint64_t>(ifs);
+        point.bits = get<int>(ifs);
+        point.first = get<EventPosition>(ifs);
+        point.window.resize(get<uint32_t>(ifs));
+        if (point.window.size() > windowSize ||
+            !ifs.read(reinterpret_cast<char*>(point.window.data()), point.window.size()))
+            PrismLog::fatal("corrupt gz index file: {}", idx.string());
+    }
+
+    return index;
+}
+
+
+auto GzIndex::findEvent(uint64_t eid) const -> size_t {
+    auto it = std::upper_bound(points.cbegin(), points.cend(), eid,
+                               [](uint64_t val, const GzAccessPoint &point) {
+                                   return val < point.first.eid;
+                               });
+    return it == points.cbegin() ? 0 : (it - points.cbegin()) - 1;
+}
+
+
+auto GzIndex::findMarker(uint64_t markers) const -> size_t {
+    auto it = std::upper_bound(points.cbegin(), points.cend(), markers,
+                               [](uint64_t val, const GzAccessPoint &point) {
+                                   return val < point.first.markers;
+                               });
+    return it == points.cbegin() ? 0 : (it - points.cbegin()) - 1;
+}
+
+
+auto GzIndex::partition(unsigned n) const -> std::vector<std::pair<size_t, uint64_t>> {
+    // balance on uncompressed bytes; ranges can only start at access points
+    std::vector<std::pair<size_t, uint64_t>> ranges;
+    if (points.empty() || n == 0)
+        return ranges;
+
+    size_t begin = 0;
+    for (unsigned i = 1; i <= n && begin < points.size(); ++i) {
+        uint64_t target = (total.offset / n) * i;
+        auto it = std::lower_bound(points.cbegin() + begin + 1, points.cend(), target,
+                                   [](const GzAccessPoint &point, uint64_t val) {
+                                       return point.first.offset < val;
+                                   });
+        size_t end = (i == n) ? points.size() : it - points.cbegin();
+        ranges.emplace_back(begin, end == points.size() ? total.offset : points[end].first.offset);
+        begin = end;
+    }
+
+    return ranges;
+}
+
+
+//-----------------------------------------------------------------------------
+GzInflater::GzInflater(const std::filesystem::path &fpath)
+    : in(fopen(fpath.c_str(), "rb"))
+    , strm(std::make_unique<z_stream>())
+    , inbuf(chunkSize) {
+    if (in == nullptr)
+        PrismLog::fatal("Error opening gz file: {}", fpath.string());
+
+    // gzip header decoding only
+    if (inflateInit2(strm.get(), 15 + 16) != Z_OK)
+        PrismLog::fatal("Error initializing zlib inflate");
+}
+
+
+GzInflater::GzInflater(const std::filesystem::path &fpath, const GzAccessPoint &point)
+    : in(fopen(fpath.c_str(), "rb"))
+    , strm(std::make_unique<z_stream>())
+    , inbuf(chunkSize)
+    , totin(point.in)
+    , totout(point.out)
+    , raw(true) {
+    if (in == nullptr)
+        PrismLog::fatal("Error opening gz file: {}", fpath.string());
+
+    // access points are inside the raw deflate stream
+    if (inflateInit2(strm.get(), -15) != Z_OK)
+        PrismLog::fatal("Error initializing zlib inflate");
+
+    if (fseeko(in, point.in - (point.bits ? 1 : 0), SEEK_SET) == -1)
+        PrismLog::fatal("Error seeking in gz file: {}", fpath.string());
+
+    if (point.bits) {
+        int c = getc(in);
+        if (c == EOF)
+            PrismLog::fatal("Error reading gz file: {}", fpath.string());
+        inflatePrime(strm.get(), point.bits, c >> (8 - point.bits));
+    }
+
+    if (point.window.empty() == false)
+        inflateSetDictionary(strm.get(), point.window.data(), point.window.size());
+}
+
+
+GzInflater::~GzInflater() {
+    inflateEnd(strm.get());
+    if (in != nullptr)
+        fclose(in);
+}
+
+
+auto GzInflater::fill() -> bool {
+    size_t n = fread(inbuf.data(), 1, inbuf.size(), in);
+    if (ferror(in))
+        PrismLog::fatal("Error reading gz file");
+
+    strm->next_in = inbuf.data();
+    strm->avail_in = n;
+    return n > 0;
+}
+
+
+auto GzInflater::nextMember() -> bool {
+    // A raw inflate stops before the gzip trailer
+    if (raw) {
+        for (int trailer = 8; trailer > 0; --trailer) {
+            if (strm->avail_in == 0 && fill() == false)
+                return false;
+            ++strm->next_in;
+            --strm->avail_in;
+            ++totin;
+        }
+    }
+
+    // concatenated gzip members are a valid gzip file
+    if (strm->avail_in == 0 && fill() == false)
+        return false;
+
+    inflateReset2(strm.get(), 15 + 16);
+    raw = false;
+    return true;
+}
+
+
+auto GzInflater::read(void *buffer, size_t bytes) -> size_t {
+    bytes = std::min<size_t>(bytes, UINT_MAX);
+    strm->next_out = static_cast<Bytef*>(buffer);
+    strm->avail_out = bytes;
+
+    while (strm->avail_out > 0 && done == false) {
+        if (strm->avail_in == 0 && fill() == false) {
+            PrismLog::warn("gz file ended unexpectedly");
+            done = true;
+            break;
+        }
+
+        auto availIn = strm->avail_in;
+        auto availOut = strm->avail_out;
+        int ret = inflate(strm.get(), Z_BLOCK);
+        totin += availIn - strm->avail_in;
+        totout += availOut - strm->avail_out;
+
+        if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR)
+            PrismLog::fatal("Error inflating gz file\n"
+                            "Code    : {}\n"
+                            "Message : {}", ret, strm->msg ? strm->msg : "");
+
+        if (ret == Z_STREAM_END) {
+            done = (nextMember() == false);
+        } else if (onBlockBoundary && (strm->data_type & 0xc0) == 0x80) {
+            // end of a gzip header, or end of a block that is not the last
+            onBlockBoundary(*this);
+        }
+    }
+
+    return bytes - strm->avail_out;
+}
+
+
+auto GzInflater::skip(uint64_t bytes) -> uint64_t {
+    std::vector<char> discard(std::min<uint64_t>(bytes, chunkSize));
+    uint64_t skipped = 0;
+    while (skipped < bytes) {
+        size_t n = read(discard.data(), std::min<uint64_t>(bytes - skipped, discard.size()));
+        if (n == 0)
+            break;
+        skipped += n;
+    }
+    return skipped;
+}
+
+
+auto GzInflater::accessPoint() const -> GzAccessPoint {
+    GzAccessPoint point;
+    point.out = totout;
+    point.in = totin;
+    point.bits = strm->data_type & 7;
+
+    uInt have = windowSize;
+    point.window.resize(windowSize);
+    inflateGetDictionary(strm.get(), point.window.data(), &have);
+    point.window.resize(have);
+
+    return point;
+}
+
+
+//-----------------------------------------------------------------------------
+GzIndexedInputStream::GzIndexedInputStream(const std::filesystem::path &fpath,
+                                           const GzIndex &index,
+                                           size_t point, uint64_t end)
+    : inflater(fpath, index.points.at(point))
+    , start(index.points[point].first)
+    , end(end) {
+    auto &ap = index.points[point];
+    if (inflater.skip(ap.first.offset - ap.out) != ap.first.offset - ap.out)
+        PrismLog::fatal("gz index does not match: {}", fpath.string());
+}
+
+GzIndexedInputStream::~GzIndexedInputStream() {}
+
+auto GzIndexedInputStream::tryRead(void* buffer, size_t minBytes, size_t maxBytes) -> size_t {
+    (void)minBytes; // the inflater always fills the buffer unless at EOF/end
+    if (inflater.totalOut() >= end)
+        return 0;
+
+    maxBytes = std::min<uint64_t>(maxBytes, end - inflater.totalOut());
+    return inflater.read(buffer, maxBytes);
+}
+
+
+//-----------------------------------------------------------------------------
+TextGzLineGenerator::TextGzLineGenerator(const std::filesystem::path &fpath,
+                                         const GzIndex &index,
+                                         size_t point, uint64_t end)
+    : stream(fpath, index, point, end)
+    , buf(chunkSize)
+    , pos(stream.startPosition()) {}
+
+
+auto TextGzLineGenerator::next() -> std::optional<std::string_view> {
+    auto nl = static_cast<char*>(memchr(buf.data() + head, '\n', tail - head));
+    while (nl == nullptr) {
+        if (head > 0) {
+            memmove(buf.data(), buf.data() + head, tail - head);
+            tail -= head;
+            head = 0;
+        }
+
+        // a single line filled up the buffer
+        if (tail == buf.size())
+            buf.resize(buf.size() * 2);
+
+        size_t n = stream.tryRead(buf.data() + tail, 1, buf.size() - tail);
+        if (n == 0)
+            break;
+        nl = static_cast<char*>(memchr(buf.data() + tail, '\n', n));
+        tail += n;
+    }
+
+    if (nl == nullptr && head == tail)
+        return std::nullopt;
+
+    // the last line may not have a trailing newline
+    char *lineEnd = (nl == nullptr) ? buf.data() + tail : nl;
+    std::string_view line(buf.data() + head, lineEnd - (buf.data() + head));
+    head = std::min(tail, static_cast<size_t>(lineEnd - buf.data()) + 1);
+
+    pos.offset += line.size() + (nl == nullptr ? 0 : 1);
+    if (line.empty() == false) {
+        if (line.front() == '!')
+            ++pos.markers;
+        else
+            ++pos.eid;
+    }
+
+    return line;
+}
+
+
+auto TextGzLineGenerator::skipToEvent(uint64_t eid) -> bool {
+    while (pos.eid < eid)
+        if (next() == std::nullopt)
+            return false;
+    return true;
+}
+
+
+auto TextGzLineGenerator::skipToMarker(uint64_t markers) -> bool {
+    while (pos.markers < markers)
+        if (next() == std::nullopt)
+            return false;
+    return true;
+}
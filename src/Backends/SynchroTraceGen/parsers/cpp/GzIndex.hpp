@@ -0,0 +1,164 @@
+#ifndef STGEN_GZ_INDEX_H
+#define STGEN_GZ_INDEX_H
+
+#include <kj/io.h>
+#include <zlib.h>
+#include <cstdio>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Random access into existing gzipped SynchroTraceGen traces.
+//
+// Based off of the zran.c example in the zlib distribution.
+// One pass over a trace records the inflate state at deflate block boundaries,
+// roughly every 'span' uncompressed bytes. Inflation can later be resumed at any
+// of these 'access points' with just the 32KiB history window saved alongside it.
+//
+// Each access point is also tagged with the first event that starts at or after it,
+// so readers resume on an event (text line, or capnproto message) boundary
+// and know the event ID and instruction marker count at that boundary.
+
+enum class TraceFormat : uint8_t {
+    TEXT = 0,
+    CAPNP_COMPRESSED,
+    CAPNP_UNCOMPRESSED,
+};
+
+auto guessTraceFormat(const std::filesystem::path &fpath) -> TraceFormat;
+
+
+struct EventPosition {
+    uint64_t offset{0};  // uncompressed offset of the event (or message) start
+    uint64_t eid{0};     // SynchroTraceGen event ID; instruction markers are not events
+    uint64_t markers{0}; // instruction markers seen before 'offset'
+};
+
+
+struct GzAccessPoint {
+    uint64_t out{0}; // uncompressed offset of the deflate block
+    uint64_t in{0};  // compressed offset of the first whole byte of the block
+    int bits{0};     // bits of the byte before 'in' that belong to the block
+    EventPosition first;
+    std::vector<unsigned char> window;
+};
+
+
+class GzIndex {
+  public:
+    static constexpr uint64_t defaultSpan = 1UL << 22;
+
+    static auto build(const std::filesystem::path &trace, uint64_t span = defaultSpan) -> GzIndex;
+    static auto load(const std::filesystem::path &idx) -> GzIndex;
+    static auto defaultPath(const std::filesystem::path &trace) -> std::filesystem::path;
+    auto save(const std::filesystem::path &idx) const -> void;
+
+    // index of the last access point at or before the event/marker
+    auto findEvent(uint64_t eid) const -> size_t;
+    auto findMarker(uint64_t markers) const -> size_t;
+
+    // Split the trace into (at most) 'n' disjoint ranges of whole events.
+    // Each range is the access point to start from,
+    // and the uncompressed offset to stop at.
+    auto partition(unsigned n) const -> std::vector<std::pair<size_t, uint64_t>>;
+
+    TraceFormat format{TraceFormat::TEXT};
+    uint64_t span{defaultSpan};
+    EventPosition total; // position at the end of the trace
+    std::vector<GzAccessPoint> points;
+};
+
+
+//-----------------------------------------------------------------------------
+// Inflation from the start of a gz file, or from an access point
+
+class GzInflater {
+  public:
+    explicit GzInflater(const std::filesystem::path &fpath);
+    GzInflater(const std::filesystem::path &fpath, const GzAccessPoint &point);
+    KJ_DISALLOW_COPY(GzInflater);
+    ~GzInflater();
+
+    // returns 0 once the gz file is exhausted
+    auto read(void *buffer, size_t bytes) -> size_t;
+    auto skip(uint64_t bytes) -> uint64_t;
+
+    auto totalIn() const -> uint64_t { return totin; }
+    auto totalOut() const -> uint64_t { return totout; }
+
+    // only valid when called from 'onBlockBoundary'
+    auto accessPoint() const -> GzAccessPoint;
+
+    std::function<void(const GzInflater&)> onBlockBoundary;
+
+  private:
+    auto fill() -> bool;
+    auto nextMember() -> bool;
+
+    FILE *in;
+    std::unique_ptr<z_stream> strm; // inflate state points back at the z_stream
+    std::vector<unsigned char> inbuf;
+    uint64_t totin{0};
+    uint64_t totout{0};
+    bool raw{false};
+    bool done{false};
+};
+
+
+class GzIndexedInputStream : public kj::InputStream {
+    // Uncompressed stream of whole events from an access point,
+    // up to (but not including) an uncompressed offset
+  public:
+    GzIndexedInputStream(const std::filesystem::path &fpath, const GzIndex &index,
+                         size_t point, uint64_t end = UINT64_MAX);
+    KJ_DISALLOW_COPY(GzIndexedInputStream);
+    ~GzIndexedInputStream();
+
+    virtual auto tryRead(void* buffer, size_t minBytes, size_t maxBytes) -> size_t
+        override final;
+
+    auto startPosition() const -> const EventPosition& { return start; }
+
+  private:
+    GzInflater inflater;
+    EventPosition start;
+    uint64_t end;
+};
+
+
+//-----------------------------------------------------------------------------
+// Convenience containers
+
+class TextGzLineGenerator {
+    // The text trace equivalent of PackedGzMessageGenerator.
+    // Each line is one event, or one instruction marker ("! N")
+  public:
+    TextGzLineGenerator(const std::filesystem::path &fpath, const GzIndex &index,
+                        size_t point = 0, uint64_t end = UINT64_MAX);
+
+    // returns std::nullopt if no lines left;
+    // the line is only valid until the next call
+    auto next() -> std::optional<std::string_view>;
+
+    // Skip lines until the next event returned is 'eid',
+    // or until the next line returned follows the 'markers'th marker.
+    // Returns false if the range ended first.
+    auto skipToEvent(uint64_t eid) -> bool;
+    auto skipToMarker(uint64_t markers) -> bool;
+
+    // position of the next line
+    auto position() const -> const EventPosition& { return pos; }
+
+  private:
+    GzIndexedInputStream stream;
+    std::vector<char> buf;
+    size_t head{0};
+    size_t tail{0};
+    EventPosition pos;
+};
+
+#endif
@@ -116,6 +116,29 @@ auto PackedGzMessageGenerator::next()
 }
 
 
+PackedIndexedGzMessageGenerator::PackedIndexedGzMessageGenerator(const std::filesystem::path &fpath,
+                                                                 const GzIndex &index,
+                                                                 size_t point, uint64_t end,
+                                                                 capnp::ReaderOptions options)
+    : GzIndexedInputStream(fpath, index, point, end)
+    , BufferedInputStreamWrapper(static_cast<GzIndexedInputStream&>(*this))
+    , options(options)
+    , pos(startPosition()) {}
+
+PackedIndexedGzMessageGenerator::~PackedIndexedGzMessageGenerator() {}
+
+auto PackedIndexedGzMessageGenerator::next()
+    -> std::unique_ptr<capnp::PackedMessageReader>
+{
+    if (tryGetReadBuffer().size() != 0) {
+        return std::make_unique<capnp::PackedMessageReader>
+            (static_cast<kj::BufferedInputStreamWrapper&>(*this), options);
+    } else {
+        return nullptr;
+    }
+}
+
+
 PackedFdMessageGenerator::PackedFdMessageGenerator(kj::AutoCloseFd ac,
                                                    capnp::ReaderOptions options)
     : kj::FdInputStream(std::move(ac))
@@ -137,28 +160,35 @@ auto PackedFdMessageGenerator::next()
 
 
 //-----------------------------------------------------------------------------
-PackedMultipleMessageGenerator::PackedMultipleMessageGenerator(std::filesystem::path fpath,
-                                                               capnp::ReaderOptions options)
-    : it({nullptr, nullptr})
+auto openPackedMessageGenerator(const std::filesystem::path &fpath, capnp::ReaderOptions options)
+    -> std::unique_ptr<PackedMessageGenerator>
 {
     auto ext = fpath.extension();
     if (ext.compare(".gz") == 0) {
         PrismLog::info("Parsing .gz file: {}", fpath.string());
         auto ac = AutoCloseGz(gzopen(fpath.c_str(), "rb"));
         if (ac == Z_NULL) PrismLog::fatal("Error opening gz file");
-        auto generator = std::make_unique<PackedGzMessageGenerator>(std::move(ac), options);
-        it = {generator->next(), std::move(generator)};
+        return std::make_unique<PackedGzMessageGenerator>(std::move(ac), options);
     } else if (ext.compare(".bin") == 0) {
         PrismLog::info("Parsing a raw file: {}", fpath.string());
         auto ac = kj::AutoCloseFd(open(fpath.c_str(), O_RDONLY));
         if ((int)ac == -1) PrismLog::fatal("Error opening bin file");
-        auto generator = std::make_unique<PackedFdMessageGenerator>(std::move(ac), options);
-        it = {generator->next(), std::move(generator)};
+        return std::make_unique<PackedFdMessageGenerator>(std::move(ac), options);
     } else {
         PrismLog::fatal("unexpected file extension: {}", ext.string());
     }
 }
 
+
+//-----------------------------------------------------------------------------
+PackedMultipleMessageGenerator::PackedMultipleMessageGenerator(std::filesystem::path fpath,
+                                                               capnp::ReaderOptions options)
+    : it({nullptr, nullptr})
+{
+    auto generator = openPackedMessageGenerator(fpath, options);
+    it = {generator->next(), std::move(generator)};
+}
+
 auto PackedMultipleMessageGenerator::begin() -> iterator {
     if (it == nullptr) {
         throw std::runtime_error("Invalid state for MultipleMessageGenerator! "
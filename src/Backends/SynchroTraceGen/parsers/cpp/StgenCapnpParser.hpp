@@ -1,5 +1,6 @@
 #include "STEventTraceSchemas/STEventTraceCompressed.capnp.h"
 #include "STEventTraceSchemas/STEventTraceUncompressed.capnp.h"
+#include "GzIndex.hpp"
 #include <capnp/message.h>
 #include <capnp/serialize-packed.h>
 #include <zlib.h>
@@ -84,6 +85,57 @@ class PackedGzMessageGenerator
 };
 
 
+class PackedIndexedGzMessageGenerator
+    : GzIndexedInputStream
+    , kj::BufferedInputStreamWrapper
+    , public PackedMessageGenerator {
+    // Starts at an access point of a GzIndex instead of the start of the file,
+    // and optionally stops at the end of a partition (see GzIndex::partition)
+  public:
+    using SeekResult = std::pair<std::unique_ptr<::capnp::PackedMessageReader>, unsigned>;
+
+    PackedIndexedGzMessageGenerator(const std::filesystem::path &fpath, const GzIndex &index,
+                                    size_t point = 0, uint64_t end = UINT64_MAX,
+                                    capnp::ReaderOptions options = capnp::ReaderOptions());
+    ~PackedIndexedGzMessageGenerator();
+    virtual auto next() -> std::unique_ptr<::capnp::PackedMessageReader> override final;
+
+    // Returns the message holding event 'eid', or the first event after the
+    // 'markers'th instruction marker, and the index of that event in the message.
+    // Call these before any other call to next(); the count is kept from the access point.
+    template <typename EventStream>
+    auto seekEvent(uint64_t eid) -> SeekResult {
+        return seekWhere<EventStream>([=](const EventPosition &p) { return p.eid >= eid; });
+    }
+
+    template <typename EventStream>
+    auto seekMarker(uint64_t markers) -> SeekResult {
+        return seekWhere<EventStream>([=](const EventPosition &p) { return p.markers >= markers; });
+    }
+
+  private:
+    template <typename EventStream, typename Pred>
+    auto seekWhere(Pred found) -> SeekResult {
+        using Event = typename EventStream::Event;
+        while (auto message = next()) {
+            auto events = message->template getRoot<EventStream>().getEvents();
+            for (unsigned i = 0; i < events.size(); ++i) {
+                if (found(pos) && events[i].which() != Event::MARKER)
+                    return {std::move(message), i};
+                if (events[i].which() == Event::MARKER)
+                    ++pos.markers;
+                else
+                    ++pos.eid;
+            }
+        }
+        return {nullptr, 0};
+    }
+
+    capnp::ReaderOptions options;
+    EventPosition pos;
+};
+
+
 class PackedFdMessageGenerator
     : kj::FdInputStream
     , kj::BufferedInputStreamWrapper
@@ -99,6 +151,12 @@ class PackedFdMessageGenerator
 };
 
 
+// Opens a packed capnproto trace, either gzipped (.gz) or raw (.bin)
+auto openPackedMessageGenerator(const std::filesystem::path &fpath,
+                                capnp::ReaderOptions options = capnp::ReaderOptions())
+    -> std::unique_ptr<PackedMessageGenerator>;
+
+
 class PackedMultipleMessageGenerator {
   public:
     // XXX Can only iterate over (begin -> end) once!
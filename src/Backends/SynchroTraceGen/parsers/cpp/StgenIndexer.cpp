@@ -0,0 +1,108 @@
+#include "Utils/PrismLog.hpp"
+#include "StgenCapnpParser.hpp"
+#include "GzIndex.hpp"
+#include "argparse/argparse.hpp"
+#include <thread>
+#include <atomic>
+
+// Build a GzIndex for an existing SynchroTraceGen trace,
+// and optionally verify it by decoding every partition in parallel.
+
+template <typename EventStream>
+auto countCapnp(const std::filesystem::path &trace, const GzIndex &index,
+                size_t point, uint64_t end) -> EventPosition {
+    using Event = typename EventStream::Event;
+
+    capnp::ReaderOptions options;
+    options.traversalLimitInWords = (1UL << 63);
+
+    EventPosition counted;
+    PackedIndexedGzMessageGenerator generator(trace, index, point, end, options);
+    while (auto message = generator.next()) {
+        for (auto event : message->getRoot<EventStream>().getEvents()) {
+            if (event.which() == Event::MARKER)
+                ++counted.markers;
+            else
+                ++counted.eid;
+        }
+    }
+    return counted;
+}
+
+
+auto countText(const std::filesystem::path &trace, const GzIndex &index,
+               size_t point, uint64_t end) -> EventPosition {
+    TextGzLineGenerator generator(trace, index, point, end);
+    auto start = generator.position();
+    while (generator.next());
+
+    auto counted = generator.position();
+    counted.eid -= start.eid;
+    counted.markers -= start.markers;
+    return counted;
+}
+
+
+auto verifyIndex(const std::filesystem::path &trace, const GzIndex &index, unsigned threads) {
+    auto ranges = index.partition(threads);
+    std::atomic<uint64_t> events{0};
+    std::atomic<uint64_t> markers{0};
+
+    std::vector<std::thread> workers;
+    for (auto &range : ranges) {
+        workers.emplace_back([&, range] {
+            EventPosition counted;
+            switch (index.format) {
+            case TraceFormat::TEXT:
+                counted = countText(trace, index, range.first, range.second);
+                break;
+            case TraceFormat::CAPNP_COMPRESSED:
+                counted = countCapnp<EventStreamCompressed>(trace, index, range.first, range.second);
+                break;
+            case TraceFormat::CAPNP_UNCOMPRESSED:
+                counted = countCapnp<EventStreamUncompressed>(trace, index, range.first, range.second);
+                break;
+            }
+            events += counted.eid;
+            markers += counted.markers;
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    if (events != index.total.eid || markers != index.total.markers)
+        PrismLog::fatal("Index verification failed: {} events, {} markers decoded; "
+                        "expected {} events, {} markers",
+                        events.load(), markers.load(), index.total.eid, index.total.markers);
+
+    PrismLog::info("Verified {} partitions", ranges.size());
+}
+
+
+int main(int argc, const char* argv[]) {
+    ArgumentParser argparser;
+    argparser.addArgument("-s", "--span", 1);    // MiB of uncompressed trace between access points
+    argparser.addArgument("-o", "--output", 1);  // default: <tracepath>.idx
+    argparser.addArgument("-j", "--verify", 1);  // decode the trace with N threads using the index
+    argparser.addFinalArgument("tracepath");
+    argparser.parse(argc, argv);
+
+    std::filesystem::path trace = argparser.retrieve<std::string>("tracepath");
+
+    uint64_t span = GzIndex::defaultSpan;
+    if (argparser.count("span") > 0)
+        span = std::stoull(argparser.retrieve<std::string>("span")) << 20;
+
+    std::filesystem::path output = GzIndex::defaultPath(trace);
+    if (argparser.count("output") > 0)
+        output = argparser.retrieve<std::string>("output");
+
+    PrismLog::info("Indexing: {}", trace.string());
+    auto index = GzIndex::build(trace, span);
+    index.save(output);
+    PrismLog::info("Wrote {} access points for {} events and {} markers to: {}",
+                   index.points.size(), index.total.eid, index.total.markers, output.string());
+
+    if (argparser.count("verify") > 0)
+        verifyIndex(trace, index, std::stoul(argparser.retrieve<std::string>("verify")));
+}
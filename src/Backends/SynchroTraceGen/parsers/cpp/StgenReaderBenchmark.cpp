@@ -0,0 +1,67 @@
+#include "Utils/PrismLog.hpp"
+#include "StgenTraceReader.hpp"
+#include "argparse/argparse.hpp"
+#include <chrono>
+
+// Throughput of StgenTraceReader over a whole SynchroTraceGen output directory.
+// Every event is touched, so this measures decompression and decoding,
+// not just inflation.
+
+template <typename EventStream>
+auto countEvents(StgenTraceReader &reader, unsigned workers) {
+    using Event = typename EventStream::Event;
+
+    std::atomic<uint64_t> events{0};
+    std::atomic<uint64_t> markers{0};
+    reader.visit([&](const StgenTraceFile&, capnp::PackedMessageReader &message) {
+        uint64_t localEvents = 0, localMarkers = 0;
+        for (auto event : message.getRoot<EventStream>().getEvents()) {
+            if (event.which() == Event::MARKER)
+                ++localMarkers;
+            else
+                ++localEvents;
+        }
+        events += localEvents;
+        markers += localMarkers;
+    }, workers);
+
+    return std::make_pair(events.load(), markers.load());
+}
+
+
+int main(int argc, const char* argv[]) {
+    ArgumentParser argparser;
+    argparser.addArgument("-j", "--workers", 1);    // visitor threads (default: one per file)
+    argparser.addArgument("-r", "--readahead", 1);  // messages buffered per file
+    argparser.addFinalArgument("outputdir");
+    argparser.parse(argc, argv);
+
+    StgenTraceReader::Options options;
+    if (argparser.count("readahead") > 0)
+        options.readAhead = std::stoul(argparser.retrieve<std::string>("readahead"));
+
+    unsigned workers = 0;
+    if (argparser.count("workers") > 0)
+        workers = std::stoul(argparser.retrieve<std::string>("workers"));
+
+    auto start = std::chrono::steady_clock::now();
+    StgenTraceReader reader(argparser.retrieve<std::string>("outputdir"), options);
+
+    std::pair<uint64_t, uint64_t> counted;
+    if (reader.files().front().format == TraceFormat::CAPNP_COMPRESSED)
+        counted = countEvents<EventStreamCompressed>(reader, workers);
+    else
+        counted = countEvents<EventStreamUncompressed>(reader, workers);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    uint64_t bytes = 0;
+    for (auto &file : reader.files())
+        bytes += file.bytes;
+
+    PrismLog::info("{} files, {} messages, {} events, {} markers",
+                   reader.files().size(), reader.messagesRead(), counted.first, counted.second);
+    PrismLog::info("{:.3f} s, {:.1f} MB/s (on disk), {:.3f} Mevents/s",
+                   elapsed.count(), bytes / elapsed.count() / 1e6,
+                   counted.first / elapsed.count() / 1e6);
+}
@@ -0,0 +1,87 @@
+#include "Utils/PrismLog.hpp"
+#include "StgenTextParser.hpp"
+#include "argparse/argparse.hpp"
+#include <zlib.h>
+#include <chrono>
+#include <cstring>
+
+// Throughput of StgenTextParser on one text trace, in GB/s of decompressed text.
+// 'parse' times StgenTextParser::parse alone, over blocks already inflated into memory;
+// 'next' times the whole pipeline, which is usually bound by zlib inflation.
+
+auto inflateAll(const std::string &fpath) -> std::vector<char> {
+    gzFile fz = gzopen(fpath.c_str(), "rb");
+    if (fz == Z_NULL)
+        PrismLog::fatal("Error opening gz file: {}", fpath);
+
+    std::vector<char> text;
+    size_t filled = 0;
+    while (true) {
+        text.resize(filled + (1 << 24));
+        int got = gzread(fz, text.data() + filled, 1 << 24);
+        if (got < 0) {
+            int err;
+            PrismLog::fatal("Error reading gz file: {}", gzerror(fz, &err));
+        }
+        if (got == 0)
+            break;
+        filled += got;
+    }
+    gzclose(fz);
+
+    if (filled > 0 && text[filled - 1] != '\n')
+        text[filled++] = '\n';
+    text.resize(filled);
+    text.resize(filled + 64); // parse() reads up to 64 zeroed bytes past the end
+    return text;
+}
+
+
+int main(int argc, const char* argv[]) {
+    ArgumentParser argparser;
+    argparser.addArgument("-n", "--repeat", 1); // passes over the inflated trace (default: 10)
+    argparser.addFinalArgument("tracepath");
+    argparser.parse(argc, argv);
+
+    auto fpath = argparser.retrieve<std::string>("tracepath");
+    unsigned repeat = 10;
+    if (argparser.count("repeat") > 0)
+        repeat = std::stoul(argparser.retrieve<std::string>("repeat"));
+
+    auto text = inflateAll(fpath);
+    size_t size = text.size() - 64;
+
+    // split at newlines into blocks of about the parser's own block size
+    std::vector<std::pair<size_t, size_t>> blocks;
+    for (size_t p = 0; p < size;) {
+        size_t end = std::min(p + StgenTextParser::defaultBlockSize, size);
+        auto last = static_cast<const char*>(memrchr(text.data() + p, '\n', end - p));
+        end = (last == nullptr) ? size : last - text.data() + 1;
+        blocks.emplace_back(p, end - p);
+        p = end;
+    }
+
+    StgenTextParser parser(fpath);
+    TextEventBatch batch;
+    uint64_t events = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < repeat; ++i) {
+        for (auto &block : blocks) {
+            batch.clear();
+            parser.parse(text.data() + block.first, block.second, batch);
+            events += batch.size();
+        }
+    }
+    std::chrono::duration<double> parsing = std::chrono::steady_clock::now() - start;
+
+    StgenTextParser pipeline(fpath);
+    start = std::chrono::steady_clock::now();
+    while (pipeline.next(batch));
+    std::chrono::duration<double> total = std::chrono::steady_clock::now() - start;
+
+    PrismLog::info("{:.1f} MB of text, {} events per pass", size / 1e6, events / repeat);
+    PrismLog::info("parse: {:.3f} GB/s over {} passes",
+                   parser.bytesParsed() / parsing.count() / 1e9, repeat);
+    PrismLog::info("next:  {:.3f} GB/s (including inflation)",
+                   pipeline.bytesParsed() / total.count() / 1e9);
+}
@@ -0,0 +1,397 @@
+#include "Utils/PrismLog.hpp"
+#include "StgenTextParser.hpp"
+#include <array>
+#include <cstring>
+#include <regex>
+#include <string>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t padding = 64;
+
+// Delimiters are everything that cannot appear inside a number or keyword
+// (',', ' ', '$', '*', '#', '^', '&', '!', '@', ':', '\n').
+// One bit per byte, 64 bytes per word.
+auto classify(const char *data, size_t size, uint64_t *delims, uint64_t *newlines) -> void {
+    for (size_t w = 0; w * 64 < size; ++w) {
+        const char *chunk = data + w * 64;
+        uint64_t token = 0;
+        uint64_t newline = 0;
+#ifdef __SSE2__
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i lower = _mm_set1_epi8(0x20);
+        const __m128i a = _mm_set1_epi8('a');
+        const __m128i z = _mm_set1_epi8(25);
+        const __m128i underscore = _mm_set1_epi8('_');
+        const __m128i nl = _mm_set1_epi8('\n');
+        for (unsigned i = 0; i < 4; ++i) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + 16 * i));
+            // unsigned (x <= n) as max(x, n) == n
+            __m128i d = _mm_sub_epi8(v, zero);
+            __m128i isDigit = _mm_cmpeq_epi8(_mm_max_epu8(d, nine), nine);
+            __m128i l = _mm_sub_epi8(_mm_or_si128(v, lower), a);
+            __m128i isAlpha = _mm_cmpeq_epi8(_mm_max_epu8(l, z), z);
+            __m128i isToken = _mm_or_si128(_mm_or_si128(isDigit, isAlpha),
+                                           _mm_cmpeq_epi8(v, underscore));
+            token |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(isToken)))
+                << (16 * i);
+            newline |= static_cast<uint64_t>(static_cast<uint16_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)))) << (16 * i);
+        }
+#else
+        for (unsigned i = 0; i < 64; ++i) {
+            unsigned char c = chunk[i];
+            bool isToken = ((c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') ||
+                            c == '_');
+            token |= static_cast<uint64_t>(isToken) << i;
+            newline |= static_cast<uint64_t>(c == '\n') << i;
+        }
+#endif
+        delims[w] = ~token;
+        newlines[w] = newline;
+    }
+}
+
+
+constexpr auto hexTable = [] {
+    std::array<uint8_t, 256> table{};
+    for (auto &val : table)
+        val = 0x80;
+    for (int c = '0'; c <= '9'; ++c)
+        table[c] = c - '0';
+    for (int c = 'a'; c <= 'f'; ++c)
+        table[c] = c - 'a' + 10;
+    for (int c = 'A'; c <= 'F'; ++c)
+        table[c] = c - 'A' + 10;
+    return table;
+}();
+
+
+auto parseTid(const std::filesystem::path &fpath) -> int32_t {
+    static const std::regex traceName(R"(sigil\.events\.out-(\d+)\.gz)");
+    std::smatch match;
+    auto fname = fpath.filename().string();
+    return std::regex_match(fname, match, traceName) ? std::stoi(match[1]) : 0;
+}
+
+}; //end namespace
+
+
+//-----------------------------------------------------------------------------
+auto TextEventBatch::clear() -> void {
+    type.clear();
+    eid.clear();
+    tid.clear();
+    iops.clear();
+    flops.clear();
+    reads.clear();
+    writes.clear();
+    addrBegin.assign(1, 0);
+
+    addrType.clear();
+    start.clear();
+    end.clear();
+    producerTid.clear();
+    producerEid.clear();
+}
+
+
+//-----------------------------------------------------------------------------
+StgenTextParser::StgenTextParser(const std::filesystem::path &fpath, size_t blockSize,
+                                 uint64_t firstEid)
+    : fz(gzopen(fpath.c_str(), "rb"))
+    , fileTid(parseTid(fpath))
+    , nextEid(firstEid)
+    , buf(blockSize + padding)
+{
+    if (fz == Z_NULL)
+        PrismLog::fatal("Error opening gz file: {}", fpath.string());
+    if (blockSize == 0)
+        PrismLog::fatal("text parser block size must be greater than 0");
+    gzbuffer(fz, 1 << 20);
+}
+
+StgenTextParser::~StgenTextParser() {
+    if (gzclose(fz) != Z_OK)
+        PrismLog::warn("error closing gz file");
+}
+
+
+auto StgenTextParser::next(TextEventBatch &batch) -> bool {
+    batch.clear();
+
+    while (true) {
+        size_t filled = carried;
+        if (eof == false) {
+            // gzread takes an unsigned length
+            size_t want = std::min<size_t>(buf.size() - padding - carried, UINT32_MAX >> 1);
+            int got = gzread(fz, buf.data() + carried, want);
+            if (got < 0) {
+                int err;
+                PrismLog::fatal("Error reading gz file: {}", gzerror(fz, &err));
+            }
+            eof = (got == 0);
+            filled += got;
+        }
+
+        size_t used;
+        if (eof == true) {
+            if (filled == 0)
+                return false;
+            if (buf[filled - 1] != '\n') {
+                if (filled + padding == buf.size())
+                    buf.resize(buf.size() + padding);
+                buf[filled++] = '\n';
+            }
+            used = filled;
+        } else {
+            auto last = static_cast<const char*>(memrchr(buf.data(), '\n', filled));
+            if (last == nullptr) {
+                // a single line longer than the block
+                carried = filled;
+                if (carried + padding == buf.size())
+                    buf.resize(2 * buf.size());
+                continue;
+            }
+            used = last - buf.data() + 1;
+        }
+
+        parse(buf.data(), used, batch);
+        std::memmove(buf.data(), buf.data() + used, filled - used);
+        carried = filled - used;
+        return true;
+    }
+}
+
+
+auto StgenTextParser::parse(const char *data, size_t size, TextEventBatch &batch) -> void {
+    if (batch.addrBegin.empty())
+        batch.addrBegin.push_back(0);
+
+    size_t words = (size + 63) / 64;
+    if (delims.size() < words) {
+        delims.resize(words);
+        newlines.resize(words);
+    }
+    classify(data, size, delims.data(), newlines.data());
+
+    for (size_t p = 0; p < size;) {
+        size_t eol = nextNewline(p);
+        parseLine(data, p, eol, batch);
+        p = eol + 1;
+    }
+    parsed += size;
+}
+
+
+auto StgenTextParser::nextDelim(size_t p) const -> size_t {
+    size_t w = p / 64;
+    uint64_t bits = delims[w] & (~0UL << (p % 64));
+    while (bits == 0)
+        bits = delims[++w];
+    return w * 64 + __builtin_ctzll(bits);
+}
+
+auto StgenTextParser::nextNewline(size_t p) const -> size_t {
+    size_t w = p / 64;
+    uint64_t bits = newlines[w] & (~0UL << (p % 64));
+    while (bits == 0)
+        bits = newlines[++w];
+    return w * 64 + __builtin_ctzll(bits);
+}
+
+
+auto StgenTextParser::parseLine(const char *data, size_t p, size_t eol,
+                                TextEventBatch &batch) -> void {
+    if (p == eol)
+        return;
+
+    const size_t lineStart = p;
+    unsigned bad = 0; // 0x80 if any digit was invalid
+
+    auto malformed = [&]() {
+        PrismLog::fatal("Malformed trace line: {}",
+                        std::string(data + lineStart, eol - lineStart));
+    };
+
+    // Each reader leaves 'p' on the delimiter that ends the token.
+    // Empty fields, and fields too long to fit 64 bits, are malformed;
+    // decimal fields are capped at 19 digits, which always fit.
+    auto dec = [&]() {
+        size_t end = nextDelim(p);
+        bad |= (end == p || end - p > 19) << 7;
+        uint64_t val = 0;
+        for (; p < end; ++p) {
+            unsigned digit = static_cast<unsigned char>(data[p]) - '0';
+            bad |= (digit > 9) << 7;
+            val = val * 10 + digit;
+        }
+        return val;
+    };
+
+    auto hex = [&]() {
+        size_t end = nextDelim(p);
+        if (end - p > 2 && data[p] == '0' && data[p + 1] == 'x')
+            p += 2;
+        bad |= (end == p || end - p > 16) << 7;
+        uint64_t val = 0;
+        for (; p < end; ++p) {
+            uint8_t nibble = hexTable[static_cast<unsigned char>(data[p])];
+            bad |= nibble & 0x80;
+            val = (val << 4) | (nibble & 0xF);
+        }
+        return val;
+    };
+
+    auto expect = [&](char c) {
+        if (data[p] != c)
+            malformed();
+        ++p;
+    };
+
+    auto pushEvent = [&](TextEventType type, uint64_t eid, int32_t tid) {
+        batch.type.push_back(type);
+        batch.eid.push_back(eid);
+        batch.tid.push_back(tid);
+    };
+
+    auto pushAddr = [&](TextAddrType type, uint64_t start, uint64_t end,
+                        int32_t producerTid = 0, uint64_t producerEid = 0) {
+        batch.addrType.push_back(type);
+        batch.start.push_back(start);
+        batch.end.push_back(end);
+        batch.producerTid.push_back(producerTid);
+        batch.producerEid.push_back(producerEid);
+    };
+
+    auto pushCounts = [&](uint64_t iops, uint64_t flops, uint64_t reads, uint64_t writes) {
+        batch.iops.push_back(iops);
+        batch.flops.push_back(flops);
+        batch.reads.push_back(reads);
+        batch.writes.push_back(writes);
+    };
+
+    auto comp = [&]() {
+        uint64_t iops = dec();
+        expect(',');
+        uint64_t flops = dec();
+        expect(',');
+        uint64_t reads = dec();
+        expect(',');
+        uint64_t writes = dec();
+        pushCounts(iops, flops, reads, writes);
+    };
+
+    // " $ 0xS 0xE", " * 0xS 0xE", " # ptid peid 0xS 0xE", with or without trailing spaces
+    auto addrs = [&]() {
+        while (p < eol) {
+            char kind = data[p];
+            if (kind == ' ') {
+                ++p;
+                continue;
+            }
+            if (data[p + 1] != ' ')
+                malformed();
+            p += 2;
+
+            uint64_t producerTid = 0, producerEid = 0;
+            TextAddrType type = TextAddrType::WRITE;
+            switch (kind) {
+            case '$':
+                type = TextAddrType::WRITE;
+                break;
+            case '*':
+                type = TextAddrType::READ;
+                break;
+            case '#':
+                type = TextAddrType::COMM;
+                producerTid = dec();
+                expect(' ');
+                producerEid = dec();
+                expect(' ');
+                break;
+            default:
+                malformed();
+            }
+            uint64_t start = hex();
+            expect(' ');
+            uint64_t end = hex();
+            pushAddr(type, start, end, producerTid, producerEid);
+        }
+    };
+
+    // "type^0xA&0xB..."
+    auto sync = [&]() {
+        uint64_t syncType = dec();
+        pushCounts(syncType, 0, 0, 0);
+        expect('^');
+        uint64_t arg = hex();
+        pushAddr(TextAddrType::SYNC_ARG, arg, arg);
+        while (data[p] == '&') {
+            ++p;
+            arg = hex();
+            pushAddr(TextAddrType::SYNC_ARG, arg, arg);
+        }
+    };
+
+    switch (data[p]) {
+    case '!':
+        p += 1;
+        expect(' ');
+        pushEvent(TextEventType::MARKER, nextEid, fileTid);
+        pushCounts(dec(), 0, 0, 0);
+        break;
+    case '@':
+        p += 1;
+        expect(' ');
+        pushEvent(TextEventType::COMP, nextEid++, fileTid);
+        comp();
+        addrs();
+        break;
+    case '#':
+        pushEvent(TextEventType::COMM, nextEid++, fileTid);
+        pushCounts(0, 0, 0, 0);
+        addrs();
+        break;
+    case '^':
+        p += 1;
+        expect(' ');
+        pushEvent(TextEventType::SYNC, nextEid++, fileTid);
+        sync();
+        break;
+    default:
+        {
+            uint64_t eid = dec();
+            expect(',');
+            int32_t tid = dec();
+            nextEid = eid + 1;
+
+            if (data[p] == ',' && data[p + 1] == 'p') {
+                // "pth_ty:"
+                p = nextDelim(p + 1);
+                expect(':');
+                pushEvent(TextEventType::SYNC, eid, tid);
+                sync();
+            } else if (data[p] == ',') {
+                ++p;
+                pushEvent(TextEventType::COMP, eid, tid);
+                comp();
+                addrs();
+            } else {
+                pushEvent(TextEventType::COMM, eid, tid);
+                pushCounts(0, 0, 0, 0);
+                addrs();
+            }
+        }
+        break;
+    }
+
+    if (p != eol || bad != 0)
+        malformed();
+
+    batch.addrBegin.push_back(batch.start.size());
+}
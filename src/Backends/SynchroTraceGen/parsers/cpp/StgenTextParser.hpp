@@ -0,0 +1,107 @@
+#ifndef STGEN_TEXT_PARSER_H
+#define STGEN_TEXT_PARSER_H
+
+#include <zlib.h>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// Parser for the SynchroTraceGen text traces ('-l text' and '-l textv2').
+//
+// Both grammars are accepted line by line, so one parser handles either version:
+//   v1 comp:   eid,tid,iops,flops,reads,writes[ $ 0xS 0xE]...[ * 0xS 0xE]...
+//   v1 comm:   eid,tid[ # ptid peid 0xS 0xE]...
+//   v1 sync:   eid,tid,pth_ty:type^0xA[&0xA]...
+//   v2 comp:   @ iops,flops,reads,writes [$ 0xS 0xE ]...[* 0xS 0xE ]...
+//   v2 comm:   [# ptid peid 0xS 0xE ]...
+//   v2 sync:   ^ type^0xA[&0xA]...
+//   marker:    ! count
+// v2 lines carry no event or thread ID; events are numbered in order from 0,
+// and the thread ID is taken from the file name.
+//
+// The trace is inflated in large blocks. Each block is classified a vector at a time
+// into a bitmask of delimiters (anything but [0-9A-Za-z_]) and of newlines,
+// so finding the end of a number or line is a bit scan instead of a byte loop.
+// Numbers are parsed in place into a struct-of-arrays batch,
+// whose columns are reused between blocks.
+
+enum class TextEventType : uint8_t {
+    COMP = 0,
+    COMM,
+    SYNC,
+    MARKER,
+};
+
+
+enum class TextAddrType : uint8_t {
+    WRITE = 0, // '$'
+    READ,      // '*'
+    COMM,      // '#'
+    SYNC_ARG,  // '^' and '&'
+};
+
+
+struct TextEventBatch {
+    // per event (instruction markers included)
+    std::vector<TextEventType> type;
+    std::vector<uint64_t> eid;   // markers share the ID of the next event
+    std::vector<int32_t> tid;
+    std::vector<uint64_t> iops;  // COMP; sync type for SYNC, count for MARKER
+    std::vector<uint64_t> flops;
+    std::vector<uint64_t> reads;
+    std::vector<uint64_t> writes;
+    std::vector<uint32_t> addrBegin; // addresses of event i are [addrBegin[i], addrBegin[i+1])
+
+    // per address range, or sync argument
+    std::vector<TextAddrType> addrType;
+    std::vector<uint64_t> start;
+    std::vector<uint64_t> end;
+    std::vector<int32_t> producerTid; // COMM only
+    std::vector<uint64_t> producerEid;
+
+    auto size() const -> size_t { return type.size(); }
+    auto clear() -> void;
+};
+
+
+class StgenTextParser {
+  public:
+    static constexpr size_t defaultBlockSize = 1UL << 22;
+
+    // 'firstEid' is the ID of the first textv2 event, which does not store its own,
+    // e.g. the first event ID of a 'region-N' segment.
+    explicit StgenTextParser(const std::filesystem::path &fpath,
+                             size_t blockSize = defaultBlockSize,
+                             uint64_t firstEid = 0);
+    StgenTextParser(const StgenTextParser&) = delete;
+    StgenTextParser& operator=(const StgenTextParser&) = delete;
+    ~StgenTextParser();
+
+    // Replaces the contents of 'batch' with the whole lines of the next block.
+    // Returns false once the trace is exhausted.
+    auto next(TextEventBatch &batch) -> bool;
+
+    // Parses an in-memory buffer of whole lines, each ending in '\n'.
+    // 'data' must be readable for 64 bytes past 'size'.
+    auto parse(const char *data, size_t size, TextEventBatch &batch) -> void;
+
+    auto bytesParsed() const -> uint64_t { return parsed; }
+
+  private:
+    auto parseLine(const char *data, size_t p, size_t eol, TextEventBatch &batch) -> void;
+    auto nextDelim(size_t p) const -> size_t;
+    auto nextNewline(size_t p) const -> size_t;
+
+    gzFile fz;
+    int32_t fileTid{0};
+    uint64_t nextEid{0};
+    uint64_t parsed{0};
+
+    std::vector<char> buf; // block, plus the carried partial line and padding
+    size_t carried{0};
+    bool eof{false};
+    std::vector<uint64_t> delims;
+    std::vector<uint64_t> newlines;
+};
+
+#endif
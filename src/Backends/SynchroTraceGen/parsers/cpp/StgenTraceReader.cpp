@@ -0,0 +1,114 @@
+#include "Utils/PrismLog.hpp"
+#include "StgenTraceReader.hpp"
+#include <algorithm>
+#include <regex>
+
+namespace {
+
+auto findTraceFiles(const std::filesystem::path &dir) -> std::vector<StgenTraceFile> {
+    if (!std::filesystem::is_directory(dir))
+        PrismLog::fatal("Not a SynchroTraceGen output directory: {}", dir.string());
+
+    static const std::regex traceName(
+        R"(sigil\.events\.out-(\d+)\.(compressed|uncompressed)\.capn\.bin(\.gz)?)");
+
+    std::vector<StgenTraceFile> found;
+    for (auto &entry : std::filesystem::directory_iterator(dir)) {
+        std::smatch match;
+        auto fname = entry.path().filename().string();
+        if (!entry.is_regular_file() || !std::regex_match(fname, match, traceName))
+            continue;
+
+        auto format = (match[2] == "compressed" ? TraceFormat::CAPNP_COMPRESSED
+                                                 : TraceFormat::CAPNP_UNCOMPRESSED);
+        found.push_back({std::stoi(match[1]), entry.path(), format, entry.file_size()});
+    }
+
+    if (found.empty())
+        PrismLog::fatal("No capnproto traces found in: {}", dir.string());
+
+    std::sort(found.begin(), found.end(), [](auto &a, auto &b) { return a.tid < b.tid; });
+    for (auto &file : found)
+        if (file.format != found.front().format)
+            PrismLog::fatal("Mixed compressed and uncompressed traces in: {}", dir.string());
+
+    return found;
+}
+
+}; //end namespace
+
+
+//-----------------------------------------------------------------------------
+StgenTraceReader::StgenTraceReader(const std::filesystem::path &dir)
+    : StgenTraceReader(dir, Options{}) {}
+
+StgenTraceReader::StgenTraceReader(const std::filesystem::path &dir, Options options)
+    : options(options), traceFiles(findTraceFiles(dir))
+{
+    for (size_t i = 0; i < traceFiles.size(); ++i) {
+        generators.push_back(openPackedMessageGenerator(traceFiles[i].path, options.reader));
+        queues.push_back(std::make_unique<BoundedQueue<Message>>(options.readAhead));
+    }
+
+    // start decoding only after every queue exists
+    for (size_t i = 0; i < traceFiles.size(); ++i)
+        decoders.emplace_back(&StgenTraceReader::decode, this, i);
+}
+
+StgenTraceReader::~StgenTraceReader() {
+    for (auto &queue : queues)
+        queue->close();
+    for (auto &decoder : decoders)
+        decoder.join();
+}
+
+
+auto StgenTraceReader::decode(size_t file) -> void {
+    auto &queue = *queues[file];
+    try {
+        while (auto message = generators[file]->next()) {
+            // Multi-segment messages are read lazily from the stream.
+            // Read the whole message now, so the consumer never touches the stream.
+            for (unsigned seg = 1; message->getSegment(seg) != nullptr; ++seg);
+            if (!queue.push(std::move(message)))
+                return;
+        }
+    } catch (kj::Exception &e) {
+        PrismLog::fatal("Error decoding {}: {}",
+                        traceFiles[file].path.string(), e.getDescription().cStr());
+    }
+    queue.close();
+}
+
+
+auto StgenTraceReader::next(size_t file) -> Message {
+    if (file >= queues.size())
+        PrismLog::fatal("Trace file index out of range: {}", file);
+
+    if (auto message = queues[file]->pop()) {
+        ++messages;
+        return std::move(*message);
+    }
+    return nullptr;
+}
+
+
+auto StgenTraceReader::visit(const Visitor &visitor, unsigned workers) -> void {
+    if (workers == 0 || workers > traceFiles.size())
+        workers = traceFiles.size();
+
+    // Workers claim whole files, so each file is visited in order by one thread
+    std::atomic<size_t> unclaimed{0};
+    auto work = [&] {
+        for (size_t file = unclaimed++; file < traceFiles.size(); file = unclaimed++)
+            while (auto message = next(file))
+                visitor(traceFiles[file], *message);
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < workers; ++i)
+        pool.emplace_back(work);
+    work();
+    for (auto &thread : pool)
+        thread.join();
+}
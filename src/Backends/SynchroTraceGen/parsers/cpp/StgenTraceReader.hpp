@@ -0,0 +1,126 @@
+#ifndef STGEN_TRACE_READER_H
+#define STGEN_TRACE_READER_H
+
+#include "StgenCapnpParser.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Reads every per-thread capnproto trace in a SynchroTraceGen output directory.
+//
+// Each file is decompressed and decoded on its own thread,
+// reading ahead into a bounded queue of messages, so memory use is capped at
+// roughly (files * readAhead) messages regardless of the trace size.
+// Messages can be pulled per file, or handed to visitors that run in parallel
+// across files (and in order within a file).
+
+template <typename T>
+class BoundedQueue {
+    // Blocking single-producer/single-consumer queue;
+    // close() wakes both sides and makes further pushes fail
+  public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+    auto push(T item) -> bool {
+        std::unique_lock<std::mutex> lock(mtx);
+        notFull.wait(lock, [&]{ return closed || items.size() < capacity; });
+        if (closed)
+            return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // returns std::nullopt once the queue is closed and drained
+    auto pop() -> std::optional<T> {
+        std::unique_lock<std::mutex> lock(mtx);
+        notEmpty.wait(lock, [&]{ return closed || !items.empty(); });
+        if (items.empty())
+            return std::nullopt;
+        auto item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return item;
+    }
+
+    auto close() -> void {
+        std::lock_guard<std::mutex> lock(mtx);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+  private:
+    std::mutex mtx;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<T> items;
+    size_t capacity;
+    bool closed{false};
+};
+
+
+struct StgenTraceFile {
+    int tid;
+    std::filesystem::path path;
+    TraceFormat format; // CAPNP_COMPRESSED or CAPNP_UNCOMPRESSED
+    uint64_t bytes;     // size on disk
+};
+
+
+class StgenTraceReader {
+  public:
+    using Message = std::unique_ptr<capnp::PackedMessageReader>;
+    using Visitor = std::function<void(const StgenTraceFile&, capnp::PackedMessageReader&)>;
+
+    struct Options {
+        size_t readAhead{4}; // messages buffered per file
+        capnp::ReaderOptions reader{(1UL << 63), 64};
+    };
+
+    // Opens every 'sigil.events.out-<tid>.{compressed,uncompressed}.capn.bin[.gz]' in 'dir',
+    // ordered by thread ID, and starts decoding them.
+    explicit StgenTraceReader(const std::filesystem::path &dir);
+    StgenTraceReader(const std::filesystem::path &dir, Options options);
+    KJ_DISALLOW_COPY(StgenTraceReader);
+    ~StgenTraceReader();
+
+    auto files() const -> const std::vector<StgenTraceFile>& { return traceFiles; }
+
+    // Pull API: next message of the i'th file, or nullptr once the file is exhausted.
+    // Different files may be pulled from different threads.
+    // Messages must not outlive the reader.
+    auto next(size_t file) -> Message;
+
+    // Callback API: drain every file, calling 'visitor' for each message.
+    // Files are spread over 'workers' threads (default: one per file),
+    // so the visitor must be safe to call concurrently for different files.
+    auto visit(const Visitor &visitor, unsigned workers = 0) -> void;
+
+    template <typename EventStream, typename EventVisitor>
+    auto visitEvents(EventVisitor &&visitor, unsigned workers = 0) -> void {
+        visit([&](const StgenTraceFile &file, capnp::PackedMessageReader &message) {
+            for (auto event : message.getRoot<EventStream>().getEvents())
+                visitor(file, event);
+        }, workers);
+    }
+
+    auto messagesRead() const -> uint64_t { return messages; }
+
+  private:
+    auto decode(size_t file) -> void;
+
+    Options options;
+    std::vector<StgenTraceFile> traceFiles;
+    std::vector<std::unique_ptr<PackedMessageGenerator>> generators; // outlive queued messages
+    std::vector<std::unique_ptr<BoundedQueue<Message>>> queues;
+    std::vector<std::thread> decoders;
+    std::atomic<uint64_t> messages{0};
+};
+
+#endif
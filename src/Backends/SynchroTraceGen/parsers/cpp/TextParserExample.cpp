@@ -0,0 +1,57 @@
+#include "Utils/PrismLog.hpp"
+#include "StgenTextParser.hpp"
+#include "argparse/argparse.hpp"
+#include <chrono>
+
+
+auto parseStgenText(std::string fpath) {
+    StgenTextParser parser(fpath);
+    TextEventBatch batch;
+
+    uint64_t events = 0, markers = 0, addrs = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (parser.next(batch)) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            switch (batch.type[i]) {
+            case TextEventType::COMP:
+                {
+                    auto iops [[maybe_unused]]   = batch.iops[i];
+                    auto flops [[maybe_unused]]  = batch.flops[i];
+                    auto reads [[maybe_unused]]  = batch.reads[i];
+                    auto writes [[maybe_unused]] = batch.writes[i];
+                }
+                break;
+            case TextEventType::COMM:
+                for (auto j = batch.addrBegin[i]; j < batch.addrBegin[i + 1]; ++j) {
+                    auto producerThread [[maybe_unused]] = batch.producerTid[j];
+                    auto producerEvent [[maybe_unused]]  = batch.producerEid[j];
+                }
+                break;
+            case TextEventType::SYNC:
+                {
+                    auto syncType [[maybe_unused]] = batch.iops[i];
+                }
+                break;
+            case TextEventType::MARKER:
+                ++markers;
+                continue;
+            }
+            ++events;
+        }
+        addrs += batch.start.size();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    PrismLog::info("{} events, {} markers, {} address ranges", events, markers, addrs);
+    PrismLog::info("{:.3f} s, {:.1f} MB/s (decompressed)",
+                   elapsed.count(), parser.bytesParsed() / elapsed.count() / 1e6);
+}
+
+
+int main(int argc, const char* argv[]) {
+    ArgumentParser argparser;
+    argparser.addFinalArgument("tracepath");
+    argparser.parse(argc, argv);
+
+    parseStgenText(argparser.retrieve<std::string>("tracepath"));
+}
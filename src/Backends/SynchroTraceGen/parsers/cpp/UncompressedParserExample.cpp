@@ -39,7 +39,8 @@ auto parseStgenCapnp(std::string fpath) {
                     auto comm = event.getComm();
 
                     auto producerThread [[maybe_unused]] = comm.getProducerThread();
-                    auto producerEvent [[maybe_unused]]  = comm.getProducerEvent();
+                    auto producerEvent [[maybe_unused]]  = (uint64_t{comm.getProducerEventHigh()} << 32) |
+                                                           comm.getProducerEvent();
                     auto startAddr [[maybe_unused]]      = comm.getStartAddr();
                     auto endAddr [[maybe_unused]]        = comm.getEndAddr();
                 }
@@ -17,6 +17,8 @@ def process_comp(comp):
     comp.flops   # FLOPs value
     comp.writes  # writes value
     comp.reads   # reads value
+    comp.repeat  # number of events this record stands for (0 means 1)
+    comp.stride  # address shift between repeated events
 
     for write in comp.writeAddrs:
         write.start  # start of address range
@@ -32,7 +34,7 @@ def process_comm(comm):
         # the thread-event tuple that generated
         #   this communication edge
         edge.producerThread
-        edge.producerEvent
+        edge.producerEventHigh << 32 | edge.producerEvent
 
         for addr in edge.addrs:
             addr.start  # start of address range
@@ -29,7 +29,7 @@ def process_comm(comm):
     # the thread-event tuple that generated
     #   this communication edge
     comm.producerThread
-    comm.producerEvent
+    comm.producerEventHigh << 32 | comm.producerEvent
     comm.startAddr
     comm.endAddr
 
@@ -49,6 +49,9 @@ fn parse(tracepath: String) -> capnp::Result<()> {
                     let _flops = ev.get_iops();
                     let _writes = ev.get_writes();
                     let _reads = ev.get_reads();
+                    // 'repeat' events (0 means 1), each shifted by 'stride' bytes from the last
+                    let _repeat = std::cmp::max(ev.get_repeat(), 1);
+                    let _stride = ev.get_stride();
 
                     for addr in ev.get_write_addrs()? {
                         let _start_addr = addr.get_start();
@@ -62,7 +65,8 @@ fn parse(tracepath: String) -> capnp::Result<()> {
                 }
                 Ok(Comm(ev)) => {
                     for edge in ev.get_edges()? {
-                        let _producer_event = edge.get_producer_event();
+                        let _producer_event = (u64::from(edge.get_producer_event_high()) << 32)
+                            | u64::from(edge.get_producer_event());
                         let _producer_thread = edge.get_producer_thread();
 
                         for addr in edge.get_addrs()? {
@@ -61,7 +61,8 @@ fn parse(tracepath: String) -> capnp::Result<()> {
                     }
                 }
                 Ok(Comm(ev)) => {
-                    let _producer_event = ev.get_producer_event();
+                    let _producer_event = (u64::from(ev.get_producer_event_high()) << 32)
+                        | u64::from(ev.get_producer_event());
                     let _producer_thread = ev.get_producer_thread();
                     let _start_addr = ev.get_start_addr();
                     let _end_addr = ev.get_start_addr();
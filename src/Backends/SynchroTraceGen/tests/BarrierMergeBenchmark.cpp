@@ -0,0 +1,92 @@
+#include "SynchroTraceGen/BarrierMerge.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace STGen;
+
+/* Times merging per-thread barrier stats, as done at the end of STGen,
+ * over a growing number of threads and barrier regions.
+ *
+ * usage: barrier_merge_benchmark [max threads] [max regions per thread] */
+
+namespace
+{
+
+auto makeThreads(unsigned threads, unsigned regions) -> std::vector<AllBarriersStats>
+{
+    /* A handful of barriers, visited in the same order by every thread,
+     * with each thread missing a few of the visits */
+    std::mt19937 gen(threads ^ regions);
+    std::uniform_int_distribution<Addr> barrier(0, 15);
+    std::bernoulli_distribution skip(0.1);
+
+    std::vector<Addr> sequence(regions);
+    for (auto &addr : sequence)
+        addr = 0x1000 + barrier(gen) * 64;
+
+    std::vector<AllBarriersStats> lists(threads);
+    for (auto &list : lists)
+    {
+        BarrierStats stats;
+        stats.iops = 1;
+        for (auto addr : sequence)
+            if (skip(gen) == false)
+                list.push_back(std::make_pair(addr, stats));
+    }
+    return lists;
+}
+
+template <typename Merge>
+auto time(Merge merge) -> double
+{
+    auto start = std::chrono::steady_clock::now();
+    merge();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+}; //end namespace
+
+
+int main(int argc, char *argv[])
+{
+    unsigned maxThreads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    unsigned maxRegions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    unsigned workers = std::thread::hardware_concurrency();
+
+    std::printf("%8s %10s %14s %14s %14s\n",
+                "threads", "regions", "pairwise(ms)", "1 worker(ms)", "n workers(ms)");
+    for (unsigned threads = 2; threads <= maxThreads; threads *= 2)
+    {
+        for (unsigned regions = 1000; regions <= maxRegions; regions *= 10)
+        {
+            auto lists = makeThreads(threads, regions);
+            BarrierMerge::ThreadBarriers ptrs;
+            for (auto &list : lists)
+                ptrs.push_back(&list);
+
+            AllBarriersStats pairwise;
+            double pairwiseMs = time([&] {
+                for (auto &list : lists)
+                    BarrierMerge::merge(list, pairwise);
+            });
+
+            size_t size = 0;
+            double serialMs = time([&] { size = BarrierMerge::merge(ptrs, 1).size(); });
+            double parallelMs = time([&] { BarrierMerge::merge(ptrs, workers); });
+
+            if (size != pairwise.size())
+            {
+                std::fprintf(stderr, "merged sizes differ: %zu vs %zu\n", size, pairwise.size());
+                return EXIT_FAILURE;
+            }
+
+            std::printf("%8u %10u %14.2f %14.2f %14.2f\n",
+                        threads, regions, pairwiseMs, serialMs, parallelMs);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
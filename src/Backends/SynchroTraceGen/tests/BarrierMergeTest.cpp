@@ -303,3 +303,143 @@ TEST_CASE("more complex cases", "[ComplexBarriers]")
         REQUIRE(it == merged.end());
     }
 }
+
+TEST_CASE("merge of all threads at once", "[ThreadBarriers]")
+{
+    constexpr Addr B1 = 1;
+    constexpr Addr B2 = 2;
+    constexpr Addr B3 = 3;
+
+    SECTION("same result as merging pairwise, for any worker count")
+    {
+        AllBarriersStats T1;
+        AllBarriersStats T2;
+        AllBarriersStats T3;
+        BarrierStats stats;
+
+        stats.iops = 1;
+        T1.push_back(std::make_pair(B1, stats));
+        T1.push_back(std::make_pair(B2, stats));
+        T1.push_back(std::make_pair(B1, stats));
+        T1.push_back(std::make_pair(B3, stats));
+
+        stats.iops = 10;
+        T2.push_back(std::make_pair(B2, stats));
+        T2.push_back(std::make_pair(B1, stats));
+
+        stats.iops = 100;
+        T3.push_back(std::make_pair(B1, stats));
+        T3.push_back(std::make_pair(B2, stats));
+        T3.push_back(std::make_pair(B3, stats));
+
+        AllBarriersStats pairwise;
+        BarrierMerge::merge(T1, pairwise);
+        BarrierMerge::merge(T2, pairwise);
+        BarrierMerge::merge(T3, pairwise);
+
+        for (unsigned workers : {0, 1, 2, 3, 8})
+        {
+            auto merged = BarrierMerge::merge({&T1, &T2, &T3}, workers);
+            REQUIRE(merged.size() == 4);
+            REQUIRE(merged.size() == pairwise.size());
+
+            auto it = merged.begin();
+            auto expected = pairwise.begin();
+            for (; it != merged.end(); ++it, ++expected)
+            {
+                REQUIRE(it->first == expected->first);
+                REQUIRE(equal(it->second, expected->second));
+            }
+
+            /* T2 only waits on B1 once, so it joins the first B1 region */
+            it = merged.begin();
+            REQUIRE(it->first == B1);
+            REQUIRE(it->second.iops == 111);
+            ++it;
+            REQUIRE(it->first == B2);
+            REQUIRE(it->second.iops == 111);
+            ++it;
+            REQUIRE(it->first == B1);
+            REQUIRE(it->second.iops == 1);
+            ++it;
+            REQUIRE(it->first == B3);
+            REQUIRE(it->second.iops == 101);
+        }
+    }
+
+    SECTION("threads that disagree on the barrier order")
+    {
+        AllBarriersStats T1;
+        AllBarriersStats T2;
+        BarrierStats stats;
+
+        stats.iops = 1;
+        T1.push_back(std::make_pair(B1, stats));
+        T1.push_back(std::make_pair(B2, stats));
+        T1.push_back(std::make_pair(B3, stats));
+
+        stats.iops = 10;
+        T2.push_back(std::make_pair(B2, stats));
+        T2.push_back(std::make_pair(B1, stats));
+        T2.push_back(std::make_pair(B3, stats));
+
+        auto merged = BarrierMerge::merge({&T1, &T2}, 2);
+        REQUIRE(merged.size() == 3);
+
+        auto it = merged.begin();
+        REQUIRE(it->first == B1);
+        REQUIRE(it->second.iops == 11);
+        ++it;
+        REQUIRE(it->first == B2);
+        REQUIRE(it->second.iops == 11);
+        ++it;
+        REQUIRE(it->first == B3);
+        REQUIRE(it->second.iops == 11);
+    }
+
+    SECTION("many threads over many barriers")
+    {
+        /* every thread waits on a subset of the same barrier sequence;
+         * merging must recover the whole sequence and sum every region */
+        constexpr unsigned threads = 32;
+        constexpr unsigned regions = 2000;
+
+        std::vector<Addr> sequence;
+        for (unsigned i = 0; i < regions; ++i)
+            sequence.push_back((i * 7919) % 13);
+
+        std::vector<AllBarriersStats> T(threads);
+        BarrierMerge::ThreadBarriers lists;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            BarrierStats stats;
+            stats.iops = 1;
+            for (unsigned i = 0; i < regions; ++i)
+                if (t == 0 || (i + t) % 3 != 0)
+                    T[t].push_back(std::make_pair(sequence[i], stats));
+            lists.push_back(&T[t]);
+        }
+
+        auto serial = BarrierMerge::merge(lists, 1);
+        auto parallel = BarrierMerge::merge(lists, 8);
+        REQUIRE(serial.size() == regions);
+        REQUIRE(parallel.size() == regions);
+
+        auto it = parallel.begin();
+        auto expected = serial.begin();
+        for (unsigned i = 0; i < regions; ++i, ++it, ++expected)
+        {
+            REQUIRE(it->first == sequence[i]);
+            REQUIRE(it->first == expected->first);
+            REQUIRE(equal(it->second, expected->second));
+        }
+
+        StatCounter total = 0;
+        for (auto &region : parallel)
+            total += region.second.iops;
+        StatCounter expectedTotal = 0;
+        for (auto &thread : T)
+            expectedTotal += thread.size();
+        REQUIRE(total == expectedTotal);
+    }
+}
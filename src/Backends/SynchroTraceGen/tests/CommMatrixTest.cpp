@@ -0,0 +1,100 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "SynchroTraceGen/CommMatrix.hpp"
+#include <fstream>
+#include <vector>
+#include <unistd.h>
+
+using namespace STGen;
+
+namespace
+{
+
+auto readLines(const std::string &path) -> std::vector<std::string>
+{
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);)
+        lines.push_back(line);
+    return lines;
+}
+
+}; //end namespace
+
+TEST_CASE("communication matrix windows", "[CommMatrix]")
+{
+    char dir[] = "/tmp/commmatrixXXXXXX";
+    REQUIRE(mkdtemp(dir) != nullptr);
+    std::string path = std::string(dir) + "/sigil.comm.csv";
+
+    SECTION("instruction windows")
+    {
+        auto log = std::make_shared<CommLog>(dir);
+        {
+            CommMatrix consumer2(2, 3, 0, log);
+            CommMatrix consumer3(3, 3, 0, log);
+
+            consumer2.onComm(3, 2);
+            consumer2.onComm(1, 8);
+            consumer2.onComm(1, 4);
+            consumer3.onComm(2, 1);
+            for (int i = 0; i < 3; ++i)
+            {
+                consumer2.onInstr();
+                consumer3.onInstr();
+            }
+
+            /* each row is written, sorted by producer, when its window closes */
+            std::vector<std::string> closed{"window,producer,consumer,bytes",
+                                            "0,1,2,12",
+                                            "0,3,2,2",
+                                            "0,2,3,1"};
+            fflush(nullptr);
+            REQUIRE(readLines(path) == closed);
+
+            /* an empty window, then a partial one closed on exit */
+            for (int i = 0; i < 3; ++i)
+                consumer2.onInstr();
+            consumer2.onComm(1, 16);
+            consumer2.onInstr();
+
+            /* barriers do not close instruction windows */
+            consumer3.onComm(1, 5);
+            consumer3.onBarrier();
+            consumer3.onComm(1, 5);
+        }
+        log->close();
+
+        std::vector<std::string> expected{"window,producer,consumer,bytes",
+                                          "0,1,2,12",
+                                          "0,3,2,2",
+                                          "0,2,3,1",
+                                          "1,1,3,10",
+                                          "2,1,2,16"};
+        REQUIRE(readLines(path) == expected);
+    }
+
+    SECTION("barrier regions")
+    {
+        auto log = std::make_shared<CommLog>(dir);
+        {
+            /* a thread that starts after two barriers */
+            CommMatrix consumer(4, CommMatrix::PER_BARRIER, 2, log);
+            consumer.onComm(1, 8);
+            for (int i = 0; i < 100; ++i)
+                consumer.onInstr();
+            consumer.onBarrier();
+            consumer.onComm(2, 8);
+        }
+        log->close();
+
+        std::vector<std::string> expected{"window,producer,consumer,bytes",
+                                          "2,1,4,8",
+                                          "3,2,4,8"};
+        REQUIRE(readLines(path) == expected);
+    }
+
+    unlink(path.c_str());
+    rmdir(dir);
+}
@@ -0,0 +1,79 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "SynchroTraceGen/PcProfile.hpp"
+#include <fstream>
+#include <unistd.h>
+#include <vector>
+
+using namespace STGen;
+
+namespace
+{
+
+auto readLines(const std::string &path) -> std::vector<std::string>
+{
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);)
+        lines.push_back(line);
+    return lines;
+}
+
+}; //end namespace
+
+TEST_CASE("communication between instruction pairs", "[PcProfile]")
+{
+    char dir[] = "/tmp/pcprofileXXXXXX";
+    REQUIRE(mkdtemp(dir) != nullptr);
+    std::string path = std::string(dir) + "/sigil.commpc.csv";
+
+    SECTION("pairs are ranked by bytes")
+    {
+        {
+            PcProfile producer(PcPairs::open(dir, 8));
+            PcProfile consumer(PcPairs::open(dir, 8));
+
+            producer.onInstr(0x400100);
+            producer.onWrite(0x1000, 8);
+            producer.onInstr(0x400200);
+            producer.onWrite(0x2000, 4);
+
+            consumer.onInstr(0x400300);
+            consumer.onComm(0x1000, 8);
+            consumer.onComm(0x2000, 4);
+            consumer.onInstr(0x400400);
+            consumer.onComm(0x1004, 4);
+            consumer.onInstr(0x400300);
+            consumer.onComm(0x1000, 8);
+        }
+
+        std::vector<std::string> expected{"producer_pc,consumer_pc,bytes",
+                                          "0x400100,0x400300,16",
+                                          "0x400100,0x400400,4",
+                                          "0x400200,0x400300,4"};
+        REQUIRE(readLines(path) == expected);
+    }
+
+    SECTION("only the heaviest pairs are kept")
+    {
+        {
+            PcProfile thread(PcPairs::open(dir, 1));
+
+            /* a read of data that was never written */
+            thread.onInstr(0x400100);
+            thread.onComm(0x3000, 2);
+
+            thread.onWrite(0x1000, 1);
+            thread.onInstr(0x400200);
+            thread.onComm(0x1000, 1);
+        }
+
+        std::vector<std::string> expected{"producer_pc,consumer_pc,bytes",
+                                          "0x0,0x400100,2"};
+        REQUIRE(readLines(path) == expected);
+    }
+
+    unlink(path.c_str());
+    rmdir(dir);
+}
@@ -0,0 +1,76 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "SynchroTraceGen/RegionOfInterest.hpp"
+
+using namespace STGen;
+using Kind = RegionBound::Kind;
+
+TEST_CASE("whole program without bounds", "[RegionOfInterest]")
+{
+    RegionOfInterest region({}, {});
+    REQUIRE(region.isActive() == true);
+    REQUIRE(region.onInstr() == true);
+    REQUIRE(region.onSync(0x10, 1) == true);
+    REQUIRE(region.isActive() == true);
+}
+
+TEST_CASE("fast-forward by instructions", "[RegionOfInterest]")
+{
+    RegionOfInterest region({Kind::INSTRUCTION, 3}, {Kind::INSTRUCTION, 5});
+    REQUIRE(region.isActive() == false);
+
+    /* instructions 4 and 5 are in the region */
+    REQUIRE(region.onInstr() == false);
+    REQUIRE(region.onInstr() == false);
+    REQUIRE(region.onInstr() == false);
+    REQUIRE(region.onInstr() == true);
+    REQUIRE(region.isActive() == true);
+    REQUIRE(region.onInstr() == true);
+    REQUIRE(region.onInstr() == false);
+    REQUIRE(region.isActive() == false);
+
+    /* the region is never entered again */
+    REQUIRE(region.onSync(0x10, 1) == false);
+    REQUIRE(region.onInstr() == false);
+}
+
+TEST_CASE("region between barriers", "[RegionOfInterest]")
+{
+    RegionOfInterest region({Kind::BARRIER, 2}, {Kind::BARRIER, 4});
+
+    REQUIRE(region.onSync(0xb, 1) == false);
+    REQUIRE(region.onSync(0xa, 0) == false);
+
+    /* the starting barrier is the first event of the region */
+    REQUIRE(region.onSync(0xb, 2) == true);
+    REQUIRE(region.onInstr() == true);
+    REQUIRE(region.onSync(0xa, 0) == true);
+    REQUIRE(region.onSync(0xb, 3) == true);
+
+    /* the stopping barrier is not */
+    REQUIRE(region.onSync(0xb, 4) == false);
+    REQUIRE(region.isActive() == false);
+}
+
+TEST_CASE("region between sync events on one address", "[RegionOfInterest]")
+{
+    RegionOfInterest region({Kind::SYNC, 0x1000}, {Kind::SYNC, 0x1000});
+
+    REQUIRE(region.onSync(0x2000, 0) == false);
+    REQUIRE(region.onInstr() == false);
+    REQUIRE(region.onSync(0x1000, 0) == true);
+    REQUIRE(region.onSync(0x2000, 1) == true);
+    REQUIRE(region.onInstr() == true);
+    REQUIRE(region.onSync(0x1000, 0) == false);
+    REQUIRE(region.onInstr() == false);
+}
+
+TEST_CASE("stop without a start", "[RegionOfInterest]")
+{
+    RegionOfInterest region({}, {Kind::INSTRUCTION, 2});
+
+    REQUIRE(region.onInstr() == true);
+    REQUIRE(region.onInstr() == true);
+    REQUIRE(region.onInstr() == false);
+}
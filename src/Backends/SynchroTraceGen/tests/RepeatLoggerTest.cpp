@@ -0,0 +1,193 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "SynchroTraceGen/RepeatLogger.hpp"
+
+using namespace STGen;
+
+struct Record
+{
+    /* one logged record; repeat is 1 for plain compute events,
+     * and 0 for anything that is not a compute event */
+    unsigned repeat;
+    int64_t stride;
+    EID eid;
+    StatCounter iops;
+    std::vector<AddrSet::AddrRange> writes;
+    std::vector<AddrSet::AddrRange> reads;
+};
+
+class RecordingLogger : public STLoggerCompressed
+{
+  public:
+    RecordingLogger(std::vector<Record> &records, bool expand)
+        : records(records), expand(expand) {}
+
+    auto flush(const STCompEventCompressed& ev, EID eid, TID tid) -> void override final
+    {
+        (void)tid;
+        records.push_back({1, 0, eid, ev.iops,
+                           {ev.uniqueWriteAddrs.get().begin(), ev.uniqueWriteAddrs.get().end()},
+                           {ev.uniqueReadAddrs.get().begin(), ev.uniqueReadAddrs.get().end()}});
+    }
+
+    auto flushRepeat(const STCompEventCompressed& ev, unsigned repeat, int64_t stride,
+                     EID eid, TID tid) -> void override final
+    {
+        if (expand == true)
+            return STLoggerCompressed::flushRepeat(ev, repeat, stride, eid, tid);
+        flush(ev, eid, tid);
+        records.back().repeat = repeat;
+        records.back().stride = stride;
+    }
+
+    auto flush(const STCommEventCompressed& ev, EID eid, TID tid) -> void override final
+    {
+        (void)ev;
+        (void)tid;
+        records.push_back({0, 0, eid, 0, {}, {}});
+    }
+
+    auto flush(unsigned char syncType, unsigned numArgs, Addr *syncArgs,
+               EID eid, TID tid) -> void override final
+    {
+        (void)syncType;
+        (void)numArgs;
+        (void)syncArgs;
+        (void)tid;
+        records.push_back({0, 0, eid, 0, {}, {}});
+    }
+
+    auto instrMarker(int limit) -> void override final
+    {
+        (void)limit;
+    }
+
+  private:
+    std::vector<Record> &records;
+    bool expand;
+};
+
+auto compEvent(STCompEventCompressed &ev, Addr write, Addr read, StatCounter iops) -> void
+{
+    ev.reset();
+    ev.iops = iops;
+    ev.incWrites();
+    ev.updateWrites(write, 8);
+    ev.incReads();
+    ev.updateReads(read, 4);
+    ev.updateReads(read + 64, 4);
+}
+
+TEST_CASE("repeat logger folds strided compute events", "[RepeatLogger]")
+{
+    std::vector<Record> records;
+    STCompEventCompressed ev;
+
+    SECTION("a strided run becomes one record")
+    {
+        {
+            RepeatLogger logger(std::make_unique<RecordingLogger>(records, false), 100);
+            for (EID i = 0; i < 10; ++i)
+            {
+                compEvent(ev, 0x1000 + 8*i, 0x2000 + 8*i, 3);
+                logger.flush(ev, i, 1);
+            }
+        }
+        REQUIRE(records.size() == 1);
+        REQUIRE(records[0].repeat == 10);
+        REQUIRE(records[0].stride == 8);
+        REQUIRE(records[0].eid == 0);
+        REQUIRE(records[0].writes.front().first == 0x1000);
+    }
+
+    SECTION("negative strides and identical events")
+    {
+        {
+            RepeatLogger logger(std::make_unique<RecordingLogger>(records, false), 100);
+            for (EID i = 0; i < 4; ++i)
+            {
+                compEvent(ev, 0x1000 - 16*i, 0x2000 - 16*i, 3);
+                logger.flush(ev, i, 1);
+            }
+            for (EID i = 4; i < 8; ++i)
+            {
+                compEvent(ev, 0x1000, 0x2000, 3);
+                logger.flush(ev, i, 1);
+            }
+        }
+        REQUIRE(records.size() == 2);
+        REQUIRE(records[0].repeat == 4);
+        REQUIRE(records[0].stride == -16);
+        REQUIRE(records[1].repeat == 4);
+        REQUIRE(records[1].stride == 0);
+        REQUIRE(records[1].eid == 4);
+    }
+
+    SECTION("changed counts, broken strides, and other events end the run")
+    {
+        {
+            RepeatLogger logger(std::make_unique<RecordingLogger>(records, false), 100);
+            compEvent(ev, 0x1000, 0x2000, 3);
+            logger.flush(ev, 0, 1);
+            compEvent(ev, 0x1008, 0x2008, 3);
+            logger.flush(ev, 1, 1);
+            compEvent(ev, 0x1018, 0x2018, 3); // stride 16
+            logger.flush(ev, 2, 1);
+            compEvent(ev, 0x1020, 0x2020, 4); // different iops
+            logger.flush(ev, 3, 1);
+            Addr arg = 0;
+            logger.flush(1, 1, &arg, 4, 1);
+            compEvent(ev, 0x1028, 0x2028, 4);
+            logger.flush(ev, 5, 1);
+        }
+        REQUIRE(records.size() == 5);
+        REQUIRE(records[0].repeat == 2);
+        REQUIRE(records[1].repeat == 1);
+        REQUIRE(records[1].eid == 2);
+        REQUIRE(records[2].repeat == 1);
+        REQUIRE(records[3].repeat == 0);
+        REQUIRE(records[4].eid == 5);
+    }
+
+    SECTION("runs are capped")
+    {
+        {
+            RepeatLogger logger(std::make_unique<RecordingLogger>(records, false), 3);
+            for (EID i = 0; i < 7; ++i)
+            {
+                compEvent(ev, 0x1000 + 8*i, 0x2000 + 8*i, 3);
+                logger.flush(ev, i, 1);
+            }
+        }
+        REQUIRE(records.size() == 3);
+        REQUIRE(records[0].repeat == 3);
+        REQUIRE(records[1].repeat == 3);
+        REQUIRE(records[1].eid == 3);
+        REQUIRE(records[2].repeat == 1);
+    }
+
+    SECTION("expanding a run replays the original events")
+    {
+        std::vector<Record> original;
+        {
+            RecordingLogger direct(original, true);
+            RepeatLogger logger(std::make_unique<RecordingLogger>(records, true), 100);
+            for (EID i = 0; i < 6; ++i)
+            {
+                compEvent(ev, 0x1000 + 24*i, 0x2000 + 24*i, 3);
+                logger.flush(ev, i, 1);
+                direct.flush(ev, i, 1);
+            }
+        }
+        REQUIRE(records.size() == original.size());
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            REQUIRE(records[i].repeat == 1);
+            REQUIRE(records[i].eid == original[i].eid);
+            REQUIRE(records[i].iops == original[i].iops);
+            REQUIRE(records[i].writes == original[i].writes);
+            REQUIRE(records[i].reads == original[i].reads);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "SynchroTraceGen/STStats.hpp"
+
+using namespace STGen;
+
+TEST_CASE("estimates from uniform windows are exact", "[SampleEstimator]")
+{
+    SampleEstimator sampling;
+    for (int i = 0; i < 10; ++i)
+        sampling.addWindow(Stats{30, 10, 20, 5, 100});
+
+    /* 10 windows of 100 instructions, out of 10000 */
+    auto iops = sampling.estimate(IOP, 10000);
+    REQUIRE(iops.value == Approx(3000));
+    REQUIRE(iops.error == Approx(0));
+
+    auto writes = sampling.estimate(WRITE, 10000);
+    REQUIRE(writes.value == Approx(500));
+    REQUIRE(sampling.getWindows() == 10);
+}
+
+TEST_CASE("confidence interval from varying windows", "[SampleEstimator]")
+{
+    SampleEstimator sampling;
+    sampling.addWindow(Stats{10, 0, 0, 0, 100});
+    sampling.addWindow(Stats{30, 0, 0, 0, 100});
+
+    /* rates 0.1 and 0.3: mean 0.2, sample variance 0.02 */
+    auto iops = sampling.estimate(IOP, 1000);
+    REQUIRE(iops.value == Approx(200));
+
+    double correction = 1.0 - 2.0 / 10;
+    REQUIRE(iops.error == Approx(1.96 * std::sqrt(0.02 / 2 * correction) * 1000));
+
+    /* every window was detailed, so there is nothing left to estimate */
+    REQUIRE(sampling.estimate(IOP, 200).error == Approx(0));
+}
+
+TEST_CASE("too few windows for an interval", "[SampleEstimator]")
+{
+    SampleEstimator sampling;
+    REQUIRE(sampling.estimate(READ, 1000).value == 0);
+    REQUIRE(std::isnan(sampling.estimate(READ, 1000).error) == true);
+
+    sampling.addWindow(Stats{0, 0, 4, 0, 8});
+    REQUIRE(sampling.estimate(READ, 1000).value == Approx(500));
+    REQUIRE(std::isnan(sampling.estimate(READ, 1000).error) == true);
+}
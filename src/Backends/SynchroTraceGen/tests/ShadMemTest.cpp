@@ -103,6 +103,25 @@ TEST_CASE("shadow memory tracks readers/writers", "[ShadowMemorySetGet]")
         REQUIRE(sm.getWriterEID(addr1) == eid1);
     }
 
+    SECTION("event IDs past 32 bits")
+    {
+        STShadowMemory sm;
+
+        TID tid1 = 2;
+        Addr addr1 = 0x1000;
+        EID eid1 = (EID{1} << 32) + 7;
+        EID eid2 = STGen::MAX_EID;
+
+        sm.updateWriter(addr1, 4, tid1, eid1);
+        REQUIRE(sm.getWriterTID(addr1) == tid1);
+        REQUIRE(sm.getWriterEID(addr1) == eid1);
+        REQUIRE(sm.getWriterEID(addr1 + 3) == eid1);
+
+        sm.updateWriter(addr1 + 2, 2, tid1, eid2);
+        REQUIRE(sm.getWriterEID(addr1) == eid1);
+        REQUIRE(sm.getWriterEID(addr1 + 2) == eid2);
+    }
+
     SECTION("setting multiple readers")
     {
         //TODO
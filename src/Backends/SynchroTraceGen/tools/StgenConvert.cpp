@@ -0,0 +1,563 @@
+#include "Utils/PrismLog.hpp"
+#include "ThreadContext.hpp"
+#include "StgenTextParser.hpp"
+#include "StgenTraceReader.hpp"
+#include "argparse/argparse.hpp"
+#include "spdlog/async.h"
+#include <fstream>
+#include <map>
+#include <regex>
+
+/******************************************************************************
+ * stgen-convert
+ *
+ * Re-encodes an existing SynchroTraceGen output directory in another
+ * trace format (text, textv2, capnp), without re-running the application.
+ *
+ * Each per-thread trace is converted through a pipeline:
+ * - inflate and parse (text batches, or capnproto messages) on a reader thread,
+ * - re-encode with the same STLogger* writers SynchroTraceGen uses,
+ * - compress on the writers' own asynchronous threads.
+ * Stages are connected with bounded queues, so memory use does not grow with
+ * the trace size. Different threads' traces are converted in parallel.
+ *****************************************************************************/
+
+using PrismLog::fatal;
+using PrismLog::info;
+
+namespace STGen
+{
+
+namespace
+{
+
+namespace fs = std::filesystem;
+
+constexpr unsigned batchesInFlight = 2;
+
+struct TextTrace
+{
+    TID tid;
+    fs::path path;
+    EID firstEid;
+};
+
+
+auto findTextTraces(const fs::path &dir) -> std::vector<TextTrace>
+{
+    static const std::regex traceName(R"(sigil\.events\.out-(\d+)\.gz)");
+
+    std::vector<TextTrace> found;
+    for (auto &entry : fs::directory_iterator(dir))
+    {
+        std::smatch match;
+        auto fname = entry.path().filename().string();
+        if (entry.is_regular_file() && std::regex_match(fname, match, traceName))
+            found.push_back({static_cast<TID>(std::stoi(match[1])), entry.path(), 0});
+    }
+    return found;
+}
+
+
+auto hasCapnpTraces(const fs::path &dir) -> bool
+{
+    for (auto &entry : fs::directory_iterator(dir))
+        if (entry.path().filename().string().find(".capn.bin") != std::string::npos)
+            return true;
+    return false;
+}
+
+
+auto firstEventIDs(const fs::path &dir) -> std::map<TID, EID>
+{
+    /* Capnproto and textv2 traces do not store event IDs, so they are counted
+     * from the start of each trace. A 'region-N' directory of a segmented trace
+     * continues each thread's event IDs from the previous segment; the
+     * first of each is in sigil.segments.out, next to the region */
+    static const std::regex regionName(R"(region-\d+)");
+
+    std::map<TID, EID> first;
+    auto region = fs::absolute(dir).lexically_normal();
+    if (region.has_filename() == false)
+        region = region.parent_path();
+    if (std::regex_match(region.filename().string(), regionName) == false)
+        return first;
+
+    auto segmentsPath = region.parent_path() / "sigil.segments.out";
+    std::ifstream segments(segmentsPath);
+    if (segments.is_open() == false)
+        fatal("stgen-convert: a trace segment needs its sigil.segments.out: " +
+              segmentsPath.string());
+
+    /* region,directory,tid,first_eid */
+    static const std::regex line(R"((\d+),([^,]+),(\d+),(\d+))");
+    for (std::string row; std::getline(segments, row);)
+    {
+        std::smatch match;
+        if (std::regex_match(row, match, line) == true && match[2] == region.filename().string())
+            first[static_cast<TID>(std::stoi(match[3]))] = std::stoull(match[4]);
+    }
+    return first;
+}
+
+
+auto firstEventID(const std::map<TID, EID> &first, TID tid) -> EID
+{
+    if (first.empty() == true)
+        return 0;
+    auto it = first.find(tid);
+    if (it == first.end())
+        fatal("stgen-convert: no first event ID for thread " + std::to_string(tid) +
+              " in sigil.segments.out");
+    return it->second;
+}
+
+
+auto toSyncType(EventStreamCompressed::Event::SyncType type) -> unsigned char
+{
+    /* inverse of the CapnLogger translation */
+    using SyncType = EventStreamCompressed::Event::SyncType;
+    switch (type)
+    {
+    case SyncType::LOCK:           return 1;
+    case SyncType::UNLOCK:         return 2;
+    case SyncType::SPAWN:          return 3;
+    case SyncType::JOIN:           return 4;
+    case SyncType::BARRIER:        return 5;
+    case SyncType::COND_WAIT:      return 6;
+    case SyncType::COND_SIGNAL:    return 7;
+    case SyncType::COND_BROADCAST: return 8;
+    case SyncType::SPIN_LOCK:      return 9;
+    case SyncType::SPIN_UNLOCK:    return 10;
+    default:
+        fatal("stgen-convert encountered unhandled sync event");
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+/** Text -> any **/
+class TextBatchPipeline
+{
+    /* Parses a text trace on its own thread, handing filled batches over
+     * to the caller, who hands them back once re-encoded.
+     * Only 'batchesInFlight' batches ever exist. */
+  public:
+    explicit TextBatchPipeline(const TextTrace &trace)
+        : parser(trace.path, StgenTextParser::defaultBlockSize, trace.firstEid)
+        , filled(batchesInFlight)
+        , empty(batchesInFlight)
+    {
+        for (unsigned i = 0; i < batchesInFlight; ++i)
+            empty.push(std::make_unique<TextEventBatch>());
+        reader = std::thread([this]{ parse(); });
+    }
+
+    ~TextBatchPipeline()
+    {
+        filled.close();
+        empty.close();
+        reader.join();
+    }
+
+    auto next() -> std::unique_ptr<TextEventBatch>
+    {
+        auto batch = filled.pop();
+        return batch ? std::move(*batch) : nullptr;
+    }
+
+    auto recycle(std::unique_ptr<TextEventBatch> batch) -> void
+    {
+        empty.push(std::move(batch));
+    }
+
+  private:
+    auto parse() -> void
+    {
+        while (auto batch = empty.pop())
+        {
+            if (parser.next(**batch) == false || filled.push(std::move(*batch)) == false)
+                break;
+        }
+        filled.close();
+    }
+
+    StgenTextParser parser;
+    BoundedQueue<std::unique_ptr<TextEventBatch>> filled;
+    BoundedQueue<std::unique_ptr<TextEventBatch>> empty;
+    std::thread reader;
+};
+
+
+auto syncArgs(const TextEventBatch &batch, size_t i, std::vector<Addr> &args) -> unsigned
+{
+    args.clear();
+    for (auto j = batch.addrBegin[i]; j < batch.addrBegin[i+1]; ++j)
+        args.push_back(batch.start[j]);
+    if (args.empty() == true)
+        fatal("stgen-convert: sync event without arguments");
+    return args.size();
+}
+
+
+auto convertText(const TextTrace &trace, STLoggerCompressed &logger) -> void
+{
+    STCompEventCompressed comp;
+    STCommEventCompressed comm;
+    std::vector<Addr> args;
+
+    TextBatchPipeline pipeline(trace);
+    while (auto batch = pipeline.next())
+    {
+        for (size_t i = 0; i < batch->size(); ++i)
+        {
+            auto begin = batch->addrBegin[i];
+            auto end = batch->addrBegin[i+1];
+            switch (batch->type[i])
+            {
+            case TextEventType::COMP:
+                comp.reset();
+                comp.iops = batch->iops[i];
+                comp.flops = batch->flops[i];
+                comp.reads = batch->reads[i];
+                comp.writes = batch->writes[i];
+                for (auto j = begin; j < end; ++j)
+                {
+                    auto range = std::make_pair(batch->start[j], batch->end[j]);
+                    if (batch->addrType[j] == TextAddrType::WRITE)
+                        comp.uniqueWriteAddrs.insert(range);
+                    else
+                        comp.uniqueReadAddrs.insert(range);
+                }
+                logger.flush(comp, batch->eid[i], trace.tid);
+                break;
+            case TextEventType::COMM:
+                comm.reset();
+                for (auto j = begin; j < end; ++j)
+                {
+                    /* consecutive ranges from the same producer event are one edge */
+                    TID producerTID = batch->producerTid[j];
+                    EID producerEID = batch->producerEid[j];
+                    auto range = std::make_pair(batch->start[j], batch->end[j]);
+                    if (comm.comms.empty() == false &&
+                        std::get<0>(comm.comms.back()) == producerTID &&
+                        std::get<1>(comm.comms.back()) == producerEID)
+                        std::get<2>(comm.comms.back()).insert(range);
+                    else
+                        comm.comms.emplace_back(producerTID, producerEID, AddrSet(range));
+                }
+                logger.flush(comm, batch->eid[i], trace.tid);
+                break;
+            case TextEventType::SYNC:
+                {
+                    unsigned numArgs = syncArgs(*batch, i, args);
+                    logger.flush(batch->iops[i], numArgs, args.data(), batch->eid[i], trace.tid);
+                }
+                break;
+            case TextEventType::MARKER:
+                logger.instrMarker(batch->iops[i]);
+                break;
+            }
+        }
+        pipeline.recycle(std::move(batch));
+    }
+}
+
+
+auto convertText(const TextTrace &trace, STLoggerUncompressed &logger) -> void
+{
+    using MemType = STCompEventUncompressed::MemType;
+    std::vector<Addr> args;
+
+    TextBatchPipeline pipeline(trace);
+    while (auto batch = pipeline.next())
+    {
+        for (size_t i = 0; i < batch->size(); ++i)
+        {
+            auto begin = batch->addrBegin[i];
+            auto end = batch->addrBegin[i+1];
+            EID eid = batch->eid[i];
+            switch (batch->type[i])
+            {
+            case TextEventType::COMP:
+                if (end - begin > 1)
+                    fatal("stgen-convert: compressed text trace, but converting with -c 1");
+                if (begin == end)
+                    logger.flush(batch->iops[i], batch->flops[i], MemType::NONE,
+                                 0, 0, eid, trace.tid);
+                else
+                    logger.flush(batch->iops[i], batch->flops[i],
+                                 (batch->addrType[begin] == TextAddrType::WRITE ?
+                                  MemType::WRITE : MemType::READ),
+                                 batch->start[begin], batch->end[begin], eid, trace.tid);
+                break;
+            case TextEventType::COMM:
+                if (end - begin != 1)
+                    fatal("stgen-convert: compressed text trace, but converting with -c 1");
+                logger.flush(batch->producerEid[begin], batch->producerTid[begin],
+                             batch->start[begin], batch->end[begin], eid, trace.tid);
+                break;
+            case TextEventType::SYNC:
+                {
+                    unsigned numArgs = syncArgs(*batch, i, args);
+                    logger.flush(batch->iops[i], numArgs, args.data(), eid, trace.tid);
+                }
+                break;
+            case TextEventType::MARKER:
+                logger.instrMarker(batch->iops[i]);
+                break;
+            }
+        }
+        pipeline.recycle(std::move(batch));
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+/** Capnproto -> any **/
+auto convertCapnp(capnp::PackedMessageReader &message, TID tid, EID &eid,
+                  STLoggerCompressed &logger) -> void
+{
+    using Event = EventStreamCompressed::Event;
+
+    STCompEventCompressed comp;
+    STCommEventCompressed comm;
+    std::vector<Addr> args;
+
+    for (auto event : message.getRoot<EventStreamCompressed>().getEvents())
+    {
+        switch (event.which())
+        {
+        case Event::COMP:
+            {
+                auto ev = event.getComp();
+                comp.reset();
+                comp.iops = ev.getIops();
+                comp.flops = ev.getFlops();
+                comp.reads = ev.getReads();
+                comp.writes = ev.getWrites();
+                for (auto range : ev.getWriteAddrs())
+                    comp.uniqueWriteAddrs.insert({range.getStart(), range.getEnd()});
+                for (auto range : ev.getReadAddrs())
+                    comp.uniqueReadAddrs.insert({range.getStart(), range.getEnd()});
+                if (ev.getRepeat() > 1)
+                {
+                    logger.flushRepeat(comp, ev.getRepeat(), ev.getStride(), eid, tid);
+                    eid += ev.getRepeat();
+                }
+                else
+                {
+                    logger.flush(comp, eid++, tid);
+                }
+            }
+            break;
+        case Event::COMM:
+            comm.reset();
+            for (auto edge : event.getComm().getEdges())
+            {
+                AddrSet ranges;
+                for (auto range : edge.getAddrs())
+                    ranges.insert({range.getStart(), range.getEnd()});
+                EID producerEID = (EID{edge.getProducerEventHigh()} << 32) | edge.getProducerEvent();
+                comm.comms.emplace_back(edge.getProducerThread(), producerEID, ranges);
+            }
+            logger.flush(comm, eid++, tid);
+            break;
+        case Event::SYNC:
+            {
+                auto ev = event.getSync();
+                args.clear();
+                for (auto arg : ev.getArgs())
+                    args.push_back(arg);
+                logger.flush(toSyncType(ev.getType()), args.size(), args.data(), eid++, tid);
+            }
+            break;
+        case Event::MARKER:
+            logger.instrMarker(event.getMarker().getCount());
+            break;
+        default:
+            fatal("stgen-convert encountered unhandled capnproto event");
+        }
+    }
+}
+
+
+auto convertCapnp(capnp::PackedMessageReader &message, TID tid, EID &eid,
+                  STLoggerUncompressed &logger) -> void
+{
+    using Event = EventStreamUncompressed::Event;
+
+    std::vector<Addr> args;
+
+    for (auto event : message.getRoot<EventStreamUncompressed>().getEvents())
+    {
+        switch (event.which())
+        {
+        case Event::COMP:
+            {
+                auto ev = event.getComp();
+                logger.flush(ev.getIops(), ev.getFlops(), ev.getMem(),
+                             ev.getStartAddr(), ev.getEndAddr(), eid++, tid);
+            }
+            break;
+        case Event::COMM:
+            {
+                auto ev = event.getComm();
+                EID producerEID = (EID{ev.getProducerEventHigh()} << 32) | ev.getProducerEvent();
+                logger.flush(producerEID, ev.getProducerThread(),
+                             ev.getStartAddr(), ev.getEndAddr(), eid++, tid);
+            }
+            break;
+        case Event::SYNC:
+            {
+                auto ev = event.getSync();
+                args.clear();
+                for (auto arg : ev.getArgs())
+                    args.push_back(arg);
+                /* both schemas share the sync type enumerants */
+                auto type = static_cast<EventStreamCompressed::Event::SyncType>(
+                    static_cast<uint16_t>(ev.getType()));
+                logger.flush(toSyncType(type), args.size(), args.data(), eid++, tid);
+            }
+            break;
+        case Event::MARKER:
+            logger.instrMarker(event.getMarker().getCount());
+            break;
+        default:
+            fatal("stgen-convert encountered unhandled capnproto event");
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+template <typename TCxtType>
+auto convertTextDir(const std::vector<TextTrace> &traces, const std::string &outputPath,
+                    const std::string &loggerType, unsigned workers) -> void
+{
+    /* Workers claim whole files */
+    std::atomic<size_t> unclaimed{0};
+    auto work = [&]
+    {
+        for (size_t i = unclaimed++; i < traces.size(); i = unclaimed++)
+        {
+            auto logger = TCxtType::getLogger(traces[i].tid, outputPath, loggerType);
+            convertText(traces[i], *logger);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < workers; ++i)
+        pool.emplace_back(work);
+    work();
+    for (auto &thread : pool)
+        thread.join();
+}
+
+
+template <typename TCxtType>
+auto convertCapnpDir(StgenTraceReader &reader, const std::map<TID, EID> &first,
+                     const std::string &outputPath, const std::string &loggerType,
+                     unsigned workers) -> void
+{
+    /* Workers claim whole files, and only open a file's logger once they reach it */
+    auto &files = reader.files();
+    std::atomic<size_t> unclaimed{0};
+    auto work = [&]
+    {
+        for (size_t i = unclaimed++; i < files.size(); i = unclaimed++)
+        {
+            EID eid = firstEventID(first, files[i].tid);
+            auto logger = TCxtType::getLogger(files[i].tid, outputPath, loggerType);
+            while (auto message = reader.next(i))
+                convertCapnp(*message, files[i].tid, eid, *logger);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < std::min<size_t>(workers, files.size()); ++i)
+        pool.emplace_back(work);
+    work();
+    for (auto &thread : pool)
+        thread.join();
+}
+
+}; //end namespace
+
+
+auto convert(const fs::path &input, const fs::path &output,
+             const std::string &loggerType, bool uncompressed, unsigned workers) -> void
+{
+    if (fs::is_directory(input) == false)
+        fatal("stgen-convert: not a directory: " + input.string());
+    fs::create_directories(output);
+    if (fs::equivalent(input, output) == true)
+        fatal("stgen-convert: input and output directories must differ");
+
+    /* writers hand off to spdlog's asynchronous thread pool */
+    spdlog::init_thread_pool(8192, workers);
+
+    auto first = firstEventIDs(input);
+
+    if (hasCapnpTraces(input) == true)
+    {
+        StgenTraceReader reader(input);
+        if (reader.files().front().format == TraceFormat::CAPNP_UNCOMPRESSED)
+            convertCapnpDir<ThreadContextUncompressed>(reader, first, output, loggerType, workers);
+        else
+            convertCapnpDir<ThreadContextCompressed>(reader, first, output, loggerType, workers);
+    }
+    else
+    {
+        auto traces = findTextTraces(input);
+        if (traces.empty() == true)
+            fatal("stgen-convert: no SynchroTraceGen traces in: " + input.string());
+        for (auto &trace : traces)
+            trace.firstEid = firstEventID(first, trace.tid);
+        if (uncompressed == true)
+            convertTextDir<ThreadContextUncompressed>(traces, output, loggerType, workers);
+        else
+            convertTextDir<ThreadContextCompressed>(traces, output, loggerType, workers);
+    }
+
+    /* thread metadata and statistics do not depend on the trace format */
+    for (auto name : {"sigil.pthread.out", "sigil.stats.out", "sigil.comm.csv"})
+        if (fs::exists(input / name) == true)
+            fs::copy_file(input / name, output / name, fs::copy_options::overwrite_existing);
+    for (auto &entry : fs::directory_iterator(input))
+        if (entry.path().filename().string().rfind("sigil.barriers.out-", 0) == 0)
+            fs::copy_file(entry.path(), output / entry.path().filename(),
+                          fs::copy_options::overwrite_existing);
+}
+
+}; //end namespace STGen
+
+
+int main(int argc, const char* argv[])
+{
+    ArgumentParser argparser;
+    argparser.addArgument("-o", "--output", 1);      // output directory
+    argparser.addArgument("-l", "--logger", 1);      // {text,textv2,capnp}
+    argparser.addArgument("-c", "--compression", 1); // 1 if a text trace was generated with -c 1
+    argparser.addArgument("-j", "--jobs", 1);        // traces converted in parallel
+    argparser.addFinalArgument("inputdir");
+    argparser.parse(argc, argv);
+
+    if (argparser.count("output") == 0 || argparser.count("logger") == 0)
+        fatal("usage: stgen-convert -o OUTPUT_DIR -l {text,textv2,capnp} [-c 1] [-j N] INPUT_DIR");
+
+    auto loggerType = argparser.retrieve<std::string>("logger");
+    if (loggerType != "text" && loggerType != "textv2" && loggerType != "capnp")
+        fatal("stgen-convert: unexpected logger: " + loggerType);
+
+    bool uncompressed = (argparser.count("compression") > 0 &&
+                         argparser.retrieve<std::string>("compression") == "1");
+
+    unsigned workers = std::max(1U, std::thread::hardware_concurrency());
+    if (argparser.count("jobs") > 0)
+        workers = std::max(1UL, std::stoul(argparser.retrieve<std::string>("jobs")));
+
+    STGen::convert(argparser.retrieve<std::string>("inputdir"),
+                   argparser.retrieve<std::string>("output"),
+                   loggerType, uncompressed, workers);
+}
@@ -2,6 +2,54 @@
 #include "PrismLog.hpp"
 #include <algorithm>
 
+namespace
+{
+
+auto onMemCount(BackendIface &be, const PrismMemEv &ev) -> void
+{
+    /* a summarized run of accesses arrives as plain loads/stores */
+    PrismMemEv access{};
+    access.type = (ev.type == MemTypeEnum::PRISM_MEM_LOAD_COUNT ?
+                   MemTypeEnum::PRISM_MEM_LOAD : MemTypeEnum::PRISM_MEM_STORE);
+    be.onMemCountEv({access}, ev.count);
+}
+
+}; //end namespace
+
+
+auto BackendIface::onEvents(const EventBuffer &buf, prism::CxtNames &names) -> void
+{
+    for (decltype(buf.used) i = 0; i < buf.used; ++i)
+    {
+        const PrismEvVariant &ev = buf.events[i];
+
+        switch (ev.tag)
+        {
+        case EvTagEnum::PRISM_MEM_TAG:
+            if (ev.mem.type < MemTypeEnum::PRISM_MEM_LOAD_COUNT)
+                onMemEv({ev.mem});
+            else
+                onMemCount(*this, ev.mem);
+            break;
+        case EvTagEnum::PRISM_COMP_TAG:
+            onCompEv({ev.comp});
+            break;
+        case EvTagEnum::PRISM_SYNC_TAG:
+            onSyncEv({ev.sync});
+            break;
+        case EvTagEnum::PRISM_CXT_TAG:
+            onCxtEv({ev.cxt, names});
+            break;
+        case EvTagEnum::PRISM_CF_TAG:
+            onCFEv(ev.cf);
+            break;
+        default:
+            PrismLog::fatal("Received unhandled event in " __FILE__);
+        }
+    }
+}
+
+
 auto BackendFactory::create(ToolName name, Args args) const -> Backend
 {
     std::transform(name.begin(), name.end(), name.begin(), ::tolower);
@@ -2,6 +2,7 @@
 #define PRISM_BACKEND_H
 
 #include "Primitive.h"
+#include "EventBuffer.h"
 #include <string>
 #include <vector>
 #include <functional>
@@ -13,29 +14,65 @@ class BackendIface
   public:
     virtual ~BackendIface() {}
     virtual auto onMemEv(const prism::MemEvent &) -> void {}
+    virtual auto onMemCountEv(const prism::MemEvent &ev, PtrVal count) -> void
+    {
+        /* 'count' accesses without address or size;
+         * backends that only count them can add 'count' at once */
+        for (PtrVal i = 0; i < count; ++i)
+            onMemEv(ev);
+    }
     virtual auto onCompEv(const prism::CompEvent &) -> void {}
     virtual auto onSyncEv(const prism::SyncEvent &) -> void {}
     virtual auto onCxtEv(const prism::CxtEvent &) -> void {}
     virtual auto onCFEv(const PrismCFEv &) -> void {}
+
+    virtual auto onEvents(const EventBuffer &buf, prism::CxtNames &names) -> void;
+    /* Every event of a buffer, in order; by default each is passed to
+     * the handlers above. Backends that only aggregate events can
+     * override this to process the whole buffer at once */
+};
+
+class BackendContext
+{
+    /* State shared by every backend interface of one run.
+     *
+     * Each consumer thread gets its own backend interface, so state in the
+     * interface is never shared. A backend that needs state across
+     * consumers, e.g. one shadow memory for every event stream, derives
+     * its own context; it is created once, after the backend parses its
+     * args, and outlives every interface and the finish hook */
+  public:
+    virtual ~BackendContext() {}
 };
 
 using ToolName = std::string;
 using Args = std::vector<std::string>;
 using BackendPtr = std::unique_ptr<BackendIface>;
-using BackendIfaceGenerator = std::function<BackendPtr(void)>;
+using BackendContextPtr = std::unique_ptr<BackendContext>;
+
+using BackendContextGenerator = std::function<BackendContextPtr(void)>;
+/* Invoked one time, before any events */
+
+using BackendIfaceGenerator = std::function<BackendPtr(BackendContext &)>;
+/* Invoked once per consumer thread, concurrently */
 
 using BackendParser = std::function<void(const Args &)>;
 /* Args passed from the command line to the backend */
 
-using BackendFinish = std::function<void(void)>;
+using BackendFinish = std::function<void(BackendContext &)>;
 /* Invoked one time once all events have been passed to the backend */
 
+using BackendRequirements = std::function<prism::capabilities(void)>;
+/* Invoked after the backend parses its args,
+ * so requirements can depend on backend options */
+
 struct Backend
 {
+    BackendContextGenerator context;
     BackendIfaceGenerator generator;
     BackendParser parser;
     BackendFinish finish;
-    prism::capabilities caps;
+    BackendRequirements requirements;
     Args args;
 };
 
@@ -1,17 +1,46 @@
 #include "Config.hpp"
+#include "PrismLog.hpp"
 #include <numeric>
 
 namespace prism
 {
 
 auto Config::registerBackend(ToolName name,
+                             std::function<BackendPtr(void)> beGenerator,
+                             BackendParser beParser,
+                             std::function<void(void)> beFinish,
+                             prism::capabilities beRequirements) -> Config&
+{
+    return registerBackend(name, beGenerator, beParser, beFinish,
+                           [=]{ return beRequirements; });
+}
+
+
+auto Config::registerBackend(ToolName name,
+                             std::function<BackendPtr(void)> beGenerator,
+                             BackendParser beParser,
+                             std::function<void(void)> beFinish,
+                             BackendRequirements beRequirements) -> Config&
+{
+    /* an empty context, that the backend never sees */
+    return registerBackend(name,
+                           []{ return std::make_unique<BackendContext>(); },
+                           [=](BackendContext &){ return beGenerator(); },
+                           beParser,
+                           [=](BackendContext &){ if (beFinish) beFinish(); },
+                           beRequirements);
+}
+
+
+auto Config::registerBackend(ToolName name,
+                             BackendContextGenerator beContext,
                              BackendIfaceGenerator beGenerator,
                              BackendParser beParser,
                              BackendFinish beFinish,
-                             prism::capabilities beRequirements) -> Config&
+                             BackendRequirements beRequirements) -> Config&
 {
     std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-    Backend be = {beGenerator, beParser, beFinish, beRequirements, {}};
+    Backend be = {beContext, beGenerator, beParser, beFinish, beRequirements, {}};
     beFactory.add(name, be);
     return *this;
 }
@@ -39,9 +68,15 @@ auto Config::parseCommandLine(int argc, char* argv[]) -> Config&
     std::tie(backendName, beArgs) = parser.backend();
     _backend = beFactory.create(backendName, beArgs);
 
+    /* the backend's options may change what it requires of the frontend */
+    if (_backend.parser)
+        _backend.parser(_backend.args);
+    else if (_backend.args.size() > 0)
+        PrismLog::fatal("Backend arguments provided, but Backend has no parser");
+
     std::vector<std::string> feArgs;
     std::tie(frontendName, feArgs) = parser.frontend();
-    _startFrontend = feFactory.create(frontendName, execArgs, feArgs, _threads, _backend.caps);
+    _startFrontend = feFactory.create(frontendName, execArgs, feArgs, _threads, _backend.requirements());
 
     parsed = true;
 
@@ -13,10 +13,23 @@ class Config
 {
   public:
     auto registerBackend(ToolName name,
+                         std::function<BackendPtr(void)> beGenerator,
+                         BackendParser beParser,
+                         std::function<void(void)> beFinish,
+                         prism::capabilities beRequirements) -> Config&;
+    auto registerBackend(ToolName name,
+                         std::function<BackendPtr(void)> beGenerator,
+                         BackendParser beParser,
+                         std::function<void(void)> beFinish,
+                         BackendRequirements beRequirements) -> Config&;
+    /* backends without state shared between consumers */
+    auto registerBackend(ToolName name,
+                         BackendContextGenerator beContext,
                          BackendIfaceGenerator beGenerator,
                          BackendParser beParser,
                          BackendFinish beFinish,
-                         prism::capabilities beRequirements) -> Config&;
+                         BackendRequirements beRequirements) -> Config&;
+    /* backends whose consumers share one context */
     auto registerFrontend(ToolName name, Frontend fe) -> Config&;
     auto parseCommandLine(int argc, char* argv[]) -> Config&;
     /* configuration */
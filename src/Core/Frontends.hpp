@@ -35,6 +35,9 @@ class FrontendIface
      * it must implement this function to return the memory arena where
      * name strings are stored. XXX MDL20170412 See DbiFrontend.hpp */
 
+    prism::CxtNames names{nameBase};
+    /* names sent so far, by ID; see PrismCxtEv */
+
   protected:
     const unsigned uid;
   private:
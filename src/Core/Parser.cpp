@@ -31,7 +31,8 @@ auto Parser::threads() const -> int
     /* MDL20160805 Currently only valid with DynamoRIO frontend.
      * This will cause 'n' event streams between Prism and DynamoRIO
      * to be generated, and 'n' separate backend instances will
-     * read from those event streams as separate threads */
+     * read from those event streams as separate threads.
+     * Each frontend checks the number of streams it supports */
 
     int threads = 1;
     const auto threadsArg = parser.getOpt(numThreadsOption);
@@ -39,7 +40,7 @@ auto Parser::threads() const -> int
     {
         threads = stoi(threadsArg);
 
-        if (threads > 16 || threads < 1)
+        if (threads < 1)
             fatal("Invalid number of threads specified");
     }
 
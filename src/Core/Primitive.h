@@ -44,7 +44,9 @@
 #ifdef __cplusplus
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <functional>
+#include <string>
 #include <stdexcept>
 #include <vector>
 extern "C" {
@@ -70,7 +72,11 @@ typedef uint8_t EvTag;
 
 struct PrismMemEv
 {
-    PtrVal    begin_addr;
+    union
+    {
+        PtrVal begin_addr;
+        PtrVal count; // PRISM_MEM_*_COUNT: number of accesses
+    };
     ByteCount size;
     MemType   type;
 } __attribute__ ((__packed__));
@@ -102,6 +108,10 @@ struct PrismCxtEv
             uint32_t idx;
             uint32_t len;
         };
+        /* Function names: if 'len' is non-zero, the name is at 'idx' in
+         * the name buffer paired with this event buffer, and it takes the
+         * next name ID, counted from 0 in stream order. If 'len' is zero,
+         * 'idx' is the ID of a name already sent. */
     };
 } __attribute__ ((__packed__));
 
@@ -142,16 +152,46 @@ struct CompEvent
     const PrismCompEv &ev;
 };
 
+class CxtNames
+{
+    /* Function names of one event stream.
+     * A frontend sends each name once, and only its ID afterwards;
+     * every name is kept here so later events can still be named */
+  public:
+    CxtNames(const GetNameBase &nameBase) : nameBase(nameBase) {}
+
+    auto resolve(const PrismCxtEv &ev) -> const char*
+    {
+        if (ev.type != PRISM_CXT_FUNC_ENTER && ev.type != PRISM_CXT_FUNC_EXIT)
+            return nullptr;
+
+        if (ev.len > 0)
+        {
+            names.emplace_back(nameBase() + ev.idx);
+            return names.back().c_str();
+        }
+
+        if (ev.idx >= names.size())
+            throw std::out_of_range("context event names an unknown ID");
+        return names[ev.idx].c_str();
+    }
+
+  private:
+    const GetNameBase &nameBase;
+    std::deque<std::string> names;
+    /* a deque, so names do not move as more are added */
+};
+
 struct CxtEvent
 {
-    CxtEvent(const PrismCxtEv &ev, const GetNameBase &nameBase)
-        : ev(ev), nameBase(nameBase) {}
+    CxtEvent(const PrismCxtEv &ev, CxtNames &names)
+        : ev(ev), name(names.resolve(ev)) {}
     auto type() const -> CxtType { return ev.type; }
     auto id() const -> PtrVal { return ev.id; }
-    auto getName() const -> const char* { return ev.idx + nameBase(); }
+    auto getName() const -> const char* { return name; }
     const PrismCxtEv &ev;
   private:
-    const GetNameBase &nameBase;
+    const char *name;
 };
 
 struct SyncEvent
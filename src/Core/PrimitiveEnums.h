@@ -18,7 +18,12 @@ enum MemTypeEnum
 {
     PRISM_MEM_TYPE_UNDEF = 0,
     PRISM_MEM_LOAD,
-    PRISM_MEM_STORE
+    PRISM_MEM_STORE,
+
+    /* A run of accesses summarized by the frontend,
+     * when neither address nor size is required */
+    PRISM_MEM_LOAD_COUNT,
+    PRISM_MEM_STORE_COUNT
 };
 
 
@@ -6,6 +6,10 @@
 #include "Backends/SynchroTraceGen/EventHandlers.hpp"
 #include "Backends/SimpleCount/Handler.hpp"
 #include "Backends/SigilClassic/Handler.hpp"
+#include "Backends/MemProfile/Handler.hpp"
+#include "Backends/FalseSharing/Handler.hpp"
+#include "Backends/Heatmap/Handler.hpp"
+#include "Backends/LockProf/Handler.hpp"
 
 using namespace PrismLog;
 using namespace prism;
@@ -33,15 +37,37 @@ int main(int argc, char* argv[])
                          ::STGen::onExit,
                          ::STGen::requirements())
         .registerBackend("simplecount",
-                         []{return std::make_unique<::SimpleCount::Handler>();},
-                         {},
+                         []{return std::make_unique<::SimpleCount::Shared>();},
+                         [](BackendContext &shared){return std::make_unique<::SimpleCount::Handler>(shared);},
+                         ::SimpleCount::onParse,
                          ::SimpleCount::cleanup,
-                         ::SimpleCount::requirements())
+                         ::SimpleCount::requirements)
         .registerBackend("sigilclassic",
-                         []{return std::make_unique<::SigilClassic::Handler>();},
-                         {},
-                         {},
-                         initCaps())
+                         []{return std::make_unique<::SigilClassic::Shared>();},
+                         [](BackendContext &shared){return std::make_unique<::SigilClassic::Handler>(shared);},
+                         ::SigilClassic::onParse,
+                         ::SigilClassic::onExit,
+                         ::SigilClassic::requirements)
+        .registerBackend("memprofile",
+                         []{return std::make_unique<::MemProfile::Handler>();},
+                         ::MemProfile::onParse,
+                         ::MemProfile::onExit,
+                         ::MemProfile::requirements())
+        .registerBackend("falsesharing",
+                         []{return std::make_unique<::FalseSharing::Handler>();},
+                         ::FalseSharing::onParse,
+                         ::FalseSharing::onExit,
+                         ::FalseSharing::requirements())
+        .registerBackend("heatmap",
+                         []{return std::make_unique<::Heatmap::Handler>();},
+                         ::Heatmap::onParse,
+                         ::Heatmap::onExit,
+                         ::Heatmap::requirements())
+        .registerBackend("lockprof",
+                         []{return std::make_unique<::LockProf::Handler>();},
+                         ::LockProf::onParse,
+                         ::LockProf::onExit,
+                         ::LockProf::requirements())
         .registerBackend("null",
                          []{return std::make_unique<::BackendIface>();},
                          {},
@@ -56,42 +82,11 @@ int main(int argc, char* argv[])
 namespace
 {
 
-auto flushToBackend(BackendIface &be,
-                    const EventBuffer &buf,
-                    const GetNameBase &nameBase) -> void
-{
-    for (decltype(buf.used) i = 0; i < buf.used; ++i)
-    {
-        const PrismEvVariant &ev = buf.events[i];
-
-        switch (ev.tag)
-        {
-        case EvTagEnum::PRISM_MEM_TAG:
-            be.onMemEv({ev.mem});
-            break;
-        case EvTagEnum::PRISM_COMP_TAG:
-            be.onCompEv({ev.comp});
-            break;
-        case EvTagEnum::PRISM_SYNC_TAG:
-            be.onSyncEv({ev.sync});
-            break;
-        case EvTagEnum::PRISM_CXT_TAG:
-            be.onCxtEv({ev.cxt, nameBase});
-            break;
-        case EvTagEnum::PRISM_CF_TAG:
-            be.onCFEv(ev.cf);
-            break;
-        default:
-            fatal("Received unhandled event in " __FILE__);
-        }
-    }
-}
-
-
 auto consumeEvents(BackendIfaceGenerator createBEIface,
+                   BackendContext &context,
                    FrontendIfaceGenerator createFEIface) -> void
 {
-    BackendPtr backendIface  = createBEIface();
+    BackendPtr backendIface  = createBEIface(context);
     FrontendPtr frontendIface = createFEIface();
     /* per-thread frontend/backend interfaces
      * each backend interface needs a frontend interface to communicate with */
@@ -100,8 +95,7 @@ auto consumeEvents(BackendIfaceGenerator createBEIface,
 
     while (buf != nullptr) // consume events until there's nothing left
     {
-        flushToBackend(*backendIface, *buf,
-                       frontendIface->nameBase);
+        backendIface->onEvents(*buf, frontendIface->names);
 
         /* acquire a new buffer */
         frontendIface->releaseBuffer(std::move(buf));
@@ -122,23 +116,22 @@ auto startPrism(const Config& config) -> int
     if (threads < 1)
         fatal("Invalid number of backend threads");
 
-    if (backend.parser)
-        backend.parser(backend.args);
-    else if (backend.args.size() > 0)
-        fatal("Backend arguments provided, but Backend has no parser");
-
     info("executable : " + config.executablePrintable());
     info("frontend   : " + (config.frontendPrintable().empty() ? "default" : config.frontendPrintable()));
     info("backend    : " + config.backendPrintable());
     info("threads    : " + config.threadsPrintable());
     info("timed      : " + (timed ? std::string("on") : std::string("off")));
 
+    /* shared by every backend interface, until the backend finishes */
+    auto backendContext = backend.context();
+
     /* start frontend only once and get its interface */
     auto frontendIfaceGenerator = startFrontend();
     std::vector<std::thread> eventStreams;
     for(auto i = 0; i < threads; ++i)
         eventStreams.emplace_back(std::thread(consumeEvents,
                                               backend.generator,
+                                              std::ref(*backendContext),
                                               frontendIfaceGenerator));
 
     high_resolution_clock::time_point start, end;
@@ -149,7 +142,7 @@ auto startPrism(const Config& config) -> int
     for(auto i = 0; i < threads; ++i)
         eventStreams[i].join();
     if (backend.finish)
-        backend.finish();
+        backend.finish(*backendContext);
 
     if (timed == true)
     {
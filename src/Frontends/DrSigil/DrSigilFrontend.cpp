@@ -219,6 +219,9 @@ auto configureIpcDir() -> std::string
 auto startDrSigil(Args execArgs, Args feArgs, unsigned threads, prism::capabilities reqs)
     -> FrontendIfaceGenerator
 {
+    /* MAX_IPC_CHANNELS in the DynamoRIO client */
+    if (threads > 256)
+        fatal("DynamoRIO frontend attempted with more than 256 threads");
     auto ipcDir = configureIpcDir();
     Cleanup::setCleanupDir(ipcDir);
 
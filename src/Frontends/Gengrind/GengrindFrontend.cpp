@@ -31,7 +31,7 @@ auto gengrindCapabilities() -> prism::capabilities
 
     caps[CONTEXT_INSTRUCTION] = availability::enabled;
     caps[CONTEXT_BASIC_BLOCK] = availability::disabled;
-    caps[CONTEXT_FUNCTION]    = availability::disabled;
+    caps[CONTEXT_FUNCTION]    = availability::enabled;
     caps[CONTEXT_THREAD]      = availability::enabled;
 
     return caps;
@@ -163,14 +163,21 @@ auto vgOpts(const std::vector<std::string> &userExec,
 
     opts += " --ipc-dir=" + ipcDir;
 
-    /* MDL20170720
-     * TODO the Valgrind frontend only has macro granularity support */
     reqs[MEMORY] == availability::enabled ?
         opts += " --gen-mem=yes" :
         opts += " --gen-mem=no";
+    reqs[MEMORY_ADDRESS] == availability::enabled ?
+        opts += " --gen-mem-addr=yes" :
+        opts += " --gen-mem-addr=no";
+    reqs[MEMORY_SIZE] == availability::enabled ?
+        opts += " --gen-mem-size=yes" :
+        opts += " --gen-mem-size=no";
     reqs[COMPUTE] == availability::enabled ?
         opts += " --gen-comp=yes" :
         opts += " --gen-comp=no";
+    reqs[COMPUTE_ARITY] == availability::enabled ?
+        opts += " --gen-comp-arity=yes" :
+        opts += " --gen-comp-arity=no";
     reqs[SYNC] == availability::enabled ?
         opts += " --gen-sync=yes" :
         opts += " --gen-sync=no";
@@ -228,10 +228,6 @@ static void pushCallStack(BBInfo *from, UInt jmp,
         GN_(updateEventGeneration)();
     }
 
-    if (to_fn->skip == False) {
-        GN_(flush_FnEnter)(to_fn->name);
-    }
-
     currentCallStack.tos++;
 
     if ((Long)currentCallStack.tos >= currentCallStack.capacity)
@@ -257,8 +253,6 @@ static void popCallStack(void)
             GN_(afterEndFunc) = True;
             GN_(updateEventGeneration)();
         }
-
-        GN_(flush_FnExit)(to_fn->name);
     }
 
     currentCallStack.tos--;
@@ -911,18 +911,6 @@ void GN_(flush_Sync)(SyncType type, SyncID *data, UInt args)
 }
 
 
-void GN_(flush_FnEnter)(const HChar *fnname)
-{
-    GN_DEBUG(6, "Fn Enter: %s\n", fnname);
-}
-
-
-void GN_(flush_FnExit)(const HChar *fnname)
-{
-    GN_DEBUG(6, "Fn Exit : %s\n", fnname);
-}
-
-
 void GN_(updateEventGeneration)(void)
 {
     if (GN_(afterStartFunc) == True &&
@@ -78,8 +78,6 @@ void GN_(add_TrackSyncs)(BBState *bbState);
 void GN_(flush_Sync)(SyncType type, SyncID *data, UInt args);
 
 void GN_(add_TrackFns)(BBState *bbState);
-void GN_(flush_FnExit)(const HChar *fnname);
-void GN_(flush_FnEnter)(const HChar *fnname);
 
 void GN_(addEvent_Instr)(BBState *bbState, const IRStmt *st);
 void GN_(addEvent_Compute)(BBState *bbState, const IRStmt *st);
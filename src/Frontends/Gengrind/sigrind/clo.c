@@ -416,7 +416,10 @@ Bool CLG_(process_cmd_line_option)(const HChar* arg)
    else if VG_STR_CLO(arg,  "--start-func", SGL_(clo).start_collect_func) {}
    else if VG_STR_CLO(arg,  "--stop-func",  SGL_(clo).stop_collect_func) {}
    else if VG_BOOL_CLO(arg, "--gen-mem",    SGL_(clo).gen_mem) {}
+   else if VG_BOOL_CLO(arg, "--gen-mem-addr", SGL_(clo).gen_mem_addr) {}
+   else if VG_BOOL_CLO(arg, "--gen-mem-size", SGL_(clo).gen_mem_size) {}
    else if VG_BOOL_CLO(arg, "--gen-comp",   SGL_(clo).gen_comp) {}
+   else if VG_BOOL_CLO(arg, "--gen-comp-arity", SGL_(clo).gen_comp_arity) {}
    else if VG_BOOL_CLO(arg, "--gen-sync",   SGL_(clo).gen_sync) {}
    else if VG_BOOL_CLO(arg, "--gen-instr",  SGL_(clo).gen_instr) {}
    else if VG_BOOL_CLO(arg, "--gen-fn",     SGL_(clo).gen_fn) {}
@@ -632,7 +635,10 @@ void SGL_(set_clo_defaults)(void)
   SGL_(clo).start_collect_func = NULL;
   SGL_(clo).stop_collect_func  = NULL;
   SGL_(clo).gen_mem            = False;
+  SGL_(clo).gen_mem_addr       = True;
+  SGL_(clo).gen_mem_size       = True;
   SGL_(clo).gen_comp           = False;
+  SGL_(clo).gen_comp_arity     = True;
   SGL_(clo).gen_cf             = False;
   SGL_(clo).gen_sync           = False;
   SGL_(clo).gen_instr          = False;
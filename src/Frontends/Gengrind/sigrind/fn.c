@@ -347,6 +347,7 @@ fn_node* new_fn_node(const HChar *fnname,
 
     CLG_(stat).distinct_fns++;
     fn->number   = CLG_(stat).distinct_fns;
+    fn->name_id  = -1;
     fn->last_cxt = 0;
     fn->pure_cxt = 0;
     fn->file     = file;
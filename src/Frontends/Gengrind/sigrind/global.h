@@ -80,7 +80,10 @@ struct _SglCommandLineOptions {
   const HChar* start_collect_func;
   const HChar* stop_collect_func;
   Bool gen_mem;
+  Bool gen_mem_addr;
+  Bool gen_mem_size;
   Bool gen_comp;
+  Bool gen_comp_arity;
   Bool gen_cf;
   Bool gen_sync;
   Bool gen_instr;
@@ -409,6 +412,7 @@ struct _BBCC {
 struct _fn_node {
   HChar*     name;
   UInt       number;
+  Int        name_id;  /* ID the name was sent to Prism with, -1 if not yet */
   Context*   last_cxt; /* LRU info */
   Context*   pure_cxt; /* the context with only the function itself */
   file_node* file;     /* reverse mapping for 2nd hash */
@@ -98,6 +98,33 @@ void SGL_(log_0I1Dw)(InstrInfo* ii, Addr data_addr, Word data_size)
 }
 
 
+void SGL_(log_mem_count)(UWord loads, UWord stores)
+{
+    if (EVENT_GENERATION_ENABLED)
+    {
+#ifdef COUNT_EVENT_CHECK
+        mem_events += loads + stores;
+#endif
+
+        PrismEvVariant* slot;
+        if (loads > 0)
+        {
+            slot            = SGL_(acq_event_slot)();
+            slot->tag       = PRISM_MEM_TAG;
+            slot->mem.type  = PRISM_MEM_LOAD_COUNT;
+            slot->mem.count = loads;
+        }
+        if (stores > 0)
+        {
+            slot            = SGL_(acq_event_slot)();
+            slot->tag       = PRISM_MEM_TAG;
+            slot->mem.type  = PRISM_MEM_STORE_COUNT;
+            slot->mem.count = stores;
+        }
+    }
+}
+
+
 void SGL_(log_comp_event)(InstrInfo* ii, IRType op_type, IRExprTag arity)
 {
     /* SIMD and decimal floating point are unsupported
@@ -119,6 +146,12 @@ void SGL_(log_comp_event)(InstrInfo* ii, IRType op_type, IRExprTag arity)
         else
             slot->comp.type = PRISM_COMP_FLOP;
 
+        if (SGL_(clo).gen_comp_arity == False)
+        {
+            slot->comp.arity = PRISM_COMP_ARITY_UNDEF;
+            return;
+        }
+
         switch (arity)
         {
         case Iex_Unop:
@@ -158,6 +191,11 @@ void SGL_(log_sync)(UChar type, UWord data1, UWord data2)
 }
 
 
+static Int next_name_id = 0;
+/* Function names are sent once, with the first event for that function,
+ * and are numbered from 0 in that order; later events only carry the number.
+ * Prism reads the events in order, so it numbers the names the same way */
+
 static inline void log_fn(Int type, fn_node* fn)
 {
     if (EVENT_GENERATION_ENABLED && SGL_(clo).gen_fn == True)
@@ -166,16 +204,31 @@ static inline void log_fn(Int type, fn_node* fn)
         cxt_events++;
 #endif
 
-        /* request both slots simultaneously to allow proper flushing */
-        /* TODO set max size for name length? */
-        Int len = VG_(strlen)(fn->name) + 1;
+        if (fn->name_id >= 0)
+        {
+            PrismEvVariant* slot = SGL_(acq_event_slot)();
+            slot->tag      = PRISM_CXT_TAG;
+            slot->cxt.type = type;
+            slot->cxt.len  = 0;
+            slot->cxt.idx  = fn->name_id;
+            return;
+        }
+
+        /* request both slots simultaneously to allow proper flushing;
+         * names longer than a whole name buffer are truncated */
+        UInt len = VG_(strlen)(fn->name) + 1;
+        if (len > PRISM_NAMES_BUFFER_SIZE)
+            len = PRISM_NAMES_BUFFER_SIZE;
         EventNameSlotTuple tuple = SGL_(acq_event_name_slot)(len);
 
-        VG_(strncpy)(tuple.name_slot, fn->name, len);
+        VG_(strncpy)(tuple.name_slot, fn->name, len - 1);
+        tuple.name_slot[len - 1]   = '\0';
         tuple.event_slot->tag      = PRISM_CXT_TAG;
         tuple.event_slot->cxt.type = type;
         tuple.event_slot->cxt.len  = len;
         tuple.event_slot->cxt.idx  = tuple.name_idx;
+
+        fn->name_id = next_name_id++;
     }
 }
 void SGL_(log_fn_entry)(fn_node* fn)
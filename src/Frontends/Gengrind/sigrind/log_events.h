@@ -35,6 +35,9 @@ void SGL_(log_1I1Dw)(InstrInfo* ii, Addr data_addr, Word data_size);
 /* 1 Data Write */
 void SGL_(log_0I1Dw)(InstrInfo* ii, Addr data_addr, Word data_size);
 
+/* Data reads and writes, without address or size */
+void SGL_(log_mem_count)(UWord loads, UWord stores);
+
 /* 1 Compute event */
 void SGL_(log_comp_event)(InstrInfo* ii, IRType op_type, IRExprTag arity);
 
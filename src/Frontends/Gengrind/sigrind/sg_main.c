@@ -160,6 +160,18 @@ typedef struct {
 
     /* The output SB being constructed. */
     IRSB* sbOut;
+
+    /* Memory accesses counted, instead of queued, when neither their
+       address nor their size is generated.  Each count is sent once
+       per flush, i.e. at least once per exit from the SB. */
+    UInt loads_counted;
+    UInt stores_counted;
+
+    /* The last counted read, and events_used when it was counted,
+       so that a following write can be merged into a modify exactly
+       as queued events are; -1 if there is none. */
+    Event counted_read;
+    Int   counted_read_at;
 } ClgState;
 
 /*------------------------------------------------------------*/
@@ -183,6 +195,8 @@ exec_state CLG_(current_state);
 /*------------------------------------------------------------*/
 
 static void flushEvents ( ClgState* clgs );
+static void flushCountedEvents ( ClgState* clgs );
+static Bool countMemEvents ( void );
 static void addEvent_Comp( ClgState* clgs, InstrInfo* inode, IRExprTag arity, IRType op_type );
 static void addEvent_G ( ClgState* clgs, InstrInfo* inode );
 static void addEvent_Bi ( ClgState* clgs, InstrInfo* inode, IRAtom* whereTo );
@@ -299,6 +313,9 @@ static IRSB* CLG_(instrument)( VgCallbackClosure* closure,
 
    // Set up running state
    clgs.events_used = 0;
+   clgs.loads_counted = 0;
+   clgs.stores_counted = 0;
+   clgs.counted_read_at = -1;
    clgs.ii_index = 0;
    clgs.instr_offset = 0;
 
@@ -887,6 +904,35 @@ static void flushEvents ( ClgState* clgs )
 	}
 
 	clgs->events_used = 0;
+	flushCountedEvents( clgs );
+}
+
+/* Memory events without an address or a size carry nothing but their
+   type, so they are counted at instrumentation time and sent as one
+   event per type, instead of one helper call and event per access. */
+static Bool countMemEvents ( void )
+{
+   return SGL_(clo).gen_mem_addr == False && SGL_(clo).gen_mem_size == False;
+}
+
+static void flushCountedEvents ( ClgState* clgs )
+{
+   IRExpr** argv;
+   IRDirty* di;
+
+   clgs->counted_read_at = -1;
+   if (clgs->loads_counted == 0 && clgs->stores_counted == 0)
+      return;
+
+   argv = mkIRExprVec_2( mkIRExpr_HWord( clgs->loads_counted ),
+                         mkIRExpr_HWord( clgs->stores_counted ) );
+   di = unsafeIRDirty_0_N( 2, "log_mem_count",
+                           VG_(fnptr_to_fnentry)( SGL_(log_mem_count) ),
+                           argv );
+   addStmtToIRSB( clgs->sbOut, IRStmt_Dirty(di) );
+
+   clgs->loads_counted = 0;
+   clgs->stores_counted = 0;
 }
 
 static void addEvent_Ir ( ClgState* clgs, InstrInfo* inode )
@@ -910,6 +956,19 @@ void addEvent_Dr ( ClgState* clgs, InstrInfo* inode, Int datasize, IRAtom* ea )
    Event* evt;
    tl_assert(isIRAtom(ea));
    tl_assert(datasize >= 1);
+
+   if (countMemEvents())
+   {
+      evt = &clgs->counted_read;
+      init_Event(evt);
+      evt->tag       = Ev_Dr;
+      evt->inode     = inode;
+      evt->Ev.Dr.szB = datasize;
+      evt->Ev.Dr.ea  = ea;
+      clgs->counted_read_at = clgs->events_used;
+      clgs->loads_counted++;
+      return;
+   }
    
    if (clgs->events_used == N_EVENTS)
       flushEvents(clgs);
@@ -930,6 +989,20 @@ void addEvent_Dw ( ClgState* clgs, InstrInfo* inode, Int datasize, IRAtom* ea )
    Event* evt;
    tl_assert(isIRAtom(ea));
    tl_assert(datasize >= 1);
+
+   if (countMemEvents())
+   {
+      /* Dm events have the same effect as Dw events */
+      lastEvt = &clgs->counted_read;
+      if (clgs->counted_read_at == clgs->events_used
+          && lastEvt->Ev.Dr.szB == datasize
+          && lastEvt->inode     == inode
+          && eqIRAtom(lastEvt->Ev.Dr.ea, ea))
+         clgs->loads_counted--;
+      clgs->counted_read_at = -1;
+      clgs->stores_counted++;
+      return;
+   }
   
    /* Is it possible to merge this write with the preceding read? */
    lastEvt = &clgs->events[clgs->events_used-1];
@@ -92,7 +92,7 @@ static inline Bool is_events_full(void)
 
 static inline Bool is_names_full(UInt size)
 {
-    return (curr_name_buf->used + size) > PRISM_EVENTS_BUFFER_SIZE;
+    return (curr_name_buf->used + size) > PRISM_NAMES_BUFFER_SIZE;
 }
 
 
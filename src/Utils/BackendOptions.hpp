@@ -0,0 +1,73 @@
+#ifndef PRISM_BACKEND_OPTIONS_H
+#define PRISM_BACKEND_OPTIONS_H
+
+#include "Utils/PrismLog.hpp"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/* Convenience functions for parsing a backend's short options */
+
+namespace prism
+{
+
+inline auto parseShortOptions(const std::vector<std::string> &args,
+                              const std::set<char> &options,
+                              const std::string &backend) -> std::map<char, std::string>
+{
+    /* '-<char> value' or '-<char>value'
+     *
+     * Any argument that is not one of 'options' is fatal;
+     * 'backend' names the backend in the error */
+    std::map<char, std::string> matches;
+    for (auto arg = args.cbegin(); arg != args.cend(); ++arg)
+    {
+        if ((*arg).length() < 2 || (*arg)[0] != '-' ||
+            options.find((*arg)[1]) == options.cend())
+            PrismLog::fatal("unexpected " + backend + " option: " + *arg);
+
+        char opt = (*arg)[1];
+        if ((*arg).length() > 2)
+            matches[opt] = (*arg).substr(2, std::string::npos);
+        else if (arg + 1 != args.cend())
+            matches[opt] = *(++arg);
+    }
+    return matches;
+}
+
+
+inline auto parsePositive(const std::string &number, long long defaultValue,
+                          const std::string &what) -> long long
+{
+    /* 'defaultValue' if the option was not given,
+     * otherwise a number of at least 1 or a fatal error about 'what' */
+    if (number.empty() == true)
+        return defaultValue;
+
+    long long ret = 0;
+    try
+    {
+        ret = std::stoll(number);
+    }
+    catch (std::exception &e)
+    {
+        PrismLog::fatal(what + ": invalid argument");
+    }
+    if (ret < 1)
+        PrismLog::fatal(what + ": invalid argument");
+    return ret;
+}
+
+
+inline auto parseOutputPath(const std::string &outputPath) -> std::string
+{
+    if (outputPath.empty() == true)
+        return "."; //default
+    else
+        return outputPath;
+}
+
+}; //end namespace prism
+
+#endif